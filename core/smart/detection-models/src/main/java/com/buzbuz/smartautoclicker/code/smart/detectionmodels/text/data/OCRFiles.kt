@@ -27,12 +27,14 @@ internal const val OCR_MODELS_DATA_DIR = "models/text"
 internal const val OCR_DETECTION_MODEL_DIR = "detect"
 internal const val OCR_DETECTION_MODEL_FILE = "det.ncnn.bin"
 internal const val OCR_DETECTION_MODEL_PARAMS_FILE = "det.ncnn.param"
+internal const val OCR_DETECTION_MODEL_BUNDLE_FILE = "det.ncnn.bundle"
 
 internal const val ASSET_PACK_RECOGNITION_MODEL_PREFIX = "text_model_rec_"
 internal const val OCR_RECOGNITION_MODEL_DIR = "recognize"
 internal const val OCR_RECOGNITION_MODEL_FILE = "rec.ncnn.bin"
 internal const val OCR_RECOGNITION_MODEL_PARAMS_FILE = "rec.ncnn.param"
 internal const val OCR_RECOGNITION_MODEL_DICTIONARY_FILE = "dict.txt"
+internal const val OCR_RECOGNITION_MODEL_BUNDLE_FILE = "rec.ncnn.bundle"
 
 
 internal fun Context.detectionModelDataDir(): File =
@@ -73,6 +73,7 @@ internal class OCRModelLocalDataSource @Inject constructor(
         detectionModelDataDir
 
     fun isDetectionModelAvailable(): Boolean {
+        if (File(detectionModelDataDir, OCR_DETECTION_MODEL_BUNDLE_FILE).exists()) return true
         return File(detectionModelDataDir, OCR_DETECTION_MODEL_FILE).exists() &&
                 File(detectionModelDataDir, OCR_DETECTION_MODEL_PARAMS_FILE).exists()
     }
@@ -82,6 +83,7 @@ internal class OCRModelLocalDataSource @Inject constructor(
 
     fun isRecognitionModelAvailable(alphabet: OCRAlphabet): Boolean {
         val alphabetDir = getRecognitionModelDir(alphabet)
+        if (File(alphabetDir, OCR_RECOGNITION_MODEL_BUNDLE_FILE).exists()) return true
         return File(alphabetDir, OCR_RECOGNITION_MODEL_FILE).exists() &&
                 File(alphabetDir, OCR_RECOGNITION_MODEL_PARAMS_FILE).exists() &&
                 File(alphabetDir, OCR_RECOGNITION_MODEL_DICTIONARY_FILE).exists()
@@ -18,15 +18,21 @@ package com.buzbuz.smartautoclicker.core.detection
 
 import android.content.Context
 import android.graphics.Bitmap
+import android.graphics.Rect
+import android.graphics.Typeface
 import androidx.test.ext.junit.runners.AndroidJUnit4
 import androidx.test.filters.LargeTest
 import androidx.test.platform.app.InstrumentationRegistry
 import com.buzbuz.smartautoclicker.core.detection.data.NumberTestCase
 import com.buzbuz.smartautoclicker.core.detection.data.TestImage
+import com.buzbuz.smartautoclicker.core.detection.utils.awaitTextDetectionModelReady
 import com.buzbuz.smartautoclicker.core.detection.utils.extractTestOcrModels
 import com.buzbuz.smartautoclicker.core.detection.utils.loadTestBitmap
+import com.buzbuz.smartautoclicker.core.detection.utils.renderCounterScreen
+import com.buzbuz.smartautoclicker.core.detection.utils.renderNumberScreen
 import org.junit.After
 import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
 import org.junit.Assert.assertNotNull
 import org.junit.Assert.assertTrue
 import org.junit.Before
@@ -52,6 +58,9 @@ class NumberMatcherTests {
         val (detectModelPath, recognitionModels) = context.extractTestOcrModels()
         val modelsLoaded = testedDetector.loadTextDetectionModels(detectModelPath, recognitionModels)
         assertTrue("OCR models failed to load", modelsLoaded)
+        recognitionModels.keys.forEach { modelId ->
+            assertTrue("OCR model $modelId is not ready", testedDetector.awaitTextDetectionModelReady(modelId))
+        }
 
         screenBitmap = context.loadTestBitmap(TestImage.NumberConditionsScreen)
         testedDetector.setScreenBitmap(screenBitmap, "")
@@ -97,11 +106,182 @@ class NumberMatcherTests {
         assertNumberDetected(TestImage.NumberConditionsScreen.numberTestCases[6])
     }
 
-    private fun assertNumberDetected(testCase: NumberTestCase) {
+    @Test
+    fun detection_Number_42_LowContrast() {
+        val lowContrastScreen = renderNumberScreen(
+            textColor = LOW_CONTRAST_TEXT_COLOR,
+            backgroundColor = LOW_CONTRAST_BACKGROUND_COLOR,
+        )
+        testedDetector.setScreenBitmap(lowContrastScreen, "")
+
+        assertNumberDetected(TestImage.NumberConditionsScreen.numberTestCases[0])
+        assertEquals(
+            "Low contrast text rejected by the text presence filter",
+            0L,
+            testedDetector.getMetrics().textPrefilterRejections,
+        )
+    }
+
+    @Test
+    fun glyphs_repeatedFrames_readWithoutRecognition() {
+        learnCounterGlyphs()
+        val glyphReads = testedDetector.getMetrics().glyphTemplateReads
+
+        repeat(GLYPH_TEST_FRAME_COUNT) {
+            assertCounterDetected(COUNTER_ALL_DIGITS)
+        }
+
+        assertEquals(
+            "Repeated frames of a learned counter should be read with the glyphs",
+            glyphReads + GLYPH_TEST_FRAME_COUNT,
+            testedDetector.getMetrics().glyphTemplateReads,
+        )
+    }
+
+    @Test
+    fun glyphs_digitChange_newValueRead() {
+        learnCounterGlyphs()
+        val glyphReads = testedDetector.getMetrics().glyphTemplateReads
+
+        assertCounterDetected(COUNTER_CHANGED_DIGITS)
+
+        assertEquals(
+            "Changed counter should be read with the glyphs",
+            glyphReads + 1,
+            testedDetector.getMetrics().glyphTemplateReads,
+        )
+    }
+
+    @Test
+    fun glyphs_fontChange_fallbackToRecognition() {
+        learnCounterGlyphs()
+        val glyphReads = testedDetector.getMetrics().glyphTemplateReads
+
+        assertCounterDetected(COUNTER_ALL_DIGITS, Typeface.create(Typeface.SERIF, Typeface.BOLD_ITALIC))
+
+        assertEquals(
+            "Counter drawn with another font should be read with the recognition network",
+            glyphReads,
+            testedDetector.getMetrics().glyphTemplateReads,
+        )
+    }
+
+    @Test
+    fun glyphs_scoreBelowPerfectMatch() {
+        learnCounterGlyphs()
+
+        val result = assertCounterDetected(COUNTER_ALL_DIGITS)
+
+        assertTrue("Glyph score should be weighted by the frame correlation", result.confidenceRate < 100.0)
+        assertFalse(
+            "Glyph read should be rejected by a threshold above its score",
+            testedDetector.detectNumber(
+                detectionArea = counterArea,
+                threshold = result.confidenceRate.toInt() + 1,
+                numberFormatType = NumberFormatType.AUTO,
+            ).isDetected,
+        )
+    }
+
+    @Test
+    fun frameBudget_costAboveBudget_lastResultServed() {
+        val testCase = TestImage.NumberConditionsScreen.numberTestCases[0]
+        testedDetector.setFrameBudget(MIN_FRAME_BUDGET_MS)
+        assertNumberDetected(testCase)
+
+        repeat(MAX_DEFERRED_FRAMES) { frame ->
+            testedDetector.setScreenBitmap(screenBitmap, "")
+            val result = assertNumberDetected(testCase)
+            assertTrue("Number should be served from its last result on frame $frame", result.isStale)
+        }
+
+        testedDetector.setScreenBitmap(screenBitmap, "")
+        assertFalse(
+            "Number should be detected once deferred for $MAX_DEFERRED_FRAMES frames",
+            assertNumberDetected(testCase).isStale,
+        )
+    }
+
+    @Test
+    fun frameBudget_costKnownWithoutLastResult_detected() {
+        val testCase = TestImage.NumberConditionsScreen.numberTestCases[0]
+        testedDetector.setFrameBudget(MIN_FRAME_BUDGET_MS)
+        assertNumberDetected(testCase)
+
+        // Disabling the budget forgets the last results, but not the learned costs
+        testedDetector.setFrameBudget(0)
+        testedDetector.setFrameBudget(MIN_FRAME_BUDGET_MS)
+        testedDetector.setScreenBitmap(screenBitmap, "")
+
+        assertFalse(
+            "Number without a last result should always be detected",
+            assertNumberDetected(testCase).isStale,
+        )
+    }
+
+    @Test
+    fun refreshScheduling_lastResultServedUntilPeriodElapsed() {
+        val testCase = TestImage.NumberConditionsScreen.numberTestCases[0]
+        testedDetector.setRefreshScheduling(true)
+        assertNumberDetected(testCase, REFRESH_PERIOD_MS)
+
+        Thread.sleep(REFRESH_PERIOD_MS / 4)
+        testedDetector.setScreenBitmap(screenBitmap, "")
+        val staleResult = assertNumberDetected(testCase, REFRESH_PERIOD_MS)
+        assertTrue("Number should be served from its last result", staleResult.isStale)
+        assertTrue(
+            "Wrong stale result age ${staleResult.resultAgeMs}",
+            staleResult.resultAgeMs in (REFRESH_PERIOD_MS / 4) until REFRESH_PERIOD_MS,
+        )
+
+        Thread.sleep(REFRESH_PERIOD_MS)
+        testedDetector.setScreenBitmap(screenBitmap, "")
+        val refreshedResult = assertNumberDetected(testCase, REFRESH_PERIOD_MS)
+        assertFalse("Number should be detected once its period elapsed", refreshedResult.isStale)
+        assertEquals("Refreshed result should have no age", 0L, refreshedResult.resultAgeMs)
+    }
+
+    /** Detects the counter with the recognition network until all of its digits glyphs are learned. */
+    private fun learnCounterGlyphs() {
+        val glyphReads = testedDetector.getMetrics().glyphTemplateReads
+        repeat(GLYPH_TEST_FRAME_COUNT) {
+            assertCounterDetected(COUNTER_ALL_DIGITS)
+        }
+        assertTrue(
+            "Counter glyphs have not been learned",
+            testedDetector.getMetrics().glyphTemplateReads > glyphReads,
+        )
+    }
+
+    private val counterArea: Rect
+        get() = Rect(0, 0, COUNTER_SCREEN_WIDTH, screenBitmap.height)
+
+    private fun assertCounterDetected(counter: String, typeface: Typeface = Typeface.MONOSPACE): DetectionResult {
+        screenBitmap = renderCounterScreen(counter, COUNTER_SCREEN_WIDTH, typeface)
+        testedDetector.setScreenBitmap(screenBitmap, "")
+
+        val result = testedDetector.detectNumber(
+            detectionArea = counterArea,
+            threshold = 0,
+            numberFormatType = NumberFormatType.AUTO,
+        )
+
+        assertTrue("Counter $counter not detected", result.isDetected)
+        assertEquals(
+            "Wrong value detected for counter $counter",
+            counter.toDouble(),
+            result.numberDetected!!,
+            DETECTION_NUMBER_DELTA,
+        )
+        return result
+    }
+
+    private fun assertNumberDetected(testCase: NumberTestCase, refreshPeriodMs: Long = 0): DetectionResult {
         val result = testedDetector.detectNumber(
             detectionArea = testCase.detectionArea,
             threshold = 0,
             numberFormatType = testCase.numberFormatType,
+            refreshPeriodMs = refreshPeriodMs,
         )
 
         assertTrue("Number not detected in area ${testCase.detectionArea}", result.isDetected)
@@ -112,9 +292,23 @@ class NumberMatcherTests {
             result.numberDetected!!,
             DETECTION_NUMBER_DELTA,
         )
+        return result
     }
 
     private companion object {
         const val DETECTION_NUMBER_DELTA = 0.001
+        /** Counters containing all digits, the glyphs reader needs all of them to be learned. */
+        const val COUNTER_ALL_DIGITS = "1234567890"
+        const val COUNTER_CHANGED_DIGITS = "9081726354"
+        const val COUNTER_SCREEN_WIDTH = 400
+        const val GLYPH_TEST_FRAME_COUNT = 3
+        /** A frame budget always exceeded by a number detection. */
+        const val MIN_FRAME_BUDGET_MS = 1L
+        /** Maximum number of consecutive frames a detection is deferred by the frame budget. */
+        const val MAX_DEFERRED_FRAMES = 5
+        const val REFRESH_PERIOD_MS = 1_000L
+        /** Gray text on a slightly lighter gray, with strokes contrast below the previous edge threshold. */
+        const val LOW_CONTRAST_TEXT_COLOR = 0xFF6E6E6E.toInt()
+        const val LOW_CONTRAST_BACKGROUND_COLOR = 0xFF848484.toInt()
     }
 }
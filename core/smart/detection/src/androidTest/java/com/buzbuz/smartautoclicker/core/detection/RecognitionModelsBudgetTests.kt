@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+import android.content.Context
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import androidx.test.platform.app.InstrumentationRegistry
+import com.buzbuz.smartautoclicker.core.detection.utils.awaitTextDetectionModelReady
+import com.buzbuz.smartautoclicker.core.detection.utils.extractTestOcrModels
+import org.junit.After
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+
+/**
+ * Tests of the recognition models memory budget: the least recently used models are unloaded when it is exceeded, and
+ * loaded again in background on their next use.
+ *
+ * The same test model is registered under several identifiers, each one being loaded as a separate model of the same
+ * size.
+ */
+@LargeTest
+@RunWith(AndroidJUnit4::class)
+class RecognitionModelsBudgetTests {
+
+    private lateinit var context: Context
+    private lateinit var testedDetector: ImageDetector
+
+    private lateinit var detectionModelPath: String
+    private lateinit var recognitionModels: Map<String, String>
+    /** Memory of a single loaded test recognition model, as estimated by the detector. */
+    private var modelSize: Long = 0
+    /** A budget fitting two loaded models, but not a third one. */
+    private val twoModelsBudget: Long
+        get() = modelSize * 5 / 2
+
+    @Before
+    fun setUp() {
+        context = InstrumentationRegistry.getInstrumentation().targetContext
+        testedDetector = NativeDetector.newInstance()
+            ?: throw IllegalStateException("Can't instantiate detector for tests")
+        testedDetector.init()
+
+        val (detectModelPath, testModels) = context.extractTestOcrModels()
+        val modelPath = testModels.values.first()
+        detectionModelPath = detectModelPath
+        recognitionModels = mapOf(MODEL_A to modelPath, MODEL_B to modelPath, MODEL_C to modelPath)
+        modelSize = File(modelPath, "rec.ncnn.bin").length()
+    }
+
+    @After
+    fun tearDown() {
+        testedDetector.close()
+    }
+
+    @Test
+    fun loadModels_missingRecognitionModel() {
+        val models = recognitionModels + ("missing" to File(context.cacheDir, "missing_model").absolutePath)
+
+        assertFalse(
+            "Models loading should fail with a missing recognition model",
+            testedDetector.loadTextDetectionModels(detectionModelPath, models),
+        )
+    }
+
+    @Test
+    fun loadModels_missingDetectionModel() {
+        assertFalse(
+            "Models loading should fail with a missing detection model",
+            testedDetector.loadTextDetectionModels(File(context.cacheDir, "missing_model").absolutePath, recognitionModels),
+        )
+    }
+
+    @Test
+    fun noBudget_allModelsKept() {
+        loadModels()
+        awaitReady(MODEL_A, MODEL_B, MODEL_C)
+
+        assertReady(MODEL_A, MODEL_B, MODEL_C)
+    }
+
+    @Test
+    fun budgetExceeded_leastRecentlyUsedUnloaded() {
+        testedDetector.setRecognitionMemoryBudget(twoModelsBudget)
+        loadModels()
+        awaitReady(MODEL_A, MODEL_B)
+
+        // Loading C exceeds the budget, A is the least recently loaded
+        awaitReady(MODEL_C)
+
+        assertReady(MODEL_B, MODEL_C)
+        assertNotReady(MODEL_A)
+    }
+
+    @Test
+    fun budgetExceeded_unloadedModelReloaded() {
+        testedDetector.setRecognitionMemoryBudget(twoModelsBudget)
+        loadModels()
+        awaitReady(MODEL_A, MODEL_B, MODEL_C)
+
+        // A has been unloaded by C, its next use loads it again and unloads B, now the least recently used
+        awaitReady(MODEL_A)
+
+        assertReady(MODEL_C, MODEL_A)
+        assertNotReady(MODEL_B)
+    }
+
+    @Test
+    fun budgetLowered_modelsUnloaded() {
+        loadModels()
+        awaitReady(MODEL_A, MODEL_B, MODEL_C)
+
+        testedDetector.setRecognitionMemoryBudget(modelSize)
+
+        assertReady(MODEL_C)
+        assertNotReady(MODEL_A)
+    }
+
+    private fun loadModels() {
+        assertTrue(
+            "OCR models failed to load",
+            testedDetector.loadTextDetectionModels(detectionModelPath, recognitionModels),
+        )
+    }
+
+    private fun awaitReady(vararg modelIds: String) {
+        modelIds.forEach { modelId ->
+            assertTrue("OCR model $modelId is not ready", testedDetector.awaitTextDetectionModelReady(modelId))
+        }
+    }
+
+    /** Checks the models are loaded. Must be called before any of them is reported as not ready, as this reloads it. */
+    private fun assertReady(vararg modelIds: String) {
+        modelIds.forEach { modelId ->
+            assertTrue("OCR model $modelId should be loaded", testedDetector.isTextDetectionModelReady(modelId))
+        }
+    }
+
+    private fun assertNotReady(vararg modelIds: String) {
+        modelIds.forEach { modelId ->
+            assertFalse("OCR model $modelId should be unloaded", testedDetector.isTextDetectionModelReady(modelId))
+        }
+    }
+
+    private companion object {
+        const val MODEL_A = "latin_a"
+        const val MODEL_B = "latin_b"
+        const val MODEL_C = "latin_c"
+    }
+}
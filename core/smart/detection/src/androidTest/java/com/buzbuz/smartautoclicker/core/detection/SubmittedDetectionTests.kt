@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+import android.graphics.Bitmap
+import android.graphics.Color
+import android.graphics.Rect
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.buzbuz.smartautoclicker.core.detection.utils.TEST_DETECTION_THRESHOLD_STANDARD
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertThrows
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/** Tests the detections submitted to the native worker with [ImageDetector.submitDetection]. */
+@LargeTest
+@RunWith(AndroidJUnit4::class)
+class SubmittedDetectionTests {
+
+    private lateinit var testedDetector: ImageDetector
+    private lateinit var screenBitmap: Bitmap
+
+    @Before
+    fun setUp() {
+        testedDetector = NativeDetector.newInstance()
+            ?: throw IllegalStateException("Can't instantiate detector for tests")
+        testedDetector.init()
+
+        screenBitmap = Bitmap.createBitmap(SCREEN_WIDTH, SCREEN_HEIGHT, Bitmap.Config.ARGB_8888)
+            .apply { eraseColor(Color.RED) }
+    }
+
+    @After
+    fun tearDown() {
+        testedDetector.close()
+    }
+
+    @Test
+    fun completions_submissionOrder() {
+        val tickets = List(SUBMISSION_COUNT) { submit() }
+
+        val completions = awaitCompletions(tickets.size)
+
+        assertEquals("Completions are not in the submission order", tickets, completions.map { it.ticket })
+        completions.filterNot { it.isDropped }.forEach { completion ->
+            assertEquals("Wrong results count for ${completion.ticket}", 1, completion.results.size)
+        }
+        assertFalse("The last submitted detection can't be dropped", completions.last().isDropped)
+    }
+
+    @Test
+    fun completionsQueueFull_oldestPendingDropped() {
+        // Fill the completions queue, then the worker stalls with the next detection until a completion is retrieved
+        val processedTickets = List(COMPLETIONS_CAPACITY + 1) { submitAndWaitForProcessing() }
+        // Two detections are waiting for the worker, each new one drops the oldest waiting one
+        val droppedTickets = List(2) { submit() }
+        val pendingTickets = List(2) { submit() }
+
+        val completions = awaitCompletions(processedTickets.size + droppedTickets.size + pendingTickets.size)
+
+        assertEquals(
+            "Completions are not in the submission order",
+            processedTickets + droppedTickets + pendingTickets,
+            completions.map { it.ticket },
+        )
+        assertEquals(
+            "Wrong dropped detections",
+            droppedTickets,
+            completions.filter { it.isDropped }.map { it.ticket },
+        )
+        completions.filter { it.isDropped }.forEach { completion ->
+            assertTrue("Dropped detection ${completion.ticket} has results", completion.results.isEmpty())
+        }
+        completions.filterNot { it.isDropped }.forEach { completion ->
+            assertEquals("Wrong results count for ${completion.ticket}", 1, completion.results.size)
+        }
+    }
+
+    @Test
+    fun submittedDetections_synchronousCallsRejected() {
+        submit()
+
+        assertThrows(IllegalStateException::class.java) { testedDetector.setScreenBitmap(screenBitmap, "") }
+        assertThrows(IllegalStateException::class.java) { detectColor() }
+        assertThrows(IllegalStateException::class.java) { testedDetector.getMetrics() }
+
+        awaitCompletions(1)
+        testedDetector.setScreenBitmap(screenBitmap, "")
+        detectColor()
+    }
+
+    @Test(timeout = CLOSE_TIMEOUT_MS)
+    fun close_withSubmittedDetections() {
+        // Worker stalled on a full completions queue, with detections waiting for it
+        repeat(COMPLETIONS_CAPACITY + 1) { submitAndWaitForProcessing() }
+        repeat(2) { submit() }
+
+        testedDetector.close()
+
+        assertNull("Closed detector returned a completion", testedDetector.pollDetectionCompletion())
+        assertEquals("Closed detector accepted a detection", 0L, submit())
+    }
+
+    private fun submit(): Long =
+        testedDetector.submitDetection(
+            screenBitmap = screenBitmap,
+            metadata = "",
+            requests = listOf(
+                DetectionRequest.Color(
+                    conditionColor = Color.RED,
+                    detectionArea = Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT),
+                    threshold = TEST_DETECTION_THRESHOLD_STANDARD,
+                ),
+            ),
+        )
+
+    private fun submitAndWaitForProcessing(): Long =
+        submit().also { Thread.sleep(PROCESSING_DELAY_MS) }
+
+    private fun awaitCompletions(count: Int): List<DetectionCompletion> =
+        List(count) { index ->
+            val completion = testedDetector.awaitDetectionCompletion(COMPLETION_TIMEOUT_MS)
+            assertNotNull("Completion $index not received", completion)
+            completion!!
+        }
+
+    private fun detectColor(): DetectionResult =
+        testedDetector.detectColor(
+            conditionColor = Color.RED,
+            detectionArea = Rect(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT),
+            threshold = TEST_DETECTION_THRESHOLD_STANDARD,
+        )
+
+    private companion object {
+        const val SCREEN_WIDTH = 1080
+        const val SCREEN_HEIGHT = 1920
+        const val SUBMISSION_COUNT = 6
+        /** Capacity of the native completions queue. */
+        const val COMPLETIONS_CAPACITY = 8
+        /** Delay for the worker to process a single color detection. */
+        const val PROCESSING_DELAY_MS = 200L
+        const val COMPLETION_TIMEOUT_MS = 5_000L
+        const val CLOSE_TIMEOUT_MS = 10_000L
+    }
+}
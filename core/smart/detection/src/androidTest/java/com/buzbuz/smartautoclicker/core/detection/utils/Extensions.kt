@@ -19,6 +19,7 @@ package com.buzbuz.smartautoclicker.core.detection.utils
 import android.content.Context
 import android.graphics.Bitmap
 import android.graphics.BitmapFactory
+import com.buzbuz.smartautoclicker.core.detection.ImageDetector
 import com.buzbuz.smartautoclicker.core.detection.data.TestImage
 import java.io.File
 
@@ -48,6 +49,20 @@ internal fun Context.extractTestOcrModels(): Pair<String, Map<String, String>> {
     return detectDir.absolutePath to mapOf("latin" to latinDir.absolutePath)
 }
 
+/**
+ * Waits for the background loading of the text detection models started by [ImageDetector.loadTextDetectionModels].
+ *
+ * @return true if the models are loaded, false if they are still not ready after [timeoutMs].
+ */
+internal fun ImageDetector.awaitTextDetectionModelReady(recognitionModelId: String, timeoutMs: Long = 10_000): Boolean {
+    val deadline = System.currentTimeMillis() + timeoutMs
+    while (!isTextDetectionModelReady(recognitionModelId)) {
+        if (System.currentTimeMillis() > deadline) return false
+        Thread.sleep(10)
+    }
+    return true
+}
+
 private fun Context.copyAssetDir(assetDir: String, targetDir: File) {
     assets.list(assetDir)?.forEach { filename ->
         val target = File(targetDir, filename)
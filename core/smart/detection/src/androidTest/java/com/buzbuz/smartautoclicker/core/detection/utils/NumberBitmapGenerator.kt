@@ -61,9 +61,9 @@ private const val FONT_SIZE = 48f
 private const val PADDING   = 20
 private const val ROW_GAP   = 20
 
-internal fun renderNumberScreen(): Bitmap {
+internal fun renderNumberScreen(textColor: Int = Color.BLACK, backgroundColor: Int = Color.WHITE): Bitmap {
     val paint = Paint(Paint.ANTI_ALIAS_FLAG).apply {
-        color = Color.BLACK
+        color = textColor
         textSize = FONT_SIZE
         typeface = Typeface.MONOSPACE
     }
@@ -75,7 +75,7 @@ internal fun renderNumberScreen(): Bitmap {
 
     val bitmap = Bitmap.createBitmap(canvasW, canvasH, Bitmap.Config.ARGB_8888)
     Canvas(bitmap).apply {
-        drawColor(Color.WHITE)
+        drawColor(backgroundColor)
         NUMBERS.forEachIndexed { index, text ->
             val rowY = index * (rowHeight + ROW_GAP)
             val baseline = rowY + PADDING + (-fm.ascent)
@@ -84,3 +84,24 @@ internal fun renderNumberScreen(): Bitmap {
     }
     return bitmap
 }
+
+/**
+ * Renders a single counter line, like a score drawn by a game on each frame.
+ * The bitmap size only depends on [width], so the detection area stays the same when the counter changes.
+ */
+internal fun renderCounterScreen(text: String, width: Int, typeface: Typeface = Typeface.MONOSPACE): Bitmap {
+    val paint = Paint(Paint.ANTI_ALIAS_FLAG).apply {
+        color = Color.BLACK
+        textSize = FONT_SIZE
+        this.typeface = typeface
+    }
+
+    val fm = paint.fontMetrics
+    val height = (-fm.ascent + fm.descent).toInt() + PADDING * 2
+    val bitmap = Bitmap.createBitmap(width, height, Bitmap.Config.ARGB_8888)
+    Canvas(bitmap).apply {
+        drawColor(Color.WHITE)
+        drawText(text, PADDING.toFloat(), PADDING + (-fm.ascent), paint)
+    }
+    return bitmap
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "detection_batch.hpp"
+#include "../matching/text/text_matching_result.hpp"
+
+using namespace smartautoclicker;
+
+ConditionResult ConditionResult::from(const DetectionResult* result) {
+    ConditionResult values;
+    if (result == nullptr) return values;
+
+    values.isDetected = result->isDetected();
+    values.centerX = result->getResultAreaCenterX();
+    values.centerY = result->getResultAreaCenterY();
+    values.width = result->getResultAreaWidth();
+    values.height = result->getResultAreaHeight();
+    values.confidence = result->getResultConfidence();
+
+    auto* textResult = dynamic_cast<const TextMatchingResult*>(result);
+    if (textResult != nullptr) {
+        values.recognizedNumber = textResult->getRecognizedNumber();
+        values.isNotReady = textResult->isNotReady();
+        values.isStale = textResult->isStale();
+        values.ageMs = textResult->getResultAgeMs();
+    }
+
+    return values;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_DETECTION_BATCH_HPP
+#define KLICK_R_DETECTION_BATCH_HPP
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "../detection_result.hpp"
+#include "../matching/text/text_matcher.hpp"
+
+namespace smartautoclicker {
+
+    /** The kind of detection of a batch condition. Values must match the Kotlin DetectionRequest types. */
+    enum class ConditionType {
+        IMAGE = 0,
+        COLOR = 1,
+        TEXT = 2,
+        NUMBER = 3,
+    };
+
+    /** A condition to detect in the screen image of a batch. Only the fields of its type are used. */
+    struct BatchCondition {
+        ConditionType type = ConditionType::IMAGE;
+        /** The area of the screen to detect the condition in. */
+        cv::Rect detectionArea;
+        int threshold = 0;
+
+        /** IMAGE: The RGBA condition image, and its expected size on the screen. */
+        cv::Mat conditionMat;
+        int conditionWidth = 0;
+        int conditionHeight = 0;
+        /** COLOR: The ARGB color to detect. */
+        int conditionColor = 0;
+        /** TEXT: The text to detect, and the recognition model to use. */
+        std::string conditionText;
+        std::string recognitionModelId;
+        /** NUMBER: How to interpret the separators of the detected number. */
+        NumberFormat numberFormat = NumberFormat::AUTO;
+        /** TEXT and NUMBER: The refresh period hint, or 0 to adapt it to the result changes. */
+        int64_t refreshPeriodMs = 0;
+    };
+
+    /** A screen image and the conditions to detect in it, submitted for an asynchronous detection. */
+    struct DetectionBatch {
+        /** Identifies the batch in its completion. */
+        uint64_t ticket = 0;
+        /** Copy of the RGBA screen image, the caller can reuse its bitmap once submitted. */
+        cv::Mat screenMat;
+        /** The tag for the metrics of the screen image. */
+        std::string metricsTag;
+        /** The conditions to detect, in order. */
+        std::vector<BatchCondition> conditions;
+    };
+
+    /** The values of a detection result, kept after the matchers are reused for the next detections. */
+    struct ConditionResult {
+        bool isDetected = false;
+        int centerX = 0;
+        int centerY = 0;
+        int width = 0;
+        int height = 0;
+        double confidence = 0.0;
+        double recognizedNumber = std::numeric_limits<double>::lowest();
+        bool isNotReady = false;
+        bool isStale = false;
+        int64_t ageMs = 0;
+
+        /**
+         * Copy the values of a matcher result.
+         * @param result The result of a matcher, can be nullptr.
+         * @return The values of the result, or a not detected result if there is none.
+         */
+        static ConditionResult from(const DetectionResult* result);
+    };
+
+    /** The completion of a submitted batch. */
+    struct BatchCompletion {
+        /** The ticket of the batch. */
+        uint64_t ticket = 0;
+        /** true if the batch has been dropped for a more recent one before being processed. */
+        bool isDropped = false;
+        /** Duration of the batch detection, in milliseconds. */
+        uint64_t durationMs = 0;
+        /** The results of the batch conditions, in order. Empty if dropped. */
+        std::vector<ConditionResult> results;
+    };
+}
+
+#endif //KLICK_R_DETECTION_BATCH_HPP
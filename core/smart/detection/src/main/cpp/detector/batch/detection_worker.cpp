@@ -0,0 +1,232 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+
+#include "detection_worker.hpp"
+#include "../detector.hpp"
+#include "../../logs/log.h"
+
+using namespace smartautoclicker;
+
+DetectionWorker::DetectionWorker(Detector& detector, const ExecutionPolicy& policy) :
+        detector(detector),
+        workerPolicy(policy) {
+
+    thread = std::thread(&DetectionWorker::run, this);
+}
+
+DetectionWorker::~DetectionWorker() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        isStopping = true;
+    }
+    workerCondition.notify_all();
+    thread.join();
+}
+
+std::unique_ptr<DetectionBatch> DetectionWorker::obtainBatch() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        if (!freeBatches.empty()) {
+            std::unique_ptr<DetectionBatch> batch = std::move(freeBatches.back());
+            freeBatches.pop_back();
+            return batch;
+        }
+    }
+
+    return std::make_unique<DetectionBatch>();
+}
+
+uint64_t DetectionWorker::submit(std::unique_ptr<DetectionBatch> batch) {
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        ticket = nextTicket++;
+        batch->ticket = ticket;
+
+        // The oldest screen image is the most outdated one, drop it
+        if (pendingBatches.size() >= maxPendingBatches) {
+            std::unique_ptr<DetectionBatch> droppedBatch = std::move(pendingBatches.front());
+            pendingBatches.pop_front();
+
+            LOGD("DetectionWorker", "Queue is full, dropping batch %llu",
+                 static_cast<unsigned long long>(droppedBatch->ticket));
+            droppedTickets.push_back(droppedBatch->ticket);
+            droppedBatch->conditions.clear();
+            freeBatches.push_back(std::move(droppedBatch));
+        }
+
+        pendingBatches.push_back(std::move(batch));
+    }
+
+    workerCondition.notify_all();
+    return ticket;
+}
+
+bool DetectionWorker::poll(BatchCompletion& completion, int64_t timeoutMs) {
+    if (!completions.pop(completion)) {
+        if (timeoutMs <= 0) return false;
+
+        std::unique_lock<std::mutex> lock(completionMutex);
+        bool hasCompletion = completionCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+            return !completions.empty();
+        });
+        lock.unlock();
+
+        if (!hasCompletion || !completions.pop(completion)) return false;
+    }
+
+    // The worker might be waiting for some room in the completions queue
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+    }
+    workerCondition.notify_all();
+    return true;
+}
+
+void DetectionWorker::setExecutionPolicy(const ExecutionPolicy& policy) {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        workerPolicy = policy;
+        isPolicyChanged = true;
+    }
+    workerCondition.notify_all();
+}
+
+void DetectionWorker::run() {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (true) {
+        workerCondition.wait(lock, [this]() {
+            return isStopping || isPolicyChanged || !droppedTickets.empty() || !pendingBatches.empty();
+        });
+        if (isStopping) return;
+
+        if (isPolicyChanged) {
+            ExecutionPolicy policy = workerPolicy;
+            isPolicyChanged = false;
+            lock.unlock();
+            policy.bindCurrentThread();
+            detector.applyExecutionPolicy(policy);
+            lock.lock();
+            continue;
+        }
+
+        // Dropped batches are older than the pending ones, complete them first
+        if (!droppedTickets.empty()) {
+            BatchCompletion completion;
+            completion.ticket = droppedTickets.front();
+            completion.isDropped = true;
+            droppedTickets.pop_front();
+
+            lock.unlock();
+            bool isPushed = pushCompletion(std::move(completion));
+            lock.lock();
+            if (!isPushed) return;
+            continue;
+        }
+
+        std::unique_ptr<DetectionBatch> batch = std::move(pendingBatches.front());
+        pendingBatches.pop_front();
+        lock.unlock();
+
+        BatchCompletion completion;
+        completion.ticket = batch->ticket;
+        process(*batch, completion);
+        bool isPushed = pushCompletion(std::move(completion));
+        batch->conditions.clear();
+
+        lock.lock();
+        freeBatches.push_back(std::move(batch));
+        if (!isPushed) return;
+    }
+}
+
+void DetectionWorker::process(DetectionBatch& batch, BatchCompletion& completion) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Cheapest conditions first, so the expensive ones are the ones deferred when the frame budget is exceeded
+    std::vector<double> costs(batch.conditions.size());
+    std::vector<size_t> detectionOrder(batch.conditions.size());
+    for (size_t i = 0; i < batch.conditions.size(); i++) {
+        costs[i] = detector.getEstimatedCost(batch.conditions[i]);
+        detectionOrder[i] = i;
+    }
+    std::stable_sort(detectionOrder.begin(), detectionOrder.end(), [&costs](size_t first, size_t second) {
+        return costs[first] < costs[second];
+    });
+
+    detector.setScreenImage(std::make_unique<cv::Mat>(batch.screenMat), batch.metricsTag.c_str());
+    completion.results.resize(batch.conditions.size());
+    for (size_t index : detectionOrder) {
+        completion.results[index] = ConditionResult::from(detect(batch.conditions[index]));
+    }
+    detector.releaseScreenImage();
+
+    completion.durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+}
+
+const DetectionResult* DetectionWorker::detect(BatchCondition& condition) {
+    try {
+        switch (condition.type) {
+            case ConditionType::IMAGE:
+                return detector.detectImage(
+                        std::make_unique<cv::Mat>(condition.conditionMat),
+                        condition.conditionWidth,
+                        condition.conditionHeight,
+                        condition.detectionArea,
+                        condition.threshold);
+            case ConditionType::COLOR:
+                return detector.detectColor(condition.conditionColor, condition.detectionArea, condition.threshold);
+            case ConditionType::TEXT:
+                return detector.detectText(
+                        condition.conditionText.c_str(),
+                        condition.recognitionModelId.c_str(),
+                        condition.detectionArea,
+                        condition.threshold,
+                        condition.refreshPeriodMs);
+            case ConditionType::NUMBER:
+                return detector.detectNumber(
+                        condition.detectionArea,
+                        condition.threshold,
+                        condition.numberFormat,
+                        condition.refreshPeriodMs);
+        }
+    } catch (...) {
+        LOGE("DetectionWorker", "Invalid detection arguments for condition type %d", static_cast<int>(condition.type));
+    }
+
+    return nullptr;
+}
+
+bool DetectionWorker::pushCompletion(BatchCompletion&& completion) {
+    {
+        std::unique_lock<std::mutex> lock(workerMutex);
+        workerCondition.wait(lock, [this]() { return isStopping || !completions.full(); });
+        if (isStopping) return false;
+    }
+
+    completions.push(std::move(completion));
+
+    // Poll might be waiting for this completion
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+    }
+    completionCondition.notify_all();
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_DETECTION_WORKER_HPP
+#define KLICK_R_DETECTION_WORKER_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "detection_batch.hpp"
+#include "../execution_policy.hpp"
+#include "../../utils/spsc_queue.hpp"
+
+namespace smartautoclicker {
+
+    class Detector;
+
+    /**
+     * Runs the detection of the submitted batches on its own thread.
+     *
+     * Batches are queued with a bounded depth: when a batch is submitted to a full queue, the oldest pending one is
+     * dropped, as its screen image is outdated anyway. Completions, including the dropped batches ones, are pushed
+     * into a lock-free queue, polled by the caller thread. The worker stops processing batches while this queue is
+     * full, so the caller must poll the completions regularly.
+     */
+    class DetectionWorker {
+
+    public:
+        /**
+         * Starts the worker thread.
+         * @param detector The detector running the detections. Must outlive this worker, and must only be used by
+         * this worker while batches are pending.
+         * @param policy The execution policy applied to the worker thread.
+         */
+        DetectionWorker(Detector& detector, const ExecutionPolicy& policy);
+        /** Stops the worker thread. The pending batches are discarded. */
+        ~DetectionWorker();
+
+        DetectionWorker(const DetectionWorker&) = delete;
+        DetectionWorker& operator=(const DetectionWorker&) = delete;
+
+        /**
+         * Get an empty batch to fill and submit, reusing the buffers of a completed batch if possible.
+         * @return The batch, without any condition.
+         */
+        std::unique_ptr<DetectionBatch> obtainBatch();
+
+        /**
+         * Queues a batch for detection, dropping the oldest pending batch if the queue is full.
+         * @param batch The batch to detect.
+         * @return The ticket identifying the batch in its completion.
+         */
+        uint64_t submit(std::unique_ptr<DetectionBatch> batch);
+
+        /**
+         * Get the next batch completion. Must always be called from the same thread.
+         * @param completion Set to the completion, if any.
+         * @param timeoutMs The maximum time to wait for a completion, in milliseconds. 0 to return immediately.
+         * @return true if a completion has been found, false if there is none before the timeout.
+         */
+        bool poll(BatchCompletion& completion, int64_t timeoutMs);
+
+        /**
+         * Set how the detection uses the CPU, applied by the worker thread before its next batch.
+         * @param policy The new execution policy.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
+    private:
+        /** Maximum number of batches waiting for detection. */
+        static constexpr size_t maxPendingBatches = 2;
+        /** Maximum number of completions waiting to be polled. */
+        static constexpr size_t maxCompletions = 8;
+
+        /** The detector running the detections, only used from the worker thread. */
+        Detector& detector;
+
+        /** Protects the worker state below. */
+        std::mutex workerMutex;
+        /** Notified when a batch is submitted, a completion is polled, or the worker state changes. */
+        std::condition_variable workerCondition;
+        /** The batches waiting for detection, from the oldest to the newest. */
+        std::deque<std::unique_ptr<DetectionBatch>> pendingBatches;
+        /** The tickets of the dropped batches, waiting for their completion to be pushed. */
+        std::deque<uint64_t> droppedTickets;
+        /** The processed batches, kept to reuse their buffers. */
+        std::vector<std::unique_ptr<DetectionBatch>> freeBatches;
+        /** The ticket of the next submitted batch. */
+        uint64_t nextTicket = 1;
+        /** The execution policy to apply to the worker thread. */
+        ExecutionPolicy workerPolicy;
+        /** true if the workerPolicy must be applied. */
+        bool isPolicyChanged = true;
+        /** true to stop the worker. */
+        bool isStopping = false;
+
+        /** The completions, pushed by the worker thread and polled by the caller thread. */
+        SpscQueue<BatchCompletion, maxCompletions> completions;
+        /** Used to wait for a completion in poll. */
+        std::mutex completionMutex;
+        /** Notified when a completion is pushed. */
+        std::condition_variable completionCondition;
+
+        /** The worker thread, started last, once all members are initialized. */
+        std::thread thread;
+
+        /** Worker thread loop, processing the batches until stopped. */
+        void run();
+
+        /**
+         * Detects all conditions of a batch.
+         * @param batch The batch to detect.
+         * @param completion Filled with the results of the batch conditions.
+         */
+        void process(DetectionBatch& batch, BatchCompletion& completion);
+
+        /**
+         * Detects a single condition on the current screen image.
+         * @param condition The condition to detect.
+         * @return The result of the matcher, valid until the next detection, or nullptr on error.
+         */
+        const DetectionResult* detect(BatchCondition& condition);
+
+        /**
+         * Pushes a completion, waiting for the caller to poll if the completions queue is full.
+         * @param completion The completion to push.
+         * @return true if pushed, false if the worker has been stopped before.
+         */
+        bool pushCompletion(BatchCompletion&& completion);
+    };
+}
+
+#endif //KLICK_R_DETECTION_WORKER_HPP
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_CANCELLATION_TOKEN_HPP
+#define KLICK_R_CANCELLATION_TOKEN_HPP
+
+#include <atomic>
+
+namespace smartautoclicker {
+
+    /**
+     * Cooperative cancellation of the detections.
+     * Set from any thread, and checked by the detection between its stages. Once cancelled, it stays cancelled until
+     * reset, so the detections following the cancelled one are skipped too.
+     */
+    class CancellationToken {
+
+    public:
+        /** Requests the cancellation of the running and following detections. */
+        void cancel() {
+            cancelled.store(true, std::memory_order_relaxed);
+        }
+
+        /** Allows the detections again. */
+        void reset() {
+            cancelled.store(false, std::memory_order_relaxed);
+        }
+
+        /** @return true if the detections must stop as soon as possible. */
+        [[nodiscard]] bool isCancelled() const {
+            return cancelled.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Checks an optional token.
+         * @param token The token to check, can be nullptr.
+         * @return true if the token is set and cancelled.
+         */
+        static bool isCancelled(const CancellationToken* token) {
+            return token != nullptr && token->isCancelled();
+        }
+
+    private:
+        std::atomic<bool> cancelled { false };
+    };
+}
+
+#endif //KLICK_R_CANCELLATION_TOKEN_HPP
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KLICK_R_DETECTION_METRICS_HPP
+#define KLICK_R_DETECTION_METRICS_HPP
+
+#include <cstdint>
+
+namespace smartautoclicker {
+
+    /**
+     * Counters collected by the detector during a detection session.
+     * Values are cumulative since the detector creation.
+     */
+    struct DetectionMetrics {
+        /** Number of text recognitions served from the recognition cache. */
+        uint64_t recognitionCacheHits = 0;
+        /** Number of text recognitions that required a model inference. */
+        uint64_t recognitionCacheMisses = 0;
+        /** Number of text detection areas rejected before running the detection network. */
+        uint64_t textPrefilterRejections = 0;
+        /** Number of number detections resolved without the text detection network, on a single text line. */
+        uint64_t singleLineFastPaths = 0;
+        /** Number of detected text boxes not recognized because a match was found in a more likely one. */
+        uint64_t skippedTextRecognitions = 0;
+        /** Duration of the text detection model warm-up inference, in milliseconds. */
+        uint64_t detectionWarmUpMs = 0;
+        /** Total duration of the warm-up inferences of the loaded text recognition models, in milliseconds. */
+        uint64_t recognitionWarmUpMs = 0;
+        /** Number of number detections read with the glyphs learned in their area, without the recognition network. */
+        uint64_t glyphTemplateReads = 0;
+        /** Number of text and number detections deferred to a later frame, their last result being served instead. */
+        uint64_t deferredTextDetections = 0;
+        /** Number of screen frames whose detections exceeded the frame budget. */
+        uint64_t frameBudgetOverruns = 0;
+        /** Number of text and number detections not refreshed on a frame, their refresh period not being elapsed. */
+        uint64_t amortizedTextDetections = 0;
+    };
+}
+
+#endif //KLICK_R_DETECTION_METRICS_HPP
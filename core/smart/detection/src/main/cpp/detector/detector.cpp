@@ -27,12 +27,88 @@ using namespace cv;
 using namespace smartautoclicker;
 
 
-bool Detector::loadModels(const std::string& detectionModelPath, const std::map<std::string, std::string>& recognitionModels) {
-    return textMatcher->init(detectionModelPath, recognitionModels);
+Detector::Detector() {
+    applyExecutionPolicy(executionPolicy);
+    templateMatcher->setCancellationToken(&cancellationToken);
+    textMatcher->setCancellationToken(&cancellationToken);
+}
+
+void Detector::setExecutionPolicy(const ExecutionPolicy& policy) {
+    executionPolicy = policy;
+    if (detectionWorker) {
+        detectionWorker->setExecutionPolicy(executionPolicy);
+    } else {
+        applyExecutionPolicy(executionPolicy);
+    }
+}
+
+void Detector::applyExecutionPolicy(const ExecutionPolicy& policy) {
+    policy.applyToThreadPools();
+    screenImage->setExecutionPolicy(policy);
+    textMatcher->setExecutionPolicy(policy);
+}
+
+void Detector::setRecognitionMemoryBudget(size_t budget) {
+    textMatcher->setRecognitionMemoryBudget(budget);
+}
+
+void Detector::setFrameBudget(int64_t budgetMs) {
+    frameBudget.setBudget(budgetMs);
+    if (!frameBudget.isEnabled() && !refreshScheduler.isEnabled()) lastTextResults.clear();
+}
+
+void Detector::cancelDetection() {
+    cancellationToken.cancel();
+}
+
+void Detector::resetCancellation() {
+    cancellationToken.reset();
+}
+
+bool Detector::isDetectionCancelled() const {
+    return cancellationToken.isCancelled();
+}
+
+void Detector::setRefreshScheduling(bool enabled) {
+    refreshScheduler.setEnabled(enabled);
+    if (!frameBudget.isEnabled() && !refreshScheduler.isEnabled()) lastTextResults.clear();
+}
+
+double Detector::getEstimatedCost(const BatchCondition& condition) const {
+    switch (condition.type) {
+        case ConditionType::TEXT:
+            return frameBudget.getEstimatedCost(FrameBudget::computeTextKey(
+                    condition.detectionArea, condition.conditionText, condition.recognitionModelId));
+        case ConditionType::NUMBER:
+            return frameBudget.getEstimatedCost(FrameBudget::computeNumberKey(
+                    condition.detectionArea, static_cast<int>(condition.numberFormat)));
+        default:
+            return 0.0;
+    }
+}
+
+bool Detector::loadModels(
+        const std::string& detectionModelPath,
+        const std::map<std::string, std::string>& recognitionModels,
+        bool warmUp,
+        InferencePrecision detectionPrecision,
+        InferencePrecision recognitionPrecision)
+{
+    return textMatcher->init(detectionModelPath, recognitionModels, warmUp, detectionPrecision, recognitionPrecision);
+}
+
+bool Detector::isTextModelReady(const char* recognitionModelId) {
+    return textMatcher->isModelReady(recognitionModelId);
 }
 
 void Detector::setScreenImage(std::unique_ptr<cv::Mat> screenColorMat, const char* metricsTag) {
     screenImage->processNewData(std::move(screenColorMat), metricsTag);
+    frameBudget.startFrame();
+    refreshScheduler.startFrame();
+}
+
+void Detector::releaseScreenImage() {
+    screenImage->releaseData();
 }
 
 TemplateMatchingResult* Detector::detectImage(
@@ -43,6 +119,7 @@ TemplateMatchingResult* Detector::detectImage(
         int threshold
 ) {
     templateMatcher->reset();
+    if (cancellationToken.isCancelled()) return templateMatcher->getMatchingResults();
 
     // Load condition and resize to requested size
     conditionImage->processNewData(
@@ -62,11 +139,14 @@ TemplateMatchingResult* Detector::detectImage(
             roi,
             threshold);
 
+    // A partial matching may have found a lower confidence candidate
+    if (cancellationToken.isCancelled()) templateMatcher->reset();
     return templateMatcher->getMatchingResults();
 }
 
 ColorMatchingResult* Detector::detectColor(int colorCondition, const cv::Rect& roi, int threshold) {
     colorMatcher->reset();
+    if (cancellationToken.isCancelled()) return colorMatcher->getMatchingResults();
 
     // Verify area validity
     if (!ColorMatcher::isRoiValidForMatching(screenImage->getRoi(), roi)) {
@@ -89,15 +169,189 @@ ColorMatchingResult* Detector::detectColor(int colorCondition, const cv::Rect& r
     return colorMatcher->getMatchingResults();
 }
 
-TextMatchingResult* Detector::detectText(const char* textCondition, const char* recognitionModelId, const cv::Rect& roi, int threshold) {
-    return textMatcher->matchText(
+TextMatchingResult* Detector::detectText(
+        const char* textCondition,
+        const char* recognitionModelId,
+        const cv::Rect& roi,
+        int threshold,
+        int64_t refreshPeriodMs
+) {
+    if (cancellationToken.isCancelled()) {
+        staleTextResult.reset();
+        return &staleTextResult;
+    }
+
+    uint64_t conditionKey = FrameBudget::computeTextKey(roi, textCondition, recognitionModelId);
+    if (!shouldDetect(conditionKey, refreshPeriodMs, lastTextResults.count(conditionKey) != 0)) {
+        staleTextResult = getStaleResult(conditionKey);
+        return &staleTextResult;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    TextMatchingResult* result = textMatcher->matchText(
             *screenImage,
             std::string(textCondition),
             std::string(recognitionModelId),
             roi,
             threshold);
+
+    // Models still loading or a cancelled matching are not a cost nor a refresh of the condition
+    if (cancellationToken.isCancelled()) result->reset();
+    if (result->isNotReady() || cancellationToken.isCancelled()) {
+        frameBudget.finish(0, startTime);
+        return result;
+    }
+
+    frameBudget.finish(conditionKey, startTime);
+    refreshScheduler.onRefreshed(conditionKey, refreshPeriodMs, keepLastResult(conditionKey, *result));
+    return result;
+}
+
+std::vector<TextMatchingResult>* Detector::detectTexts(
+        const std::vector<std::string>& textConditions,
+        const char* recognitionModelId,
+        const cv::Rect& roi,
+        const std::vector<int>& thresholds,
+        int64_t refreshPeriodMs
+) {
+    if (cancellationToken.isCancelled()) {
+        staleTextResults.resize(textConditions.size());
+        for (auto& result : staleTextResults) result.reset();
+        return &staleTextResults;
+    }
+
+    // The texts are recognized together, their group is scheduled as a single condition
+    std::vector<uint64_t> conditionKeys;
+    conditionKeys.reserve(textConditions.size());
+    bool hasLastResults = true;
+    for (const auto& textCondition : textConditions) {
+        conditionKeys.push_back(FrameBudget::computeTextKey(roi, textCondition, recognitionModelId));
+        hasLastResults &= lastTextResults.count(conditionKeys.back()) != 0;
+    }
+    uint64_t groupKey = FrameBudget::computeGroupKey(conditionKeys);
+
+    if (!shouldDetect(groupKey, refreshPeriodMs, hasLastResults)) {
+        staleTextResults.clear();
+        for (uint64_t conditionKey : conditionKeys) staleTextResults.push_back(getStaleResult(conditionKey));
+        return &staleTextResults;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<TextMatchingResult>* results = textMatcher->matchTexts(
+            *screenImage,
+            textConditions,
+            std::string(recognitionModelId),
+            roi,
+            thresholds);
+
+    if (cancellationToken.isCancelled()) {
+        for (auto& result : *results) result.reset();
+    }
+    if ((!results->empty() && results->front().isNotReady()) || cancellationToken.isCancelled()) {
+        frameBudget.finish(0, startTime);
+        return results;
+    }
+
+    frameBudget.finish(groupKey, startTime);
+    bool isChanged = false;
+    for (size_t i = 0; i < results->size() && i < conditionKeys.size(); i++) {
+        isChanged |= keepLastResult(conditionKeys[i], (*results)[i]);
+    }
+    refreshScheduler.onRefreshed(groupKey, refreshPeriodMs, isChanged);
+    return results;
+}
+
+TextMatchingResult* Detector::detectNumber(
+        const cv::Rect& roi,
+        int threshold,
+        NumberFormat numberFormat,
+        int64_t refreshPeriodMs
+) {
+    if (cancellationToken.isCancelled()) {
+        staleTextResult.reset();
+        return &staleTextResult;
+    }
+
+    uint64_t conditionKey = FrameBudget::computeNumberKey(roi, static_cast<int>(numberFormat));
+    if (!shouldDetect(conditionKey, refreshPeriodMs, lastTextResults.count(conditionKey) != 0)) {
+        staleTextResult = getStaleResult(conditionKey);
+        return &staleTextResult;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+    TextMatchingResult* result = textMatcher->matchNumber(*screenImage, roi, threshold, numberFormat);
+
+    if (cancellationToken.isCancelled()) result->reset();
+    if (result->isNotReady() || cancellationToken.isCancelled()) {
+        frameBudget.finish(0, startTime);
+        return result;
+    }
+
+    frameBudget.finish(conditionKey, startTime);
+    refreshScheduler.onRefreshed(conditionKey, refreshPeriodMs, keepLastResult(conditionKey, *result));
+    return result;
+}
+
+std::unique_ptr<DetectionBatch> Detector::obtainBatch() {
+    if (!detectionWorker) return std::make_unique<DetectionBatch>();
+    return detectionWorker->obtainBatch();
 }
 
-TextMatchingResult* Detector::detectNumber(const cv::Rect& roi, int threshold, NumberFormat numberFormat) {
-    return textMatcher->matchNumber(*screenImage, roi, threshold, numberFormat);
+uint64_t Detector::submitBatch(std::unique_ptr<DetectionBatch> batch) {
+    if (!detectionWorker) detectionWorker = std::make_unique<DetectionWorker>(*this, executionPolicy);
+    return detectionWorker->submit(std::move(batch));
+}
+
+bool Detector::pollBatchCompletion(BatchCompletion& completion, int64_t timeoutMs) {
+    if (!detectionWorker) return false;
+    return detectionWorker->poll(completion, timeoutMs);
+}
+
+DetectionMetrics Detector::getMetrics() const {
+    DetectionMetrics metrics;
+    textMatcher->collectMetrics(metrics);
+    metrics.deferredTextDetections = frameBudget.getDeferredCount();
+    metrics.frameBudgetOverruns = frameBudget.getOverrunCount();
+    metrics.amortizedTextDetections = refreshScheduler.getAmortizedCount();
+    return metrics;
+}
+
+bool Detector::shouldDetect(uint64_t scheduleKey, int64_t refreshPeriodMs, bool hasLastResult) {
+    // Without a last result, there is nothing to serve instead of the detection
+    if (!hasLastResult) return true;
+
+    if (!refreshScheduler.isRefreshDue(scheduleKey, refreshPeriodMs)) {
+        refreshScheduler.onAmortized();
+        return false;
+    }
+
+    return frameBudget.tryStart(scheduleKey);
+}
+
+bool Detector::keepLastResult(uint64_t conditionKey, const TextMatchingResult& result) {
+    if (!frameBudget.isEnabled() && !refreshScheduler.isEnabled()) return true;
+
+    auto lastResult = lastTextResults.find(conditionKey);
+    if (lastResult == lastTextResults.end()) {
+        if (lastTextResults.size() >= maxLastTextResults) lastTextResults.clear();
+        lastTextResults[conditionKey] = { result, std::chrono::steady_clock::now() };
+        return true;
+    }
+
+    const TextMatchingResult& previous = lastResult->second.result;
+    bool isChanged = previous.isDetected() != result.isDetected()
+            || previous.getRecognizedNumber() != result.getRecognizedNumber()
+            || previous.getResultArea() != result.getResultArea();
+
+    lastResult->second = { result, std::chrono::steady_clock::now() };
+    return isChanged;
+}
+
+TextMatchingResult Detector::getStaleResult(uint64_t conditionKey) {
+    const LastTextResult& lastResult = lastTextResults.at(conditionKey);
+
+    TextMatchingResult staleResult = lastResult.result;
+    staleResult.markResultAsStale(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - lastResult.time).count());
+    return staleResult;
 }
@@ -19,7 +19,9 @@
 #define KLICK_R_DETECTOR_HPP
 
 #include <opencv2/imgproc/imgproc.hpp>
+#include <chrono>
 #include <map>
+#include <unordered_map>
 
 #include "matching/color/color_matcher.hpp"
 #include "matching/color/color_matching_result.hpp"
@@ -27,8 +29,14 @@
 #include "matching/template/template_matching_result.hpp"
 #include "matching/text/text_matcher.hpp"
 #include "matching/text/text_matching_result.hpp"
+#include "batch/detection_worker.hpp"
+#include "cancellation_token.hpp"
 #include "images/condition_image.hpp"
 #include "images/screen_image.hpp"
+#include "scheduling/frame_budget.hpp"
+#include "scheduling/refresh_scheduler.hpp"
+#include "detection_metrics.hpp"
+#include "execution_policy.hpp"
 
 namespace smartautoclicker {
 
@@ -42,13 +50,134 @@ namespace smartautoclicker {
         std::unique_ptr<TemplateMatcher> templateMatcher = std::make_unique<TemplateMatcher>();
         std::unique_ptr<TextMatcher> textMatcher = std::make_unique<TextMatcher>();
 
+        /** How the detection uses the CPU. */
+        ExecutionPolicy executionPolicy;
+        /** Stops the running detection, checked by the matchers between their stages. */
+        CancellationToken cancellationToken;
+
+        /** Defers the text and number conditions not fitting in the frame budget. */
+        FrameBudget frameBudget;
+        /** Spreads the refresh of the text and number conditions across the frames. */
+        RefreshScheduler refreshScheduler;
+
+        /** The last computed result of a condition, and when it was computed. */
+        struct LastTextResult {
+            TextMatchingResult result;
+            std::chrono::steady_clock::time_point time;
+        };
+        /** Maximum number of last results kept. They are all dropped once exceeded. */
+        static constexpr size_t maxLastTextResults = 256;
+        /** The last computed result of each text and number condition, served when it isn't detected on a frame. */
+        std::unordered_map<uint64_t, LastTextResult> lastTextResults;
+        /** The results returned for the conditions not detected on the current frame. */
+        TextMatchingResult staleTextResult;
+        std::vector<TextMatchingResult> staleTextResults;
+
+        /** Runs the submitted batches, created on the first one. Declared last to be stopped before the matchers. */
+        std::unique_ptr<DetectionWorker> detectionWorker;
+
     public:
 
-        Detector() = default;
+        Detector();
+
+        /**
+         * Set how the detection uses the CPU. Must be called from the detection thread.
+         * The default policy runs on all big cores. The thread count is applied to all thread pools. The threads owned
+         * by the detection, the screen image worker and the batch detection thread, are bound to the policy cores for
+         * their lifetime. The caller threads running the synchronous detections are only bound during each inference.
+         * @param policy The new execution policy.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
+        /**
+         * Applies the thread count of an execution policy to the thread pools and to the matchers. Called by
+         * setExecutionPolicy, or from the batch detection thread.
+         * @param policy The execution policy to apply.
+         */
+        void applyExecutionPolicy(const ExecutionPolicy& policy);
+
+        /**
+         * Set the maximum memory used by the loaded text recognition models. Must be called from the detection thread.
+         * The least recently used recognition models are unloaded when the budget is exceeded, and loaded again in
+         * background on their next use. By default, there is no limit.
+         * @param budget The memory budget in bytes, or 0 for no limit.
+         */
+        void setRecognitionMemoryBudget(size_t budget);
+
+        /**
+         * Set the maximum duration of the detections of a screen image, starting when it is set.
+         * Text and number conditions whose learned cost doesn't fit in the remaining budget are not detected, and their
+         * last result is returned instead, marked as stale. By default, there is no budget.
+         * @param budgetMs The budget in milliseconds, or 0 for no budget.
+         */
+        void setFrameBudget(int64_t budgetMs);
+
+        /**
+         * Enables the refresh scheduling of the text and number conditions. Each condition is then detected according
+         * to its refresh period, either hinted with the detection, or adapted to how often its result changes. On the
+         * other frames, its last result is returned, marked as stale with its age. By default, all conditions are
+         * detected on every frame.
+         * @param enabled true to enable, false to disable.
+         */
+        void setRefreshScheduling(bool enabled);
+
+        /**
+         * Cancels the running detection, and skips all following ones until resetCancellation is called.
+         * Can be called from any thread. The running detection stops at its next stage, text box or template stripe,
+         * and the results of the cancelled detections are not detected and must be ignored.
+         */
+        void cancelDetection();
+
+        /** Allows the detections again after cancelDetection. Must be called from the detection thread. */
+        void resetCancellation();
+
+        /** @return true if the detections are cancelled. Can be called from any thread. */
+        [[nodiscard]] bool isDetectionCancelled() const;
+
+        /**
+         * Get the estimated duration of a batch condition detection, learned from its previous detections.
+         * @param condition The condition to estimate.
+         * @return The estimated duration in milliseconds, 0 for image and color conditions.
+         */
+        [[nodiscard]] double getEstimatedCost(const BatchCondition& condition) const;
+
+        /**
+         * Starts loading the text detection and recognition models in background, and returns immediately.
+         * Until a model is loaded, the text matching results using it are marked as not ready.
+         * @param detectionModelPath Path to the detection model folder.
+         * @param recognitionModels Map of recognition model identifier to their folder path.
+         * @param warmUp true to run a dummy inference with each model after loading it, so the first text matching
+         * doesn't pay for the network setup.
+         * @param detectionPrecision The precision of the text detection inferences.
+         * @param recognitionPrecision The precision of the text recognition inferences, for all models. Models without
+         * int8 files fall back to fp16.
+         * @return true if the loading has started, false if not.
+         */
+        bool loadModels(
+                const std::string& detectionModelPath,
+                const std::map<std::string, std::string>& recognitionModels,
+                bool warmUp,
+                InferencePrecision detectionPrecision,
+                InferencePrecision recognitionPrecision);
+
+        /**
+         * Tells if the models required by a text matching are loaded.
+         * @param recognitionModelId The identifier of the recognition model provided with loadModels.
+         * @return true if the text detection and recognition models are loaded, false if not.
+         */
+        bool isTextModelReady(const char* recognitionModelId);
 
-        bool loadModels(const std::string& detectionModelPath, const std::map<std::string, std::string>& recognitionModels);
+        /**
+         * Set the content of the screen for the following detections. The images derived from it are prepared in
+         * background, while the detections that don't need them are running.
+         * @param screenColorMat The RGBA screen image. Its pixels must stay valid until releaseScreenImage is called.
+         * @param metricsTag The tag for the metrics of this frame.
+         */
         void setScreenImage(std::unique_ptr<cv::Mat> screenColorMat, const char* metricsTag);
 
+        /** Waits until the screen image isn't used anymore in background. Its pixels can then be released. */
+        void releaseScreenImage();
+
         TemplateMatchingResult* detectImage(
                 std::unique_ptr<cv::Mat> conditionMat,
                 int targetConditionWidth,
@@ -65,9 +194,73 @@ namespace smartautoclicker {
                 const char* textCondition,
                 const char* recognitionModelId,
                 const cv::Rect &roi,
-                int threshold);
+                int threshold,
+                int64_t refreshPeriodMs);
+
+        std::vector<TextMatchingResult>* detectTexts(
+                const std::vector<std::string>& textConditions,
+                const char* recognitionModelId,
+                const cv::Rect& roi,
+                const std::vector<int>& thresholds,
+                int64_t refreshPeriodMs);
+
+        TextMatchingResult* detectNumber(
+                const cv::Rect& roi,
+                int threshold,
+                NumberFormat numberFormat,
+                int64_t refreshPeriodMs);
+
+        /**
+         * Get an empty batch to fill with the screen image and conditions, and to submit with submitBatch.
+         * @return The batch, reusing the buffers of a completed one if possible.
+         */
+        std::unique_ptr<DetectionBatch> obtainBatch();
+
+        /**
+         * Queues a batch for detection on a dedicated thread, and returns immediately. If two batches are already
+         * waiting, the oldest one is dropped. The other detection methods must not be called until all submitted
+         * batches are completed.
+         * @param batch The batch to detect.
+         * @return The ticket identifying the batch in its completion.
+         */
+        uint64_t submitBatch(std::unique_ptr<DetectionBatch> batch);
+
+        /**
+         * Get the next completion of the submitted batches, in submission order.
+         * @param completion Set to the completion, if any.
+         * @param timeoutMs The maximum time to wait for a completion, in milliseconds. 0 to return immediately.
+         * @return true if a completion has been found, false if not.
+         */
+        bool pollBatchCompletion(BatchCompletion& completion, int64_t timeoutMs);
+
+        [[nodiscard]] DetectionMetrics getMetrics() const;
+
+    private:
+        /**
+         * Tells if a text or number condition must be detected on the current frame.
+         * @param scheduleKey The key of the condition, or of the conditions group.
+         * @param refreshPeriodMs The refresh period hinted for the condition, or 0 to adapt it to its changes.
+         * @param hasLastResult true if the last results of the condition are available. If not, the condition is
+         * always detected.
+         * @return true if the condition must be detected, false if its last result must be served.
+         */
+        bool shouldDetect(uint64_t scheduleKey, int64_t refreshPeriodMs, bool hasLastResult);
+
+        /**
+         * Keeps the last result of a condition, to be served when the condition isn't detected on a frame.
+         * @param conditionKey The key of the condition.
+         * @param result The result of the condition for the current frame.
+         * @return true if the result is different from the previous one, or if there is none.
+         */
+        bool keepLastResult(uint64_t conditionKey, const TextMatchingResult& result);
 
-        TextMatchingResult* detectNumber(const cv::Rect& roi, int threshold, NumberFormat numberFormat);
+        /**
+         * Get the result of a condition not detected on the current frame. Only called when shouldDetect returned
+         * false, the last result of the condition is then always available.
+         * @param conditionKey The key of the condition.
+         * @return The last result of the condition marked as stale.
+         */
+        TextMatchingResult getStaleResult(uint64_t conditionKey);
     };
 }
 
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <opencv2/core/utility.hpp>
+#include <cpu.h>
+
+#include "execution_policy.hpp"
+#include "../logs/log.h"
+
+using namespace smartautoclicker;
+
+ExecutionPolicy::ExecutionPolicy(int threadCount, CoreAffinity coreAffinity) :
+        threadCount(std::max(0, threadCount)),
+        coreAffinity(coreAffinity) {}
+
+int ExecutionPolicy::getThreadCount() const {
+    if (threadCount > 0) return threadCount;
+
+    int coreCount;
+    switch (coreAffinity) {
+        case CoreAffinity::LITTLE: coreCount = ncnn::get_little_cpu_count(); break;
+        case CoreAffinity::BIG: coreCount = ncnn::get_big_cpu_count(); break;
+        default: coreCount = ncnn::get_cpu_count(); break;
+    }
+
+    return std::max(1, coreCount);
+}
+
+CoreAffinity ExecutionPolicy::getCoreAffinity() const {
+    return coreAffinity;
+}
+
+void ExecutionPolicy::bindCurrentThread() const {
+    // Not available on all devices (no little cores, or not an Android build), keep all cores in that case
+    if (ncnn::set_cpu_powersave(static_cast<int>(coreAffinity)) != 0) {
+        LOGW("ExecutionPolicy", "Can't set core affinity %d, using all cores", static_cast<int>(coreAffinity));
+        ncnn::set_cpu_powersave(static_cast<int>(CoreAffinity::ALL));
+    }
+}
+
+ScopedCoreAffinity::ScopedCoreAffinity(CoreAffinity coreAffinity) {
+    if (coreAffinity == CoreAffinity::ALL) return;
+
+    // Empty when the affinity is not available on the device (no little cores, or not an Android build)
+    const ncnn::CpuSet& cores = ncnn::get_cpu_thread_affinity_mask(static_cast<int>(coreAffinity));
+    if (cores.num_enabled() == 0) return;
+
+    if (sched_getaffinity(0, sizeof(previousCores), &previousCores) != 0) return;
+    isBound = sched_setaffinity(0, sizeof(cores.cpu_set), &cores.cpu_set) == 0;
+}
+
+ScopedCoreAffinity::~ScopedCoreAffinity() {
+    if (isBound) sched_setaffinity(0, sizeof(previousCores), &previousCores);
+}
+
+void ExecutionPolicy::applyToThreadPools() const {
+    int threads = getThreadCount();
+    cv::setNumThreads(threads);
+    LOGI("ExecutionPolicy", "Detection running on %d threads, core affinity %d",
+         threads, static_cast<int>(coreAffinity));
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_EXECUTION_POLICY_HPP
+#define KLICK_R_EXECUTION_POLICY_HPP
+
+#include <sched.h>
+
+namespace smartautoclicker {
+
+    /** The CPU cores the detection can run on. Values must match ncnn powersave modes. */
+    enum class CoreAffinity {
+        ALL = 0,
+        LITTLE = 1,
+        BIG = 2,
+    };
+
+    /**
+     * How the detection uses the CPU: the number of threads and the cores they are running on.
+     * The same policy is applied to every thread pool used by the detection (OpenCV and ncnn), so they don't fight
+     * each other for the cores.
+     */
+    class ExecutionPolicy {
+
+    public:
+        ExecutionPolicy() = default;
+
+        /**
+         * @param threadCount The number of threads of the detection, or 0 for the number of cores of the affinity.
+         * @param coreAffinity The cores the detection threads are running on.
+         */
+        ExecutionPolicy(int threadCount, CoreAffinity coreAffinity);
+
+        /** @return The number of threads of the detection, never 0. */
+        int getThreadCount() const;
+
+        CoreAffinity getCoreAffinity() const;
+
+        /**
+         * Binds the calling thread, and the ncnn threads it starts, to the cores of the policy. The binding is kept
+         * for the lifetime of the thread, so this must only be called from the threads owned by the detection, never
+         * from a thread borrowed from the caller.
+         */
+        void bindCurrentThread() const;
+
+        /** Sizes the OpenCV thread pool used for the parallel detection work. Can be called from any thread. */
+        void applyToThreadPools() const;
+
+    private:
+        /** The requested number of threads, 0 for the number of cores of the affinity. */
+        int threadCount = 0;
+        /** The cores the detection threads are running on. Big ones by default, the detection is latency sensitive. */
+        CoreAffinity coreAffinity = CoreAffinity::BIG;
+    };
+
+    /**
+     * Binds the calling thread to the cores of an affinity for the lifetime of the instance, and restores its previous
+     * cores after. Used around the inferences, that run on the detection threads borrowed from the caller.
+     * ncnn is built without OpenMP, an inference runs entirely on the calling thread.
+     */
+    class ScopedCoreAffinity {
+
+    public:
+        explicit ScopedCoreAffinity(CoreAffinity coreAffinity);
+        ~ScopedCoreAffinity();
+
+        ScopedCoreAffinity(const ScopedCoreAffinity&) = delete;
+        ScopedCoreAffinity& operator=(const ScopedCoreAffinity&) = delete;
+
+    private:
+        /** The cores of the thread before the binding. */
+        cpu_set_t previousCores = {};
+        /** true if the thread has been bound, and must be restored. */
+        bool isBound = false;
+    };
+}
+
+#endif //KLICK_R_EXECUTION_POLICY_HPP
@@ -22,29 +22,145 @@
 using namespace smartautoclicker;
 
 
+ScreenImage::ScreenImage() {
+    worker = std::thread(&ScreenImage::runWorker, this);
+}
+
+ScreenImage::~ScreenImage() {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        isWorkerStopping = true;
+    }
+    workerCondition.notify_all();
+    worker.join();
+}
+
 void ScreenImage::processNewData(std::unique_ptr<cv::Mat> newData, const char* metricsTag) {
     if (!newData || newData->empty() || requiresCorrection(metricsTag)) return;
 
-    this->colorMat = std::move(*newData);
-    grayValid = false;
-    hsvValid = false;
+    // The worker might still be reading the previous frame
+    waitForPreparation();
+
+    // Write the new frame in the other slot, keeping the derived images buffers of each slot for reuse
+    size_t previousIndex = currentFrameIndex.load();
+    size_t newIndex = 1 - previousIndex;
+    Frame& frame = frames[newIndex];
+    frame.colorMat = std::move(*newData);
+    frame.isGrayValid = false;
+    frame.isHsvValid = false;
+    frames[previousIndex].colorMat = cv::Mat();
+    currentFrameIndex.store(newIndex);
+
+    // Conditions are the same on each frame, prepare the derived images used by the previous one
+    if (isGrayUsed || isHsvUsed) {
+        {
+            std::lock_guard<std::mutex> lock(workerMutex);
+            pendingFrame = &frame;
+            isGrayRequested = isGrayUsed;
+            isHsvRequested = isHsvUsed;
+        }
+        workerCondition.notify_all();
+    }
+    isGrayUsed = false;
+    isHsvUsed = false;
+}
+
+void ScreenImage::releaseData() {
+    waitForPreparation();
+    frames[currentFrameIndex.load()].colorMat = cv::Mat();
+}
+
+void ScreenImage::setExecutionPolicy(const ExecutionPolicy& policy) {
+    {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        workerPolicy = policy;
+        isWorkerPolicyChanged = true;
+    }
+    workerCondition.notify_all();
 }
 
 cv::Mat ScreenImage::cropColor(const cv::Rect &roi) const {
-    if (this->colorMat.empty()) return {};
-    return cropMat(this->colorMat, roi);
+    // The color image is never modified by the worker, no need to wait for it
+    const cv::Mat& colorMat = frames[currentFrameIndex.load()].colorMat;
+    if (colorMat.empty()) return {};
+    return cropMat(colorMat, roi);
 }
 
 cv::Mat ScreenImage::cropGray(const cv::Rect &roi) const {
-    const cv::Mat& gray = getGrayMat();
-    if (gray.empty()) return {};
-    return cropMat(gray, roi);
+    Frame& frame = getPreparedFrame();
+    if (frame.colorMat.empty()) return {};
+
+    isGrayUsed = true;
+    if (!frame.isGrayValid) convertToGray(frame);
+    return cropMat(frame.grayMat, roi);
 }
 
 cv::Mat ScreenImage::cropHsv(const cv::Rect &roi) const {
-    const cv::Mat& hsv = getHsvMat();
-    if (hsv.empty()) return {};
-    return cropMat(hsv, roi);
+    Frame& frame = getPreparedFrame();
+    if (frame.colorMat.empty()) return {};
+
+    isHsvUsed = true;
+    if (!frame.isHsvValid) convertToHsv(frame);
+    return cropMat(frame.hsvMat, roi);
+}
+
+cv::Rect ScreenImage::getRoi() const {
+    const cv::Mat& colorMat = frames[currentFrameIndex.load()].colorMat;
+    return {0, 0, colorMat.cols, colorMat.rows};
+}
+
+bool ScreenImage::empty() const {
+    return frames[currentFrameIndex.load()].colorMat.empty();
+}
+
+void ScreenImage::runWorker() {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    while (true) {
+        workerCondition.wait(lock, [this]() {
+            return pendingFrame != nullptr || isWorkerPolicyChanged || isWorkerStopping;
+        });
+        if (isWorkerStopping) return;
+
+        if (isWorkerPolicyChanged) {
+            workerPolicy.bindCurrentThread();
+            isWorkerPolicyChanged = false;
+        }
+        if (pendingFrame == nullptr) continue;
+
+        // The detection thread doesn't touch the derived images of the pending frame until notified
+        Frame& frame = *pendingFrame;
+        bool isGrayNeeded = isGrayRequested;
+        bool isHsvNeeded = isHsvRequested;
+        lock.unlock();
+
+        if (isGrayNeeded) convertToGray(frame);
+        if (isHsvNeeded) convertToHsv(frame);
+
+        lock.lock();
+        pendingFrame = nullptr;
+        workerCondition.notify_all();
+    }
+}
+
+void ScreenImage::waitForPreparation() const {
+    std::unique_lock<std::mutex> lock(workerMutex);
+    workerCondition.wait(lock, [this]() { return pendingFrame == nullptr; });
+}
+
+ScreenImage::Frame& ScreenImage::getPreparedFrame() const {
+    waitForPreparation();
+    return frames[currentFrameIndex.load()];
+}
+
+void ScreenImage::convertToGray(Frame& frame) {
+    cv::cvtColor(frame.colorMat, frame.grayMat, cv::COLOR_RGBA2GRAY);
+    frame.isGrayValid = true;
+}
+
+void ScreenImage::convertToHsv(Frame& frame) {
+    cv::cvtColor(frame.colorMat, frame.rgbBuffer, cv::COLOR_RGBA2RGB);
+    cv::cvtColor(frame.rgbBuffer, frame.hsvMat, cv::COLOR_RGB2HSV);
+    frame.isHsvValid = true;
 }
 
 cv::Mat ScreenImage::cropMat(const cv::Mat& mat, const cv::Rect& roi) {
@@ -19,21 +19,114 @@
 #ifndef KLICK_R_SCREEN_IMAGE_HPP
 #define KLICK_R_SCREEN_IMAGE_HPP
 
-#include "detection_image.hpp"
+#include <opencv2/core.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "../execution_policy.hpp"
 
 namespace smartautoclicker {
 
-    class ScreenImage : public DetectionImage {
-
-    private:
-        static cv::Mat cropMat(const cv::Mat& mat, const cv::Rect& roi);
+    /**
+     * The content of the screen, and the images derived from it for the matchers.
+     *
+     * Frames are stored in a two slots ring, with their own derived images buffers. When a new frame is set, it is
+     * written in the other slot and becomes the current one with an atomic swap. A background worker then converts
+     * it into the derived images the matchers requested on the previous frame (gray, HSV), while the matchers that
+     * only needs the color image run on the detection thread. Matchers requesting a derived image wait for its
+     * preparation, or convert it themselves if it hasn't been requested.
+     */
+    class ScreenImage {
 
     public:
+        ScreenImage();
+        ~ScreenImage();
+
+        ScreenImage(const ScreenImage&) = delete;
+        ScreenImage& operator=(const ScreenImage&) = delete;
+
+        /**
+         * Set the new content of the screen, and starts the preparation of its derived images in background.
+         * @param newData The RGBA screen image. Its pixels must stay valid until releaseData is called.
+         * @param metricsTag The tag for the metrics of this frame.
+         */
         void processNewData(std::unique_ptr<cv::Mat> newData, const char* metricsTag);
 
+        /** Waits for the background preparation of the current frame, its pixels can then be released. */
+        void releaseData();
+
+        /**
+         * Set how the background worker uses the CPU, applied before its next preparation.
+         * @param policy The execution policy of the detection.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
         [[nodiscard]] cv::Mat cropColor(const cv::Rect& roi) const;
         [[nodiscard]] cv::Mat cropGray(const cv::Rect& roi) const;
         [[nodiscard]] cv::Mat cropHsv(const cv::Rect& roi) const;
+        [[nodiscard]] cv::Rect getRoi() const;
+        [[nodiscard]] bool empty() const;
+
+    private:
+        /** A slot of the frames ring. */
+        struct Frame {
+            /** The RGBA screen image, a view on the screen bitmap. */
+            cv::Mat colorMat;
+            /** Gray conversion of the color image, valid if isGrayValid is true. */
+            cv::Mat grayMat;
+            bool isGrayValid = false;
+            /** HSV conversion of the color image, valid if isHsvValid is true. */
+            cv::Mat hsvMat;
+            bool isHsvValid = false;
+            /** Reusable buffer for the RGB conversion, required for the HSV conversion. */
+            cv::Mat rgbBuffer;
+        };
+
+        /** The frames ring. Derived images are converted lazily, from const methods. */
+        mutable std::array<Frame, 2> frames;
+        /** Index of the current frame in the ring. */
+        std::atomic<size_t> currentFrameIndex = 0;
+
+        /** true if the gray image of the current frame has been requested by a matcher. */
+        mutable bool isGrayUsed = false;
+        /** true if the HSV image of the current frame has been requested by a matcher. */
+        mutable bool isHsvUsed = false;
+
+        /** Converts the frames into their derived images in background. */
+        std::thread worker;
+        /** Protects the worker requests below. */
+        mutable std::mutex workerMutex;
+        /** Notified when a preparation is requested, and when it is done. */
+        mutable std::condition_variable workerCondition;
+        /** The frame to prepare, or nullptr if the worker is idle. */
+        Frame* pendingFrame = nullptr;
+        /** true to prepare the gray image of the pending frame. */
+        bool isGrayRequested = false;
+        /** true to prepare the HSV image of the pending frame. */
+        bool isHsvRequested = false;
+        /** true to stop the worker. */
+        bool isWorkerStopping = false;
+        /** The execution policy to apply to the worker thread. */
+        ExecutionPolicy workerPolicy;
+        /** true if the workerPolicy must be applied. */
+        bool isWorkerPolicyChanged = true;
+
+        /** Worker thread loop, preparing the requested frames until stopped. */
+        void runWorker();
+
+        /** Waits until the worker has prepared the pending frame, if any. */
+        void waitForPreparation() const;
+
+        /** @return the current frame, once its background preparation is done. */
+        Frame& getPreparedFrame() const;
+
+        static void convertToGray(Frame& frame);
+        static void convertToHsv(Frame& frame);
+        static cv::Mat cropMat(const cv::Mat& mat, const cv::Rect& roi);
     };
 }
 
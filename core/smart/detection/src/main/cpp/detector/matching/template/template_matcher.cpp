@@ -26,6 +26,10 @@
 using namespace smartautoclicker;
 
 
+void TemplateMatcher::setCancellationToken(const CancellationToken* token) {
+    cancellationToken = token;
+}
+
 void TemplateMatcher::reset() {
     currentMatchingResult.reset();
 }
@@ -78,12 +82,22 @@ void TemplateMatcher::matchTemplate(
             CV_32F);
 
     try {
-        // Run OpenCv template matching
-        cv::matchTemplate(
-                screenCroppedGrayMat,
-                condition.getGrayMat(),
-                newResultsMat,
-                cv::TM_CCOEFF_NORMED);
+        // Run OpenCv template matching. Very large areas are split into horizontal stripes, allowing to stop between
+        // them. Each result only depends on the screen pixels below the condition at its position, so the stripes
+        // results are the same. Each stripe reads the condition height again, so typical areas are not split.
+        const cv::Mat& conditionGrayMat = condition.getGrayMat();
+        int rowsPerCall = newResultsMat.rows <= maxSingleMatchRows ? newResultsMat.rows : stripeRows;
+        for (int row = 0; row < newResultsMat.rows; row += rowsPerCall) {
+            if (CancellationToken::isCancelled(cancellationToken)) return;
+
+            int rows = std::min(rowsPerCall, newResultsMat.rows - row);
+            cv::Mat stripeResultsMat = newResultsMat.rowRange(row, row + rows);
+            cv::matchTemplate(
+                    screenCroppedGrayMat.rowRange(row, row + rows + conditionGrayMat.rows - 1),
+                    conditionGrayMat,
+                    stripeResultsMat,
+                    cv::TM_CCOEFF_NORMED);
+        }
     } catch (const cv::Exception& e) {
         LOGE("TemplateMatcher", "OpenCV Exception caught: %s", e.what());
         throw;
@@ -107,7 +121,7 @@ void TemplateMatcher::parseMatchingResult(
         cv::Mat& matchingResult
 ) {
 
-    while (!currentMatchingResult.isDetected()) {
+    while (!currentMatchingResult.isDetected() && !CancellationToken::isCancelled(cancellationToken)) {
 
         // Mark previous results as invalid, if any
         if (!currentMatchingResult.getResultArea().empty()) {
@@ -20,6 +20,7 @@
 
 #include <opencv2/core/types.hpp>
 
+#include "../../cancellation_token.hpp"
 #include "../../images/condition_image.hpp"
 #include "../../images/screen_image.hpp"
 #include "template_matching_result.hpp"
@@ -29,7 +30,17 @@ namespace smartautoclicker {
     class TemplateMatcher {
 
     private:
+        /**
+         * Maximum number of result rows matched in a single call. Above, only reached with the highest detection
+         * qualities, the matching is split into stripes to allow its cancellation.
+         */
+        static constexpr int maxSingleMatchRows = 2048;
+        /** Number of result rows of each stripe of a split matching. */
+        static constexpr int stripeRows = 1024;
+
         TemplateMatchingResult currentMatchingResult;
+        /** Checked before the matching and between its stripes. Can be nullptr. */
+        const CancellationToken* cancellationToken = nullptr;
 
         void parseMatchingResult(
                 const ScreenImage& screenImage,
@@ -42,6 +53,12 @@ namespace smartautoclicker {
         static double getColorDiff(const cv::Mat& hsvImage, const cv::Scalar& conditionHsvMean);
 
     public:
+        /**
+         * Set the token cancelling the matching.
+         * @param token The token, or nullptr to never cancel.
+         */
+        void setCancellationToken(const CancellationToken* token);
+
         void reset();
         static bool isRoiValidForMatching(
                 const cv::Rect& screenRoi,
@@ -16,6 +16,10 @@
  */
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/imgproc/imgproc_c.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
 
 #include "text_detector.hpp"
 #include "../text_matcher_debugger.hpp"
@@ -23,76 +27,164 @@
 
 using namespace smartautoclicker;
 
-bool TextDetector::init(const std::string& modelPath) {
+bool TextDetector::init(const std::string& modelPath, bool warmUp, InferencePrecision precision) {
+    // Release the previous model before its bundle
+    ncnnDetector->clear();
+    bundle.close();
 
-    std::string paramPath = modelPath + "/det.ncnn.param";
-    std::string binPath = modelPath + "/det.ncnn.bin";
+    // Intermediate blobs are allocated from the tiles pools, don't let each extractor create its own pools
+    ncnnDetector->opt.use_local_pool_allocator = false;
 
-    int paramResult = ncnnDetector->load_param(paramPath.c_str());
-    int binResult = ncnnDetector->load_model(binPath.c_str());
+    auto loadingStart = std::chrono::steady_clock::now();
+    std::string filesPath = getModelFilesPath(modelPath, "det", precision);
+    applyInferencePrecision(precision, ncnnDetector->opt);
 
-    if (paramResult != 0 || binResult != 0) {
+    std::string bundlePath = filesPath + ".ncnn.bundle";
+    bool isBundle = ModelBundle::exists(bundlePath);
+    if (!(isBundle ? loadModelBundle(bundlePath) : loadModelFiles(filesPath))) {
         LOGE("TextDetector", "Can't load detection model from %s", modelPath.c_str());
         isInitialized = false;
         return false;
     }
 
+    auto loadingMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - loadingStart).count();
+    LOGI("TextDetector", "Detection model loaded in %lldms from %s, precision %d",
+         static_cast<long long>(loadingMs), isBundle ? "bundle" : "files", static_cast<int>(precision));
+
+    if (warmUp) this->warmUp();
+
     isInitialized = true;
     return true;
 }
 
-std::vector<TextDetectorResult> TextDetector::detectText(const cv::Mat& rgbScreenCrop) {
-    // Resize screen image for optimal detection
-    cv::Size resizedSize = getDetectionSize(rgbScreenCrop);
-    cv::Mat resized;
-    cv::resize(rgbScreenCrop, resized,cv::Size(resizedSize.width, resizedSize.height));
+void TextDetector::warmUp() {
+    auto warmUpStart = std::chrono::steady_clock::now();
 
-    // Pad the resized image, multiple of 32 required by PaddleOCR detector
-    cv::Size paddedSize = getDetectionPaddedSize(resizedSize);
-    cv::Mat padded = cv::Mat::zeros(paddedSize.height,paddedSize.width,CV_8UC3);
-    resized.copyTo(padded(cv::Rect(0,0,resizedSize.width, resizedSize.height)));
+    if (tilesBuffers.empty()) tilesBuffers.push_back(std::make_unique<TileBuffers>());
+    TileBuffers& buffers = *tilesBuffers.front();
 
-    // Run text detection
-    ncnn::Mat detectionOutput;
-    detectText(padded, detectionOutput);
-    if (detectionOutput.empty()) return {};
+    // Normalized blank image, already a multiple of 32
+    buffers.input.create(maxSize, maxSize, 3);
+    buffers.input.fill(0.f);
+    detectText(buffers);
+    buffers.output.release();
 
-    // Process results and get the textboxes
-    cv::Mat scoreMap(detectionOutput.h, detectionOutput.w, CV_32FC1, (void*)detectionOutput.data);
-    cv::Mat binaryResults = processDetectionOutput(scoreMap);
-    auto contours = findContours(binaryResults);
-    LOGD("TextDetector", "Contours found: %zu", contours.size());
+    warmUpDurationMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - warmUpStart).count();
+    LOGI("TextDetector", "Detection model warmed up in %llums", static_cast<unsigned long long>(warmUpDurationMs));
+}
+
+bool TextDetector::loadModelFiles(const std::string& filesPath) {
+    std::string paramPath = filesPath + ".ncnn.param";
+    std::string binPath = filesPath + ".ncnn.bin";
+
+    int paramResult = ncnnDetector->load_param(paramPath.c_str());
+    int binResult = ncnnDetector->load_model(binPath.c_str());
+    return paramResult == 0 && binResult == 0;
+}
+
+bool TextDetector::loadModelBundle(const std::string& bundlePath) {
+    if (!bundle.open(bundlePath)) return false;
+
+    if (ncnnDetector->load_param_mem(bundle.getParams()) != 0 || ncnnDetector->load_model(bundle.getWeights()) <= 0) {
+        ncnnDetector->clear();
+        bundle.close();
+        return false;
+    }
+
+    return true;
+}
+
+std::vector<TextDetectorResult> TextDetector::detectText(const cv::Mat& screenCrop, float expectedTextHeight) {
+    lastTextHeight = 0.f;
+
+    // Skip the whole detection process if there is obviously no text
+    if (!presenceFilter.mayContainText(screenCrop)) return {};
+
+    // Resize screen image for optimal detection, and split it into tiles if it is too big for a single inference
+    cv::Size resizedSize = getDetectionSize(screenCrop, expectedTextHeight);
+    getTiles(resizedSize, tiles);
+    while (tilesBuffers.size() < tiles.size()) tilesBuffers.push_back(std::make_unique<TileBuffers>());
 
     // Scaling factor for detection -> original.
-    float scaleX = static_cast<float>(rgbScreenCrop.cols) / static_cast<float>(resizedSize.width);
-    float scaleY = static_cast<float>(rgbScreenCrop.rows) / static_cast<float>(resizedSize.height);
+    float scaleX = static_cast<float>(screenCrop.cols) / static_cast<float>(resizedSize.width);
+    float scaleY = static_cast<float>(screenCrop.rows) / static_cast<float>(resizedSize.height);
+
+    // Run text detection, each tile having its own extractor and buffers
+    if (tiles.size() == 1) {
+        detectTile(screenCrop, tiles.front(), scaleX, scaleY, *tilesBuffers.front());
+    } else {
+        // The tiles are already spread over the policy threads, a multi-threaded inference per tile would start a
+        // thread team per tile on the same cores. The extractors copy the options when created.
+        int threadCount = ncnnDetector->opt.num_threads;
+        ncnnDetector->opt.num_threads = 1;
+        cv::parallel_for_(cv::Range(0, static_cast<int>(tiles.size())), [&](const cv::Range& range) {
+            for (int i = range.start; i < range.end; i++) {
+                if (CancellationToken::isCancelled(cancellationToken)) return;
+                detectTile(screenCrop, tiles[i], scaleX, scaleY, *tilesBuffers[i]);
+            }
+        });
+        ncnnDetector->opt.num_threads = threadCount;
+    }
+    if (CancellationToken::isCancelled(cancellationToken)) return {};
+
+    // Gather the text components of all tiles
+    std::vector<cv::Rect> componentBoxes;
+    std::vector<float> componentScores;
+    mergeTilesComponents(tiles.size(), componentBoxes, componentScores);
+    lastTextHeight = computeTextHeight(componentBoxes, scaleX, scaleY);
+    LOGD("TextDetector", "Detection size %dx%d in %zu tiles, expected text height %f, found %f",
+         resizedSize.width, resizedSize.height, tiles.size(), expectedTextHeight, lastTextHeight);
 
-    // Remove irrelevant results
-    auto filteredContours = filterContours(contours, scoreMap, resizedSize);
     // Get bounding boxes in original coordinates
-    auto boundingBoxes = getBoundingBoxes(filteredContours, rgbScreenCrop, resizedSize, scaleX, scaleY);
+    auto boundingBoxes = getBoundingBoxes(componentBoxes, componentScores, screenCrop, resizedSize, scaleX, scaleY);
     // Format output results
-    auto results = formatResults(rgbScreenCrop, boundingBoxes);
+    auto results = formatResults(screenCrop, boundingBoxes);
 
     // Debugging (does nothing in release builds)
-    saveScoreMap(scoreMap);
-    saveBinaryMap(binaryResults);
-    saveVisualDebug(rgbScreenCrop, contours, scaleX, scaleY);
+    saveVisualDebug(screenCrop, componentBoxes, scaleX, scaleY);
     saveCrops(results);
 
     return results;
 }
 
-cv::Size TextDetector::getDetectionSize(const cv::Mat& rgbCondition) {
-    int width = rgbCondition.cols;
-    int height = rgbCondition.rows;
+void TextDetector::collectMetrics(DetectionMetrics& metrics) const {
+    metrics.textPrefilterRejections = presenceFilter.getRejectedCount();
+    metrics.detectionWarmUpMs = warmUpDurationMs;
+}
+
+void TextDetector::setExecutionPolicy(const ExecutionPolicy& policy) {
+    ncnnDetector->opt.num_threads = policy.getThreadCount();
+    coreAffinity = policy.getCoreAffinity();
+}
+
+void TextDetector::setCancellationToken(const CancellationToken* token) {
+    cancellationToken = token;
+}
+
+cv::Size TextDetector::getDetectionSize(const cv::Mat& screenCrop, float expectedTextHeight) {
+    int width = screenCrop.cols;
+    int height = screenCrop.rows;
     int maxSide = std::max(width, height);
 
+    // Bring the text to the size the model prefers, big text is detected at a lower resolution, small text can use
+    // the tiles up to maxTiledSize. Without any hint, keep the single inference size until the text height is known.
+    float scale = 1.f;
+    int maxDetectionSide = maxSize;
+    if (expectedTextHeight > 0.f) {
+        scale = std::min(1.f, targetTextHeight / expectedTextHeight);
+        maxDetectionSide = maxTiledSize;
+    }
+
     // Scale down if needed
-    if (maxSide > maxSize) {
-        float scale = static_cast<float>(maxSize) / static_cast<float>(maxSide);
-        width = static_cast<int>(static_cast<float>(width) * scale);
-        height = static_cast<int>(static_cast<float>(height) * scale);
+    if (static_cast<float>(maxSide) * scale > static_cast<float>(maxDetectionSide)) {
+        scale = static_cast<float>(maxDetectionSide) / static_cast<float>(maxSide);
+    }
+
+    if (scale < 1.f) {
+        width = std::max(1, static_cast<int>(static_cast<float>(width) * scale));
+        height = std::max(1, static_cast<int>(static_cast<float>(height) * scale));
     }
 
     return { width, height };
@@ -106,65 +198,164 @@ cv::Size TextDetector::getDetectionPaddedSize(const cv::Size& detectionSize) {
     };
 }
 
-void TextDetector::detectText(const cv::Mat &paddedRgb, ncnn::Mat& output) const {
-    // Create ncnn input mat
-    ncnn::Mat input = ncnn::Mat::from_pixels(
-            paddedRgb.data,
-            ncnn::Mat::PIXEL_RGB,
-            paddedRgb.cols,
-            paddedRgb.rows);
+void TextDetector::getTiles(const cv::Size& resizedSize, std::vector<cv::Rect>& tiles) {
+    tiles.clear();
+
+    if (resizedSize.width <= maxSize && resizedSize.height <= maxSize) {
+        tiles.emplace_back(0, 0, resizedSize.width, resizedSize.height);
+        return;
+    }
+
+    int columns = getTileCount(resizedSize.width);
+    int rows = getTileCount(resizedSize.height);
+    for (int row = 0; row < rows; row++) {
+        cv::Range rowRange = getTileRange(resizedSize.height, rows, row);
+
+        for (int column = 0; column < columns; column++) {
+            cv::Range columnRange = getTileRange(resizedSize.width, columns, column);
+            tiles.emplace_back(columnRange.start, rowRange.start, columnRange.size(), rowRange.size());
+        }
+    }
+}
+
+int TextDetector::getTileCount(int length) {
+    if (length <= tileSize) return 1;
+    return (length - tileOverlap + tileSize - tileOverlap - 1) / (tileSize - tileOverlap);
+}
+
+cv::Range TextDetector::getTileRange(int length, int tileCount, int tileIndex) {
+    if (tileCount == 1) return { 0, length };
+
+    // First tile starts at 0, last one ends at the length, the others are spread evenly in between
+    int start = static_cast<int>(std::lround(
+            static_cast<double>(length - tileSize) * tileIndex / (tileCount - 1)));
+    return { start, start + tileSize };
+}
+
+void TextDetector::detectTile(
+        const cv::Mat& screenCrop,
+        const cv::Rect& tile,
+        float scaleX,
+        float scaleY,
+        TileBuffers& buffers) const
+{
+    buffers.boxes.clear();
+    buffers.scores.clear();
+
+    // Area of the screen crop covered by the tile
+    int left = static_cast<int>(std::floor(static_cast<float>(tile.x) * scaleX));
+    int top = static_cast<int>(std::floor(static_cast<float>(tile.y) * scaleY));
+    int right = std::min(screenCrop.cols, static_cast<int>(std::ceil(static_cast<float>(tile.br().x) * scaleX)));
+    int bottom = std::min(screenCrop.rows, static_cast<int>(std::ceil(static_cast<float>(tile.br().y) * scaleY)));
+    if (right <= left || bottom <= top) return;
+
+    // Resize the tile area, and pad it to a multiple of 32 as required by PaddleOCR detector.
+    // Both are made while building the network input, in a single pass over the crop.
+    cv::Size resizedTileSize = tile.size();
+    cv::Size paddedSize = getDetectionPaddedSize(resizedTileSize);
+    bool isInputBuilt = buffers.inputBuilder.build(
+            screenCrop(cv::Rect(left, top, right - left, bottom - top)),
+            resizedTileSize,
+            0,
+            paddedSize,
+            meanVals,
+            normVals,
+            buffers.input);
+    if (!isInputBuilt) return;
+
+    // Run text detection
+    detectText(buffers);
+    const ncnn::Mat& detectionOutput = buffers.output;
+    if (detectionOutput.empty()) return;
 
-    // Normalize
-    input.substract_mean_normalize(meanVals, normVals);
+    // Process results and get the text components, with their bounding box and scores, in a single labelling pass
+    cv::Mat scoreMap(detectionOutput.h, detectionOutput.w, CV_32FC1, (void*)detectionOutput.data);
+    processDetectionOutput(scoreMap, buffers);
+    int componentCount = findComponents(scoreMap, buffers);
+    LOGD("TextDetector", "Components found in tile (%d, %d): %d", tile.x, tile.y, componentCount);
+
+    // Remove irrelevant results, and place the remaining ones in the whole detection area
+    filterComponents(componentCount, resizedTileSize, buffers);
+    for (auto& box : buffers.boxes) {
+        box.x += tile.x;
+        box.y += tile.y;
+    }
 
-    // Inference
+    // Debugging (does nothing in release builds)
+    if (tile.x == 0 && tile.y == 0) {
+        saveScoreMap(scoreMap);
+        saveBinaryMap(buffers.binary);
+    }
+}
+
+void TextDetector::detectText(TileBuffers& buffers) const {
+    // Give back the previous output to the pool, it will most likely be reused for this inference
+    buffers.output.release();
+
+    // Inference, all intermediate blobs are taken from the tile pools
     ncnn::Extractor extractor = ncnnDetector->create_extractor();
-    extractor.input("in0", input);
+    extractor.set_blob_allocator(&buffers.blobAllocator);
+    extractor.set_workspace_allocator(&buffers.workspaceAllocator);
+    extractor.input("in0", buffers.input);
 
-    int result = extractor.extract("out0", output);
+    ScopedCoreAffinity affinity(coreAffinity);
+    int result = extractor.extract("out0", buffers.output);
     if (result != 0) {
         LOGE("TextDetector", "Inference failed");
+        buffers.output.release();
         return;
     }
 }
 
-cv::Mat TextDetector::processDetectionOutput(const cv::Mat& scoreMap) {
-    // Convert to OpenCv format
-    cv::Mat binary;
-
+void TextDetector::processDetectionOutput(const cv::Mat& scoreMap, TileBuffers& buffers) const {
     // Thresholding - lowered slightly to help join character fragments
-    cv::threshold(scoreMap, binary, 0.3f, 1.0f, cv::THRESH_BINARY);
-    binary.convertTo(binary, CV_8UC1, 255);
+    // Directly produces the 8 bits binary map, without the intermediate float one.
+    cv::compare(scoreMap, 0.3, buffers.binary, cv::CMP_GT);
 
     // Morphology Close - joins disconnected parts of the same word/character
-    cv::morphologyEx(binary, binary, cv::MORPH_CLOSE, kernelClose);
+    cv::morphologyEx(buffers.binary, buffers.binary, cv::MORPH_CLOSE, kernelClose);
 
     // Dilation - Smear horizontally to merge words into full sentences/lines
     // We use a wider kernel horizontally (30) than vertically (3) to avoid merging separate lines.
-    cv::dilate(binary, binary, kernelVertical);
-    cv::dilate(binary, binary, kernelDilate);
-
-    return binary;
+    cv::dilate(buffers.binary, buffers.binary, kernelVertical);
+    cv::dilate(buffers.binary, buffers.binary, kernelDilate);
 }
 
-std::vector<std::vector<cv::Point>> TextDetector::findContours(const cv::Mat& binaryResults) {
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binaryResults, contours,cv::RETR_EXTERNAL,cv::CHAIN_APPROX_SIMPLE);
+int TextDetector::findComponents(const cv::Mat& scoreMap, TileBuffers& buffers) {
+    // 8-connectivity, like the external contours of a component
+    int labelCount = cv::connectedComponentsWithStats(
+            buffers.binary, buffers.labels, buffers.stats, buffers.centroids, 8, CV_32S);
 
-    return contours;
-}
+    // Accumulate the scores of each component in a single pass over the map. Label 0 is the background.
+    buffers.componentScoreSums.assign(labelCount, 0.);
+    buffers.componentMaxScores.assign(labelCount, 0.f);
+    for (int y = 0; y < buffers.labels.rows; y++) {
+        const int* labels = buffers.labels.ptr<int>(y);
+        const float* scores = scoreMap.ptr<float>(y);
 
-std::vector<std::vector<cv::Point>> TextDetector::filterContours(
-        const std::vector<std::vector<cv::Point>>& contours,
-        const cv::Mat& scoreMap,
-        const cv::Size& resizedSize)
-{
+        for (int x = 0; x < buffers.labels.cols; x++) {
+            const int label = labels[x];
+            if (label == 0) continue;
+
+            buffers.componentScoreSums[label] += scores[x];
+            if (scores[x] > buffers.componentMaxScores[label]) buffers.componentMaxScores[label] = scores[x];
+        }
+    }
+
+    return labelCount - 1;
+}
 
-    std::vector<std::vector<cv::Point>> filtered;
-    filtered.reserve(contours.size());
+void TextDetector::filterComponents(int componentCount, const cv::Size& resizedSize, TileBuffers& buffers) {
+    buffers.boxes.reserve(componentCount);
+    buffers.scores.reserve(componentCount);
 
-    for (const auto& contour : contours) {
-        cv::Rect box = cv::boundingRect(contour);
+    for (int label = 1; label <= componentCount; label++) {
+        const int* stats = buffers.stats.ptr<int>(label);
+        cv::Rect box(
+                stats[cv::CC_STAT_LEFT],
+                stats[cv::CC_STAT_TOP],
+                stats[cv::CC_STAT_WIDTH],
+                stats[cv::CC_STAT_HEIGHT]);
 
         // Geometry Check
         auto w = static_cast<float>(box.width);
@@ -175,50 +366,143 @@ std::vector<std::vector<cv::Point>> TextDetector::filterContours(
         // Boundary Check (reject boxes entirely in padding)
         if (box.x >= resizedSize.width || box.y >= resizedSize.height) continue;
 
-        // Expand slightly (important for game UI text edges)
-        const int marginX = 2;
-        const int marginY = 5;
-        box.x = std::max(0, box.x - marginX);
-        box.y = std::max(0, box.y - marginY);
-        box.width  = std::min(scoreMap.cols - box.x, box.width  + 2 * marginX);
-        box.height = std::min(scoreMap.rows - box.y, box.height + 2 * marginY);
+        // Confidence Check
+        if (buffers.componentMaxScores[label] < 0.5f) continue;
 
-        // ROI views
-        cv::Mat scoreROI = scoreMap(box);
-        cv::Mat maskROI = cv::Mat::zeros(scoreROI.size(), CV_8UC1);
+        buffers.boxes.push_back(box);
+        buffers.scores.push_back(static_cast<float>(buffers.componentScoreSums[label] / stats[cv::CC_STAT_AREA]));
+    }
+}
+
+void TextDetector::mergeTilesComponents(
+        size_t tileCount,
+        std::vector<cv::Rect>& boxes,
+        std::vector<float>& scores) const
+{
+    boxes.clear();
+    scores.clear();
+
+    // Index of the first component of each tile in the gathered ones
+    std::vector<size_t> tilesStarts;
+    tilesStarts.reserve(tileCount + 1);
+    for (size_t tile = 0; tile < tileCount; tile++) {
+        const TileBuffers& buffers = *tilesBuffers[tile];
+        tilesStarts.push_back(boxes.size());
+        boxes.insert(boxes.end(), buffers.boxes.begin(), buffers.boxes.end());
+        scores.insert(scores.end(), buffers.scores.begin(), buffers.scores.end());
+    }
+    tilesStarts.push_back(boxes.size());
+    if (tileCount < 2 || boxes.empty()) return;
+
+    // Each component is in its own group, until it is merged with the one of another tile
+    std::vector<size_t> groups(boxes.size());
+    std::iota(groups.begin(), groups.end(), 0);
+    auto findGroup = [&groups](size_t index) {
+        while (groups[index] != index) index = groups[index] = groups[groups[index]];
+        return index;
+    };
+
+    // A text on a tile seam is found in both tiles, and the two parts intersects in the tiles overlap.
+    // Only the components crossing the overlap of two neighbour tiles are compared.
+    std::vector<size_t> firstSeamComponents;
+    std::vector<size_t> secondSeamComponents;
+    auto getSeamComponents = [&](size_t tile, const cv::Rect& overlap, std::vector<size_t>& seamComponents) {
+        seamComponents.clear();
+        for (size_t i = tilesStarts[tile]; i < tilesStarts[tile + 1]; i++) {
+            if (!(boxes[i] & overlap).empty()) seamComponents.push_back(i);
+        }
+    };
+
+    for (size_t first = 0; first < tileCount; first++) {
+        for (size_t second = first + 1; second < tileCount; second++) {
+            cv::Rect overlap = tiles[first] & tiles[second];
+            if (overlap.empty()) continue;
+
+            getSeamComponents(first, overlap, firstSeamComponents);
+            if (firstSeamComponents.empty()) continue;
+            getSeamComponents(second, overlap, secondSeamComponents);
 
-        // Shift contour into ROI space
-        std::vector<cv::Point> shifted;
-        shifted.reserve(contour.size());
-        for (const auto& p : contour) shifted.emplace_back(p.x - box.x, p.y - box.y);
+            for (size_t i : firstSeamComponents) {
+                for (size_t j : secondSeamComponents) {
+                    if ((boxes[i] & boxes[j]).empty()) continue;
 
-        std::vector<std::vector<cv::Point>> poly = { shifted };
-        cv::fillPoly(maskROI, poly, cv::Scalar(255));
+                    // The group is identified by its first component, merged into it below
+                    size_t groupI = findGroup(i);
+                    size_t groupJ = findGroup(j);
+                    groups[std::max(groupI, groupJ)] = std::min(groupI, groupJ);
+                }
+            }
+        }
+    }
 
-        double maxScore;
-        cv::minMaxLoc(scoreROI, nullptr, &maxScore);
-        if (maxScore  < 0.5) continue;
+    // Merge each group into its first component, the score is weighted by the area of each part
+    std::vector<float> groupsAreas(boxes.size(), 0.f);
+    size_t mergedCount = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        size_t group = findGroup(i);
+        auto area = static_cast<float>(boxes[i].area());
 
-        filtered.push_back(contour);
+        if (group == i) {
+            groupsAreas[i] = area;
+            continue;
+        }
+
+        float groupArea = groupsAreas[group];
+        scores[group] = (scores[group] * groupArea + scores[i] * area) / std::max(1.f, groupArea + area);
+        groupsAreas[group] = groupArea + area;
+        boxes[group] |= boxes[i];
+        mergedCount++;
+    }
+    if (mergedCount == 0) return;
+
+    // Keep only the merged groups, in place
+    size_t kept = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        if (findGroup(i) != i) continue;
+        boxes[kept] = boxes[i];
+        scores[kept] = scores[i];
+        kept++;
     }
+    boxes.resize(kept);
+    scores.resize(kept);
+}
 
-    return filtered;
+float TextDetector::computeTextHeight(const std::vector<cv::Rect>& boxes, float scaleX, float scaleY) {
+    if (boxes.empty()) return 0.f;
+
+    // The dilations grows each component on both sides, remove them to get the text height.
+    // The width is the text height for vertical texts.
+    const int dilationHeight = kernelVertical.rows - 1;
+    const int dilationWidth = kernelDilate.cols - 1;
+    textHeightsBuffer.clear();
+    for (const auto& box : boxes) {
+        if (box.height > box.width) {
+            textHeightsBuffer.push_back(static_cast<float>(std::max(1, box.width - dilationWidth)) * scaleX);
+        } else {
+            textHeightsBuffer.push_back(static_cast<float>(std::max(1, box.height - dilationHeight)) * scaleY);
+        }
+    }
+
+    auto median = textHeightsBuffer.begin() + static_cast<long>(textHeightsBuffer.size() / 2);
+    std::nth_element(textHeightsBuffer.begin(), median, textHeightsBuffer.end());
+    return *median;
 }
 
-std::vector<cv::Rect> TextDetector::getBoundingBoxes(
-        const std::vector<std::vector<cv::Point>>& contours,
+std::vector<TextDetectorResult> TextDetector::getBoundingBoxes(
+        const std::vector<cv::Rect>& boxes,
+        const std::vector<float>& scores,
         const cv::Mat& originalRoi,
         const cv::Size& resizedSize,
         const float scaleX,
         const float scaleY)
 {
 
-    std::vector<cv::Rect> boundingBoxes;
-    boundingBoxes.reserve(contours.size());
+    std::vector<TextDetectorResult> boundingBoxes;
+    boundingBoxes.reserve(boxes.size());
 
-    for (const auto& contour : contours) {
+    for (size_t i = 0; i < boxes.size(); i++) {
         // Bounding box in detector space
-        cv::Rect boundingBox = cv::boundingRect(contour);
+        cv::Rect boundingBox = boxes[i];
 
         // Clamp bounding box inside resized content
         boundingBox &= cv::Rect(0, 0, resizedSize.width, resizedSize.height);
@@ -247,7 +531,7 @@ std::vector<cv::Rect> TextDetector::getBoundingBoxes(
         // Final validation
         if (originalBox.width <= 0 || originalBox.height <= 0) continue;
 
-        boundingBoxes.push_back(originalBox);
+        boundingBoxes.emplace_back(originalBox, cv::Mat(), scores[i]);
     }
 
     return boundingBoxes;
@@ -255,12 +539,14 @@ std::vector<cv::Rect> TextDetector::getBoundingBoxes(
 
 std::vector<TextDetectorResult> TextDetector::formatResults(
         const cv::Mat &originalRoi,
-        const std::vector<cv::Rect> &boundingBoxes)
+        const std::vector<TextDetectorResult> &boundingBoxes)
 {
     std::vector<TextDetectorResult> results;
     results.reserve(boundingBoxes.size());
 
-    for (const cv::Rect& boundingBox : boundingBoxes) {
+    for (const TextDetectorResult& box : boundingBoxes) {
+        const cv::Rect& boundingBox = box.boundingBox;
+
         // We don't need to clone, as we keep the crop for the whole matching process
         cv::Mat crop = originalRoi(boundingBox);
 
@@ -275,7 +561,7 @@ std::vector<TextDetectorResult> TextDetector::formatResults(
             }
         }
 
-        results.emplace_back(boundingBox, crop);
+        results.emplace_back(boundingBox, crop, box.score);
     }
 
     return results;
@@ -22,6 +22,13 @@
 #include <net.h>
 
 #include "text_detector_result.hpp"
+#include "text_presence_filter.hpp"
+#include "../inference_precision.hpp"
+#include "../model_bundle.hpp"
+#include "../network_input_builder.hpp"
+#include "../../../cancellation_token.hpp"
+#include "../../../detection_metrics.hpp"
+#include "../../../execution_policy.hpp"
 #include "../../../images/screen_image.hpp"
 
 
@@ -39,26 +46,109 @@ namespace smartautoclicker {
         bool isInitialized = false;
 
         /**
-         * Initialize detector and load models
+         * Initialize detector and load models.
+         * The model bundle is used if the folder contains one, the separated model files if not.
+         * Can be called out of the detection thread, as long as the detector isn't used during this call.
          * @param modelPath The path to the folder containing the detection models.
+         * @param warmUp true to run a dummy inference once loaded, moving the first inference costs out of the detection.
+         * @param precision The precision of the inferences.
          */
-        bool init(const std::string& modelPath);
+        bool init(
+                const std::string& modelPath,
+                bool warmUp = false,
+                InferencePrecision precision = InferencePrecision::FP16);
 
 
         /**
          * Detect the text boxes within the provided crop.
-         * @param screenCrop the cv::Mat containing the image to detect on.
+         * @param screenCrop the cv::Mat containing the RGBA image to detect on.
+         * @param expectedTextHeight the expected height of the text in the crop, in pixels, used to select the
+         * detection resolution. 0 if unknown.
          *
          * @return a list of of detected text boxes with their relevant crops
          */
-        std::vector<TextDetectorResult> detectText(const cv::Mat& screenCrop);
+        std::vector<TextDetectorResult> detectText(const cv::Mat& screenCrop, float expectedTextHeight = 0.f);
+
+        /**
+         * Get the median height of the text detected by the last call to detectText.
+         * @return The text height, in crop pixels, or 0 if no text was detected.
+         */
+        float getLastTextHeight() const { return lastTextHeight; }
+
+        /**
+         * Fills the text detection related counters.
+         * @param metrics The metrics to fill.
+         */
+        void collectMetrics(DetectionMetrics& metrics) const;
+
+        /**
+         * Set how the detection inferences use the CPU.
+         * The thread count of the inference of a single tile, the tiles are already processed in parallel in the
+         * OpenCV thread pool. It only matters for ncnn builds with OpenMP. The thread running an inference is bound to
+         * the policy cores for its duration.
+         * @param policy The execution policy.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
+        /**
+         * Set the token cancelling the detection. It is checked before each tile inference.
+         * @param token The token, or nullptr to never cancel.
+         */
+        void setCancellationToken(const CancellationToken* token);
 
     private:
+        /** Checked before each tile inference. Can be nullptr. */
+        const CancellationToken* cancellationToken = nullptr;
+
+        /**
+         * Buffers for the detection of a single tile of the detection area.
+         * Each tile have its own, allowing to process them in parallel.
+         */
+        struct TileBuffers {
+            /** Pool for the network blobs, only used by the tile thread. Must outlive the mats allocated from it. */
+            ncnn::UnlockedPoolAllocator blobAllocator;
+            /** Pool for the network layers workspaces, only used by the tile thread. */
+            ncnn::UnlockedPoolAllocator workspaceAllocator;
+            /** Builds the network input from the tile area of the screen crop. */
+            NetworkInputBuilder inputBuilder;
+            /** Reusable network input, kept between detections to avoid reallocating it for same sized tiles. */
+            ncnn::Mat input;
+            /** Network output, allocated from the blob pool. */
+            ncnn::Mat output;
+            /** Reusable buffer for the binary map. */
+            cv::Mat binary;
+            /** Reusable buffer for the connected components labels. */
+            cv::Mat labels;
+            /** Reusable buffer for the connected components statistics (bounding box and area). */
+            cv::Mat stats;
+            /** Reusable buffer for the connected components centroids, unused. */
+            cv::Mat centroids;
+            /** Reusable buffer for the sum of the scores of each connected component, indexed by label. */
+            std::vector<double> componentScoreSums;
+            /** Reusable buffer for the maximum score of each connected component, indexed by label. */
+            std::vector<float> componentMaxScores;
+            /** The bounding boxes of the valid components of the tile, in detector space. */
+            std::vector<cv::Rect> boxes;
+            /** The mean score of each valid component of the tile. */
+            std::vector<float> scores;
+        };
+
+        /**
+         * Maximum size we want to process for conditions in a single inference, in pixels.
+         * Bigger ones are split into tiles processed in parallel.
+         */
+        static constexpr int maxSize = 960;
         /**
          * Maximum size we want to process for conditions, in pixels.
          * Bigger ones get scaled down to this size as their biggest side.
          */
-        static constexpr int maxSize = 960;
+        static constexpr int maxTiledSize = 2560;
+        /** Size of the tiles, in pixels in detector space. Multiple of 32, as required by PaddleOCR detector. */
+        static constexpr int tileSize = 640;
+        /** Overlap between two neighbour tiles, in pixels in detector space, allowing to merge the text on seams. */
+        static constexpr int tileOverlap = 64;
+        /** Text height the detector model is the most accurate with, in pixels. */
+        static constexpr float targetTextHeight = 32.f;
 
         /** Image normalization mean values (RGB) for PP-OCRv3/v4 Multilingual. */
         static constexpr float meanVals[3] = {
@@ -78,15 +168,50 @@ namespace smartautoclicker {
         cv::Mat kernelDilate = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(40, 3));
         cv::Mat kernelVertical = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(1, 11));
 
+        /** Bundle the model is loaded from, if any. Must outlive the detector network using its weights. */
+        ModelBundle bundle;
         /** NCNN text detector.*/
         std::unique_ptr<ncnn::Net> ncnnDetector = std::make_unique<ncnn::Net>();
+        /** The cores the inferences are running on. */
+        CoreAffinity coreAffinity = CoreAffinity::BIG;
+
+        /** Rejects the areas without any text before running the detector network. */
+        TextPresenceFilter presenceFilter;
+
+        /** Reusable buffer for the tiles of the detection area, in detector space. */
+        std::vector<cv::Rect> tiles;
+        /** Buffers for each tile, kept between detections. Pointers, as allocators can't be moved. */
+        std::vector<std::unique_ptr<TileBuffers>> tilesBuffers;
+
+        /** Duration of the warm-up inference, in milliseconds. */
+        uint64_t warmUpDurationMs = 0;
+
+        /** Median height of the text detected by the last call to detectText, in crop pixels. */
+        float lastTextHeight = 0.f;
+        /** Reusable buffer for the height of each detected text. */
+        std::vector<float> textHeightsBuffer;
+
+        /**
+         * Runs an inference on a blank input of the biggest single inference size.
+         * The first inference of a network sets up its layers and grows the first tile pools to their steady size,
+         * making it much slower than the following ones.
+         */
+        void warmUp();
+
+        /** Loads the detection network from the separated param and weights files, path without their extension. */
+        bool loadModelFiles(const std::string& filesPath);
+        /** Loads the detection network from a model bundle, referencing its weights without copy. */
+        bool loadModelBundle(const std::string& bundlePath);
 
         /**
          * Calculates the optimal detection size while preserving aspect ratio.
-         * @param rgbCondition The input image.
-         * @return The resized dimensions (bounded by maxSize).
+         * When the text height is known, the image is scaled to bring it to targetTextHeight, without upscaling, and
+         * bounded by maxTiledSize. Without it, the image is bounded by maxSize, for a single inference.
+         * @param screenCrop The input image.
+         * @param expectedTextHeight The expected height of the text in the image, in pixels, or 0 if unknown.
+         * @return The resized dimensions.
          */
-        static cv::Size getDetectionSize(const cv::Mat& rgbCondition) ;
+        static cv::Size getDetectionSize(const cv::Mat& screenCrop, float expectedTextHeight) ;
 
         /**
          * Calculates the padded size required by the NCNN model (multiples of 32).
@@ -95,53 +220,111 @@ namespace smartautoclicker {
          */
         static cv::Size getDetectionPaddedSize(const cv::Size& detectionSize);
 
+        /**
+         * Splits the detection area into overlapping tiles.
+         * Areas small enough for a single inference are kept as a single tile.
+         * @param resizedSize The size of the detection area, in detector space.
+         * @param tiles Filled with the tiles, in detector space.
+         */
+        static void getTiles(const cv::Size& resizedSize, std::vector<cv::Rect>& tiles);
+
+        /**
+         * Get the number of tiles needed to cover a length with overlapping tiles.
+         * @param length The length to cover, in pixels in detector space.
+         * @return The number of tiles.
+         */
+        static int getTileCount(int length);
+
+        /**
+         * Get the range covered by a tile along one axis. Tiles are evenly spread over the length.
+         * @param length The length to cover, in pixels in detector space.
+         * @param tileCount The number of tiles along this axis.
+         * @param tileIndex The index of the tile along this axis.
+         * @return The range of the tile, in pixels in detector space.
+         */
+        static cv::Range getTileRange(int length, int tileCount, int tileIndex);
+
+        /**
+         * Detects the text components within a tile of the detection area.
+         * @param screenCrop The input image.
+         * @param tile The tile to process, in detector space.
+         * @param scaleX Horizontal scale factor from the detector space to the crop.
+         * @param scaleY Vertical scale factor from the detector space to the crop.
+         * @param buffers The buffers of the tile. The valid components are set in its boxes and scores, in detector
+         * space.
+         */
+        void detectTile(
+                const cv::Mat& screenCrop,
+                const cv::Rect& tile,
+                float scaleX,
+                float scaleY,
+                TileBuffers& buffers) const;
+
         /**
          * Performs the neural network inference.
-         * @param paddedRgb The normalized and padded input image.
-         * @param output The raw output tensor from the network.
+         * @param buffers The buffers of the tile, containing the normalized and padded network input. Its output is set
+         * to the raw output tensor from the network, or empty on error.
          */
-        void detectText(const cv::Mat &paddedRgb, ncnn::Mat& output) const;
+        void detectText(TileBuffers& buffers) const;
 
         /**
          * Post-processes the network output into a binary map.
          * @param detectionOutput The raw output from the detector.
-         * @return A thresholded binary cv::Mat.
+         * @param buffers The buffers of the tile, the thresholded binary map is set in its binary buffer.
          */
-        cv::Mat processDetectionOutput(const cv::Mat& detectionOutput) ;
+        void processDetectionOutput(const cv::Mat& detectionOutput, TileBuffers& buffers) const;
 
         /**
-         * Finds external contours in the binary score map.
-         * @param scoreMap The binary map produced by processDetectionOutput.
-         * @return A vector of detected contours.
+         * Labels the connected components of the binary map, and accumulates their scores in a single pass.
+         * The results are kept in the labels, stats and components scores buffers.
+         *
+         * @param scoreMap The raw float32 score map from the detector.
+         * @param buffers The buffers of the tile, containing the binary map produced by processDetectionOutput.
+         * @return The number of components found, background excluded.
          */
-        static std::vector<std::vector<cv::Point>> findContours(const cv::Mat& scoreMap) ;
+        static int findComponents(const cv::Mat& scoreMap, TileBuffers& buffers);
 
         /**
-         * Filters the detected contours based on detection confidence and geometry.
+         * Filters the components found by findComponents based on detection confidence and geometry.
          *
-         * @param contours The raw contours found in the binary map.
-         * @param scoreMap The raw float32 score map from the detector.
+         * @param componentCount The number of components found.
          * @param resizedSize The size of the image before padding.
-         *
-         * @return A new vector containing only the valid contours.
+         * @param buffers The buffers of the tile. Its boxes and scores are filled with the valid components.
+         */
+        static void filterComponents(int componentCount, const cv::Size& resizedSize, TileBuffers& buffers);
+
+        /**
+         * Gathers the components of all tiles, merging the ones of a same text split by a tile seam.
+         * @param tileCount The number of tiles processed.
+         * @param boxes Filled with the bounding box of each component, in detector space.
+         * @param scores Filled with the mean score of each component.
+         */
+        void mergeTilesComponents(size_t tileCount, std::vector<cv::Rect>& boxes, std::vector<float>& scores) const;
+
+        /**
+         * Computes the median height of the text in the detected components.
+         * @param boxes The bounding boxes of the validated components, in detector space.
+         * @param scaleX Horizontal scale factor from the detector space to the crop, for the vertical texts.
+         * @param scaleY Vertical scale factor from the detector space to the crop.
+         * @return The median text height, in crop pixels, or 0 if there is no components.
          */
-        static std::vector<std::vector<cv::Point>> filterContours(
-                const std::vector<std::vector<cv::Point>>& contours,
-                const cv::Mat& scoreMap,
-                const cv::Size& resizedSize) ;
+        float computeTextHeight(const std::vector<cv::Rect>& boxes, float scaleX, float scaleY);
 
         /**
-         * Calculates bounding boxes from detected contours and rescales them.
+         * Rescales the bounding boxes of the detected components.
          *
-         * @param contours Validated contours.
+         * @param boxes The bounding boxes of the validated components, in detector space.
+         * @param scores The mean score of each validated component.
          * @param originalRoi The original input image (for coordinate reference).
          * @param resizedSize The size of the image before padding.
          * @param scaleX Horizontal scale factor.
          * @param scaleY Vertical scale factor.
-         * @return A list of bounding boxes in original coordinate space.
+         * @return A list of results with their bounding boxes in original coordinate space and their score, without
+         * their crops.
          */
-        static std::vector<cv::Rect> getBoundingBoxes(
-                const std::vector<std::vector<cv::Point>>& contours,
+        static std::vector<TextDetectorResult> getBoundingBoxes(
+                const std::vector<cv::Rect>& boxes,
+                const std::vector<float>& scores,
                 const cv::Mat& originalRoi,
                 const cv::Size& resizedSize,
                 float scaleX,
@@ -150,12 +333,12 @@ namespace smartautoclicker {
         /**
          * Packages the bounding boxes and image into the final result structure.
          * @param originalRoi The original input image.
-         * @param boundingBoxes The list of detected text areas.
+         * @param boundingBoxes The list of detected text areas, without their crops.
          * @return A vector of packaged results.
          */
         static std::vector<TextDetectorResult> formatResults(
                 const cv::Mat& originalRoi,
-                const std::vector<cv::Rect>& boundingBoxes) ;
+                const std::vector<TextDetectorResult>& boundingBoxes) ;
     };
 }
 
@@ -28,12 +28,15 @@ namespace smartautoclicker {
      */
     struct TextDetectorResult {
         TextDetectorResult() = default;
-        TextDetectorResult(const cv::Rect& box, cv::Mat boxCrop) : boundingBox(box), crop(std::move(boxCrop)) {}
+        TextDetectorResult(const cv::Rect& box, cv::Mat boxCrop, float boxScore = 1.f)
+            : boundingBox(box), crop(std::move(boxCrop)), score(boxScore) {}
 
         /** Box around detected text. */
         cv::Rect boundingBox;
-        /** RGB view of the text within the screenCrop. */
+        /** RGBA view of the text within the screenCrop. */
         cv::Mat crop;
+        /** Mean text probability from the detection score map within the box, between 0 and 1. */
+        float score = 1.f;
     };
 
 }
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "text_height_tracker.hpp"
+
+using namespace smartautoclicker;
+
+float TextHeightTracker::getExpectedHeight(const cv::Rect& detectionArea) const {
+    auto it = expectedHeights.find(toKey(detectionArea));
+    return it != expectedHeights.end() ? it->second : 0.f;
+}
+
+void TextHeightTracker::update(const cv::Rect& detectionArea, float measuredHeight) {
+    uint64_t key = toKey(detectionArea);
+
+    // Nothing found, maybe because of a wrong hint. Don't keep it.
+    if (measuredHeight <= 0.f) {
+        expectedHeights.erase(key);
+        return;
+    }
+
+    auto it = expectedHeights.find(key);
+    if (it != expectedHeights.end()) {
+        it->second += smoothingFactor * (measuredHeight - it->second);
+        return;
+    }
+
+    if (expectedHeights.size() >= maxTrackedAreas) expectedHeights.erase(expectedHeights.begin());
+    expectedHeights.emplace(key, measuredHeight);
+}
+
+void TextHeightTracker::clear() {
+    expectedHeights.clear();
+}
+
+uint64_t TextHeightTracker::toKey(const cv::Rect& detectionArea) {
+    // Screen coordinates always fits in 16 bits
+    return (static_cast<uint64_t>(detectionArea.x & 0xFFFF) << 48)
+           | (static_cast<uint64_t>(detectionArea.y & 0xFFFF) << 32)
+           | (static_cast<uint64_t>(detectionArea.width & 0xFFFF) << 16)
+           | static_cast<uint64_t>(detectionArea.height & 0xFFFF);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_HEIGHT_TRACKER_HPP
+#define KLICK_R_TEXT_HEIGHT_TRACKER_HPP
+
+#include <opencv2/core/types.hpp>
+#include <cstdint>
+#include <unordered_map>
+
+namespace smartautoclicker {
+
+    /**
+     * Learns the height of the text detected in each detection area, as an exponential moving average of the
+     * measures of the previous detections.
+     * Used as a hint for the text detection resolution: the text found in an area on a frame will most likely have
+     * the same size on the next one.
+     */
+    class TextHeightTracker {
+
+    public:
+        /**
+         * Get the expected height of the text in a detection area.
+         * @param detectionArea The area of the screen to detect the text in.
+         * @return The expected text height, in screen pixels, or 0 if unknown.
+         */
+        float getExpectedHeight(const cv::Rect& detectionArea) const;
+
+        /**
+         * Updates the expected height of the text in a detection area with a new measure.
+         * @param detectionArea The area of the screen the text has been detected in.
+         * @param measuredHeight The height of the text detected, in screen pixels. 0 if no text was detected, the
+         * area height is then forgotten, and the next detection will be made without any hint.
+         */
+        void update(const cv::Rect& detectionArea, float measuredHeight);
+
+        /** Forget all text heights. */
+        void clear();
+
+    private:
+        /** Weight of a new measure in the moving average. */
+        static constexpr float smoothingFactor = 0.3f;
+        /** Maximum number of areas tracked. Above, an arbitrary area is forgotten for each new one. */
+        static constexpr size_t maxTrackedAreas = 64;
+
+        /** The expected text height for each tracked area. */
+        std::unordered_map<uint64_t, float> expectedHeights;
+
+        /**
+         * Get the key of a detection area in the expectedHeights map.
+         * @param detectionArea The area to get the key of.
+         * @return The key, packing the area coordinates.
+         */
+        static uint64_t toKey(const cv::Rect& detectionArea);
+    };
+}
+
+#endif //KLICK_R_TEXT_HEIGHT_TRACKER_HPP
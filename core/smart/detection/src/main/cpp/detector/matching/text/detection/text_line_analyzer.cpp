@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "text_line_analyzer.hpp"
+#include "../../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+bool TextLineAnalyzer::findSingleLine(const cv::Mat& screenCrop, cv::Rect& lineBox) {
+    if (screenCrop.rows < minLineHeight || screenCrop.cols < 2) return false;
+
+    // Horizontal gradients, text strokes creates strong transitions along the line
+    cv::cvtColor(screenCrop, grayBuffer, cv::COLOR_RGBA2GRAY);
+    cv::absdiff(
+            grayBuffer(cv::Rect(0, 0, grayBuffer.cols - 1, grayBuffer.rows)),
+            grayBuffer(cv::Rect(1, 0, grayBuffer.cols - 1, grayBuffer.rows)),
+            gradientBuffer);
+
+    // Row profile, and the bands of rows containing the text
+    cv::reduce(gradientBuffer, rowProfile, 1, cv::REDUCE_SUM, CV_32S);
+    std::vector<cv::Range> bands;
+    findBands(std::max(2, screenCrop.rows / 16), bands);
+    if (bands.size() != 1) {
+        LOGD("TextLineAnalyzer", "Not a single line, %zu bands found", bands.size());
+        return false;
+    }
+
+    const cv::Range& band = bands.front();
+    if (band.size() < minLineHeight) return false;
+
+    // Column profile within the line, to get rid of the horizontal margins
+    cv::reduce(gradientBuffer.rowRange(band), columnProfile, 0, cv::REDUCE_SUM, CV_32S);
+    const auto* columns = columnProfile.ptr<int>(0);
+    int firstColumn = -1;
+    int lastColumn = -1;
+    for (int x = 0; x < columnProfile.cols; x++) {
+        if (columns[x] < minColumnEnergy) continue;
+        if (firstColumn == -1) firstColumn = x;
+        lastColumn = x;
+    }
+    if (firstColumn == -1) return false;
+
+    // Expand the line a bit, the recognizer needs some background around the characters
+    const int marginY = band.size() / 4 + 2;
+    const int marginX = band.size() / 2;
+    cv::Rect line(
+            firstColumn - marginX,
+            band.start - marginY,
+            (lastColumn + 2 - firstColumn) + 2 * marginX,
+            band.size() + 2 * marginY);
+    line &= cv::Rect(0, 0, screenCrop.cols, screenCrop.rows);
+
+    float aspectRatio = static_cast<float>(line.width) / static_cast<float>(line.height);
+    if (aspectRatio < minAspectRatio || aspectRatio > maxAspectRatio) {
+        LOGD("TextLineAnalyzer", "Not a single line, invalid aspect ratio %f", aspectRatio);
+        return false;
+    }
+
+    lineBox = line;
+    return true;
+}
+
+void TextLineAnalyzer::findBands(int maxGap, std::vector<cv::Range>& bands) const {
+    const auto* rows = rowProfile.ptr<int>(0);
+    const int rowCount = rowProfile.rows;
+    const auto step = static_cast<int>(rowProfile.step1());
+
+    int maxEnergy = 0;
+    for (int y = 0; y < rowCount; y++) maxEnergy = std::max(maxEnergy, rows[y * step]);
+    if (maxEnergy < minRowEnergy) return;
+
+    const auto activeThreshold = static_cast<int>(static_cast<float>(maxEnergy) * activeRowRatio);
+    int bandStart = -1;
+    int lastActiveRow = -1;
+    for (int y = 0; y < rowCount; y++) {
+        if (rows[y * step] < activeThreshold) continue;
+
+        if (bandStart != -1 && y - lastActiveRow - 1 > maxGap) {
+            bands.emplace_back(bandStart, lastActiveRow + 1);
+            bandStart = -1;
+        }
+
+        if (bandStart == -1) bandStart = y;
+        lastActiveRow = y;
+    }
+
+    if (bandStart != -1) bands.emplace_back(bandStart, lastActiveRow + 1);
+}
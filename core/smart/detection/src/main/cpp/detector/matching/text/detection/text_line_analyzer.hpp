@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_LINE_ANALYZER_HPP
+#define KLICK_R_TEXT_LINE_ANALYZER_HPP
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace smartautoclicker {
+
+    /**
+     * Cheap layout analysis of a text area, used to skip the text detection network when the area is drawn tightly
+     * around a single line of text (typically, a counter for a number condition).
+     * It relies on the row profile of the horizontal gradients: text lines are bands of rows with strong gradients,
+     * separated by rows of background.
+     */
+    class TextLineAnalyzer {
+
+    public:
+        /**
+         * Tells if the area contains a single line of text and find its bounds.
+         * @param screenCrop The RGBA image to analyze.
+         * @param lineBox Set to the bounds of the line, in crop coordinates, if found.
+         * @return true if the area contains a single line of text, false if not or if unsure.
+         */
+        bool findSingleLine(const cv::Mat& screenCrop, cv::Rect& lineBox);
+
+    private:
+        /** Minimum height of a text line, in pixels. Smaller ones are too small for the recognition anyway. */
+        static constexpr int minLineHeight = 8;
+        /** Minimum width/height ratio of a line. A single character can be taller than wide. */
+        static constexpr float minAspectRatio = 0.4f;
+        /** Maximum width/height ratio of a line. Above, it will be squashed by the recognizer resizing. */
+        static constexpr float maxAspectRatio = 12.f;
+        /** Ratio of the strongest row energy above which a row is considered as part of a text line. */
+        static constexpr float activeRowRatio = 0.15f;
+        /** Minimum gradient energy of the strongest row to consider there is some text. */
+        static constexpr int minRowEnergy = 255;
+        /** Minimum gradient energy of a column to be considered as part of the text line. */
+        static constexpr int minColumnEnergy = 32;
+
+        /** Reusable buffer for the gray conversion of the crop. */
+        cv::Mat grayBuffer;
+        /** Reusable buffer for the horizontal gradients. */
+        cv::Mat gradientBuffer;
+        /** Reusable buffer for the row profile. */
+        cv::Mat rowProfile;
+        /** Reusable buffer for the column profile. */
+        cv::Mat columnProfile;
+
+        /**
+         * Find the bands of consecutive active rows in the row profile.
+         * @param maxGap Maximum number of inactive rows within a band.
+         * @param bands Filled with the bands, as [start, end) row ranges.
+         */
+        void findBands(int maxGap, std::vector<cv::Range>& bands) const;
+    };
+}
+
+#endif //KLICK_R_TEXT_LINE_ANALYZER_HPP
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "text_presence_filter.hpp"
+#include "../../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+bool TextPresenceFilter::mayContainText(const cv::Mat& screenCrop) {
+    if (screenCrop.empty()) return false;
+
+    // Text is too small to be detected anyway
+    if (screenCrop.cols < 2 || screenCrop.rows < 2) {
+        rejectedCount++;
+        return false;
+    }
+
+    cv::cvtColor(screenCrop, grayBuffer, cv::COLOR_RGBA2GRAY);
+
+    // Flat color area, nothing can be written here
+    cv::Scalar mean, stdDev;
+    cv::meanStdDev(grayBuffer, mean, stdDev);
+    if (stdDev[0] < config.minContrast) {
+        LOGD("TextPresenceFilter", "No text: flat area (stdDev=%f)", stdDev[0]);
+        rejectedCount++;
+        return false;
+    }
+
+    // Low contrast text never creates transitions as sharp as the default threshold
+    const double edgeThreshold = std::min(
+            static_cast<double>(config.edgeThreshold),
+            stdDev[0] * config.relativeEdgeThreshold);
+
+    // Text strokes creates sharp transitions both horizontally and vertically
+    const int width = grayBuffer.cols;
+    const int height = grayBuffer.rows;
+    bool hasHorizontalEdges = hasEnoughEdges(
+            grayBuffer(cv::Rect(0, 0, width - 1, height)),
+            grayBuffer(cv::Rect(1, 0, width - 1, height)),
+            edgeThreshold);
+    if (!hasHorizontalEdges) {
+        LOGD("TextPresenceFilter", "No text: not enough horizontal edges");
+        rejectedCount++;
+        return false;
+    }
+
+    bool hasVerticalEdges = hasEnoughEdges(
+            grayBuffer(cv::Rect(0, 0, width, height - 1)),
+            grayBuffer(cv::Rect(0, 1, width, height - 1)),
+            edgeThreshold);
+    if (!hasVerticalEdges) {
+        LOGD("TextPresenceFilter", "No text: not enough vertical edges");
+        rejectedCount++;
+        return false;
+    }
+
+    return true;
+}
+
+bool TextPresenceFilter::hasEnoughEdges(const cv::Mat& first, const cv::Mat& second, double edgeThreshold) {
+    // Process by bands of rows to exit as soon as the text presence is confirmed
+    constexpr int bandHeight = 16;
+
+    int edgeCount = 0;
+    for (int y = 0; y < first.rows; y += bandHeight) {
+        cv::Rect band(0, y, first.cols, std::min(bandHeight, first.rows - y));
+
+        cv::absdiff(first(band), second(band), gradientBuffer);
+        cv::threshold(gradientBuffer, gradientBuffer, edgeThreshold, 255, cv::THRESH_BINARY);
+        edgeCount += cv::countNonZero(gradientBuffer);
+
+        if (edgeCount >= config.minEdgePixels) return true;
+    }
+
+    return false;
+}
+
+uint64_t TextPresenceFilter::getRejectedCount() const {
+    return rejectedCount;
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_PRESENCE_FILTER_HPP
+#define KLICK_R_TEXT_PRESENCE_FILTER_HPP
+
+#include <opencv2/core.hpp>
+
+namespace smartautoclicker {
+
+    /**
+     * Cheap prefilter rejecting the areas that can't contain any text before running the text detection network.
+     * Text always creates sharp luminance transitions in both directions, so areas with a flat color, a smooth
+     * gradient or without enough strong edges are rejected.
+     *
+     * Default values are conservative: a false negative means a missed text condition, while a false positive only
+     * costs the regular detection.
+     */
+    class TextPresenceFilter {
+
+    public:
+        /** Tuning of the filter. */
+        struct Config {
+            /** Minimum standard deviation of the gray levels. Below, the area is considered as a flat color. */
+            double minContrast = 4.0;
+            /**
+             * Difference between two neighbouring pixels above which they are considered as an edge. Anti-aliased
+             * strokes rarely reach the full contrast of the text, so this is lowered for low contrast areas.
+             */
+            int edgeThreshold = 20;
+            /** Edge threshold relative to the standard deviation of the area, used when lower than edgeThreshold. */
+            double relativeEdgeThreshold = 1.5;
+            /** Minimum number of edge pixels, in each direction, for the area to be considered as containing text. */
+            int minEdgePixels = 12;
+        };
+
+        TextPresenceFilter() = default;
+        explicit TextPresenceFilter(const Config& filterConfig) : config(filterConfig) {}
+
+        /**
+         * Tells if the provided area might contain text.
+         * @param screenCrop The RGBA image to analyze.
+         * @return false if the area can't contain any text, true if it might.
+         */
+        bool mayContainText(const cv::Mat& screenCrop);
+
+        /** @return the number of areas rejected by the filter since its creation. */
+        [[nodiscard]] uint64_t getRejectedCount() const;
+
+    private:
+        Config config;
+
+        /** Reusable buffer for the gray conversion of the crop. */
+        cv::Mat grayBuffer;
+        /** Reusable buffer for the gradients. */
+        cv::Mat gradientBuffer;
+
+        uint64_t rejectedCount = 0;
+
+        /**
+         * Count the number of edge pixels between the two provided views, stopping once the minimum is reached.
+         * @param first The first view.
+         * @param second The second view, shifted by one pixel from the first one.
+         * @param edgeThreshold The difference between two pixels above which they are considered as an edge.
+         * @return true if there is enough edges, false if not.
+         */
+        bool hasEnoughEdges(const cv::Mat& first, const cv::Mat& second, double edgeThreshold);
+    };
+}
+
+#endif //KLICK_R_TEXT_PRESENCE_FILTER_HPP
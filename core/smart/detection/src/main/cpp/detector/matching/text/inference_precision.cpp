@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <unistd.h>
+
+#include "inference_precision.hpp"
+#include "../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+void smartautoclicker::applyInferencePrecision(InferencePrecision precision, ncnn::Option& options) {
+    bool isHalfPrecision = precision != InferencePrecision::FP32;
+
+    // Int8 models keep some layers in float, they run in half precision
+    options.use_fp16_packed = isHalfPrecision;
+    options.use_fp16_storage = isHalfPrecision;
+    options.use_fp16_arithmetic = isHalfPrecision;
+    options.use_bf16_storage = false;
+    options.use_int8_inference = precision == InferencePrecision::INT8;
+}
+
+std::string smartautoclicker::getModelFilesPath(
+        const std::string& modelPath,
+        const std::string& modelName,
+        InferencePrecision& precision)
+{
+    std::string filesPath = modelPath + "/" + modelName;
+    if (precision != InferencePrecision::INT8) return filesPath;
+
+    std::string int8FilesPath = filesPath + ".int8";
+    if (access((int8FilesPath + ".ncnn.bundle").c_str(), R_OK) == 0
+        || access((int8FilesPath + ".ncnn.param").c_str(), R_OK) == 0) {
+        return int8FilesPath;
+    }
+
+    LOGW("InferencePrecision", "No int8 model for %s in %s, using fp16", modelName.c_str(), modelPath.c_str());
+    precision = InferencePrecision::FP16;
+    return filesPath;
+}
+
+bool smartautoclicker::areModelFilesPresent(
+        const std::string& modelPath,
+        const std::string& modelName,
+        InferencePrecision precision,
+        const std::string& separatedFileName)
+{
+    std::string filesPath = getModelFilesPath(modelPath, modelName, precision);
+    if (access((filesPath + ".ncnn.bundle").c_str(), R_OK) == 0) return true;
+
+    return access((filesPath + ".ncnn.param").c_str(), R_OK) == 0
+           && access((filesPath + ".ncnn.bin").c_str(), R_OK) == 0
+           && (separatedFileName.empty() || access((modelPath + "/" + separatedFileName).c_str(), R_OK) == 0);
+}
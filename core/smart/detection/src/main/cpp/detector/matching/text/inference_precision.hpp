@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_INFERENCE_PRECISION_HPP
+#define KLICK_R_INFERENCE_PRECISION_HPP
+
+#include <net.h>
+#include <string>
+
+namespace smartautoclicker {
+
+    /** Numerical precision of a network inferences. Values must be kept in sync with the Kotlin enum. */
+    enum class InferencePrecision {
+        /** Full precision, slowest. Reference for the accuracy of the other modes. */
+        FP32 = 0,
+        /** Half precision storage and arithmetic, where supported by the CPU. ncnn default. */
+        FP16 = 1,
+        /** Quantized weights and activations, requires the int8 model files produced offline with their calibration. */
+        INT8 = 2,
+    };
+
+    /**
+     * Configures the options of a network for a precision. Must be called before loading the network.
+     * @param precision The precision of the inferences.
+     * @param options The options of the network to configure.
+     */
+    void applyInferencePrecision(InferencePrecision precision, ncnn::Option& options);
+
+    /**
+     * Get the model files for a precision.
+     * Int8 models are quantized offline into separate files, named <modelName>.int8.ncnn.*. When they are missing, the
+     * regular model files are used and the precision is lowered to FP16.
+     * @param modelPath The path to the folder containing the model files.
+     * @param modelName The name of the model files, without extension.
+     * @param precision The requested precision. Set to the precision of the returned files.
+     * @return The path of the model files, without the ".ncnn.*" extension.
+     */
+    std::string getModelFilesPath(
+            const std::string& modelPath,
+            const std::string& modelName,
+            InferencePrecision& precision);
+
+    /**
+     * Tells if the files of a model can be read, either as a bundle or as separated files. The content of the files is
+     * only checked when loading them.
+     * @param modelPath The path to the folder containing the model files.
+     * @param modelName The name of the model files, without extension.
+     * @param precision The requested precision.
+     * @param separatedFileName The name of a file required next to the separated model files, and included in the
+     * bundle. Empty if there is none.
+     * @return true if the model files are present, false if not.
+     */
+    bool areModelFilesPresent(
+            const std::string& modelPath,
+            const std::string& modelName,
+            InferencePrecision precision,
+            const std::string& separatedFileName = "");
+}
+
+#endif //KLICK_R_INFERENCE_PRECISION_HPP
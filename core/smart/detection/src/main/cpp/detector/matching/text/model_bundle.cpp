@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "model_bundle.hpp"
+#include "../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+ModelBundle::~ModelBundle() {
+    close();
+}
+
+bool ModelBundle::exists(const std::string& bundlePath) {
+    return access(bundlePath.c_str(), R_OK) == 0;
+}
+
+bool ModelBundle::open(const std::string& bundlePath) {
+    close();
+
+    int fd = ::open(bundlePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOGE("ModelBundle", "Can't open bundle %s", bundlePath.c_str());
+        return false;
+    }
+
+    struct stat fileStat = {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(Header))) {
+        LOGE("ModelBundle", "Invalid bundle size for %s", bundlePath.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference on the file
+    if (address == MAP_FAILED) {
+        LOGE("ModelBundle", "Can't map bundle %s", bundlePath.c_str());
+        return false;
+    }
+
+    mapping = static_cast<const unsigned char*>(address);
+    mappingSize = static_cast<size_t>(fileStat.st_size);
+    std::memcpy(&header, mapping, sizeof(Header));
+    if (!isHeaderValid()) {
+        LOGE("ModelBundle", "Invalid bundle header for %s", bundlePath.c_str());
+        close();
+        return false;
+    }
+
+    // The whole file will be read by the network loading, start reading it now
+    madvise(address, mappingSize, MADV_WILLNEED);
+    return true;
+}
+
+void ModelBundle::close() {
+    if (mapping == nullptr) return;
+
+    munmap(const_cast<unsigned char*>(mapping), mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    header = {};
+}
+
+const char* ModelBundle::getParams() const {
+    if (mapping == nullptr) return nullptr;
+    return reinterpret_cast<const char*>(mapping + header.paramsOffset);
+}
+
+const unsigned char* ModelBundle::getWeights() const {
+    if (mapping == nullptr) return nullptr;
+    return mapping + header.weightsOffset;
+}
+
+size_t ModelBundle::getWeightsSize() const {
+    return header.weightsSize;
+}
+
+const unsigned char* ModelBundle::getDictionary() const {
+    if (mapping == nullptr || header.dictionarySize == 0) return nullptr;
+    return mapping + header.dictionaryOffset;
+}
+
+size_t ModelBundle::getDictionarySize() const {
+    return header.dictionarySize;
+}
+
+bool ModelBundle::isHeaderValid() const {
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version) return false;
+
+    auto isInFile = [this](uint32_t offset, uint32_t size) {
+        return static_cast<uint64_t>(offset) + size <= mappingSize;
+    };
+    if (!isInFile(header.paramsOffset, header.paramsSize)
+        || !isInFile(header.weightsOffset, header.weightsSize)
+        || !isInFile(header.dictionaryOffset, header.dictionarySize)) return false;
+
+    // ncnn requires NULL-terminated params, and uses SIMD loads on the weights referenced in place
+    if (header.paramsSize == 0 || mapping[header.paramsOffset + header.paramsSize - 1] != '\0') return false;
+    if (header.paramsOffset % sectionAlignment != 0
+        || header.weightsOffset % sectionAlignment != 0
+        || header.dictionaryOffset % sectionAlignment != 0) return false;
+
+    return true;
+}
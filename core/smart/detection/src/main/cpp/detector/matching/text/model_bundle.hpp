@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_MODEL_BUNDLE_HPP
+#define KLICK_R_MODEL_BUNDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace smartautoclicker {
+
+    /**
+     * A memory mapped OCR model bundle: the network structure, its weights and its pre-indexed dictionary in a single
+     * file, produced by scripts/ocr-models/converters/ncnn_to_bundle.py.
+     * The sections are used in place from the mapping, ncnn references the weights without copying them. The bundle
+     * must then outlive the network loaded from it.
+     *
+     * File layout, little endian:
+     *  - header: magic "KRMB", version, then the offset and size (uint32) of the params, weights and dictionary.
+     *  - params: the ncnn plain text params, NULL-terminated.
+     *  - weights: the ncnn weights.
+     * Each section starts at an offset aligned on 16 bytes, the mapping itself being page aligned.
+     *  - dictionary (optional, empty for detection): the class count (uint32), the offset (uint32) of each class
+     *    characters followed by the end of the last one, and the UTF-8 characters of all classes.
+     */
+    class ModelBundle {
+
+    public:
+        ModelBundle() = default;
+        ModelBundle(const ModelBundle&) = delete;
+        ModelBundle& operator=(const ModelBundle&) = delete;
+        ~ModelBundle();
+
+        /**
+         * Tells if a bundle file exists.
+         * @param bundlePath The path of the bundle file.
+         * @return true if the file exists and can be read, false if not.
+         */
+        static bool exists(const std::string& bundlePath);
+
+        /**
+         * Maps a bundle file in memory and validates its sections. Any previously opened bundle is closed.
+         * @param bundlePath The path of the bundle file.
+         * @return true if the bundle is valid, false if not.
+         */
+        bool open(const std::string& bundlePath);
+
+        /** Unmaps the bundle. Networks loaded from it must be cleared before. */
+        void close();
+
+        /** @return the NULL-terminated ncnn params, or nullptr if no bundle is opened. */
+        [[nodiscard]] const char* getParams() const;
+
+        /** @return the ncnn weights, or nullptr if no bundle is opened. */
+        [[nodiscard]] const unsigned char* getWeights() const;
+
+        /** @return the size of the ncnn weights, in bytes. */
+        [[nodiscard]] size_t getWeightsSize() const;
+
+        /** @return the pre-indexed dictionary, or nullptr if the bundle doesn't have one. */
+        [[nodiscard]] const unsigned char* getDictionary() const;
+
+        /** @return the size of the pre-indexed dictionary, in bytes. */
+        [[nodiscard]] size_t getDictionarySize() const;
+
+    private:
+        /** Identifies a bundle file. */
+        static constexpr char magic[4] = { 'K', 'R', 'M', 'B' };
+        /** Version of the bundle format supported. */
+        static constexpr uint32_t version = 1;
+        /** Alignment of each section offset, for the SIMD loads of ncnn on the weights used in place. */
+        static constexpr uint32_t sectionAlignment = 16;
+
+        /** Header at the start of a bundle file. */
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t paramsOffset;
+            uint32_t paramsSize;
+            uint32_t weightsOffset;
+            uint32_t weightsSize;
+            uint32_t dictionaryOffset;
+            uint32_t dictionarySize;
+        };
+
+        /** The mapped file, or nullptr if no bundle is opened. */
+        const unsigned char* mapping = nullptr;
+        /** The size of the mapped file, in bytes. */
+        size_t mappingSize = 0;
+        /** The header of the mapped bundle. */
+        Header header = {};
+
+        /**
+         * Checks the header against the mapped file size.
+         * @return true if all sections are within the file and correctly aligned, false if not.
+         */
+        [[nodiscard]] bool isHeaderValid() const;
+    };
+}
+
+#endif //KLICK_R_MODEL_BUNDLE_HPP
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include "network_input_builder.hpp"
+#include "../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+namespace {
+    constexpr int channelCount = 3;
+
+    /** Source coordinate of a resized pixel center, same convention as cv::resize with INTER_LINEAR. */
+    inline float getSourceCoordinate(int resized, float scale) {
+        return (static_cast<float>(resized) + 0.5f) * scale - 0.5f;
+    }
+}
+
+bool NetworkInputBuilder::build(
+        const cv::Mat& crop,
+        const cv::Size& resizedSize,
+        int offsetX,
+        const cv::Size& inputSize,
+        const float* meanVals,
+        const float* normVals,
+        ncnn::Mat& input)
+{
+    if (crop.empty() || crop.depth() != CV_8U || crop.channels() < channelCount) {
+        LOGE("NetworkInputBuilder", "Invalid crop: %dx%d, type %d", crop.cols, crop.rows, crop.type());
+        return false;
+    }
+    if (resizedSize.width <= 0 || resizedSize.height <= 0 || offsetX < 0
+            || offsetX + resizedSize.width > inputSize.width || resizedSize.height > inputSize.height) {
+        LOGE("NetworkInputBuilder", "Invalid resized size %dx%d at %d for input %dx%d",
+             resizedSize.width, resizedSize.height, offsetX, inputSize.width, inputSize.height);
+        return false;
+    }
+
+    input.create(inputSize.width, inputSize.height, channelCount);
+
+    // Normalization folded in a single multiply-add: (value - mean) * norm
+    float scales[channelCount];
+    float biases[channelCount];
+    float* planes[channelCount];
+    for (int c = 0; c < channelCount; c++) {
+        scales[c] = normVals[c];
+        biases[c] = -meanVals[c] * normVals[c];
+        planes[c] = input.channel(c);
+    }
+
+    computeColumnsMapping(crop.cols, resizedSize.width);
+
+    const int pixelStep = crop.channels();
+    const float scaleY = static_cast<float>(crop.rows) / static_cast<float>(resizedSize.height);
+    const int resizedEndX = offsetX + resizedSize.width;
+
+    for (int y = 0; y < inputSize.height; y++) {
+        float* rows[channelCount];
+        for (int c = 0; c < channelCount; c++) rows[c] = planes[c] + static_cast<size_t>(y) * inputSize.width;
+
+        // Padding rows, below the resized crop
+        if (y >= resizedSize.height) {
+            for (int c = 0; c < channelCount; c++) std::fill(rows[c], rows[c] + inputSize.width, biases[c]);
+            continue;
+        }
+
+        // Padding columns, on each side of the resized crop
+        for (int c = 0; c < channelCount; c++) {
+            std::fill(rows[c], rows[c] + offsetX, biases[c]);
+            std::fill(rows[c] + resizedEndX, rows[c] + inputSize.width, biases[c]);
+        }
+
+        float sourceY = std::max(0.f, getSourceCoordinate(y, scaleY));
+        int topY = std::min(static_cast<int>(sourceY), crop.rows - 1);
+        int bottomY = std::min(topY + 1, crop.rows - 1);
+        float bottomWeight = sourceY - static_cast<float>(topY);
+        float topWeight = 1.f - bottomWeight;
+
+        const uint8_t* top = crop.ptr<uint8_t>(topY);
+        const uint8_t* bottom = crop.ptr<uint8_t>(bottomY);
+        for (int x = 0; x < resizedSize.width; x++) {
+            const int left = sourceColumns[x] * pixelStep;
+            const int right = std::min(sourceColumns[x] + 1, crop.cols - 1) * pixelStep;
+            const float rightWeight = columnWeights[x];
+            const float leftWeight = 1.f - rightWeight;
+
+            for (int c = 0; c < channelCount; c++) {
+                float topValue = top[left + c] * leftWeight + top[right + c] * rightWeight;
+                float bottomValue = bottom[left + c] * leftWeight + bottom[right + c] * rightWeight;
+                float value = topValue * topWeight + bottomValue * bottomWeight;
+                rows[c][offsetX + x] = value * scales[c] + biases[c];
+            }
+        }
+    }
+
+    return true;
+}
+
+void NetworkInputBuilder::computeColumnsMapping(int sourceWidth, int resizedWidth) {
+    sourceColumns.resize(resizedWidth);
+    columnWeights.resize(resizedWidth);
+
+    const float scaleX = static_cast<float>(sourceWidth) / static_cast<float>(resizedWidth);
+    for (int x = 0; x < resizedWidth; x++) {
+        float sourceX = std::max(0.f, getSourceCoordinate(x, scaleX));
+        int left = std::min(static_cast<int>(sourceX), sourceWidth - 1);
+        sourceColumns[x] = left;
+        columnWeights[x] = sourceX - static_cast<float>(left);
+    }
+}
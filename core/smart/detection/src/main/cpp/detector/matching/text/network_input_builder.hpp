@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_NETWORK_INPUT_BUILDER_HPP
+#define KLICK_R_NETWORK_INPUT_BUILDER_HPP
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include <net.h>
+
+namespace smartautoclicker {
+
+    /**
+     * Builds the input of the OCR networks directly from a crop of the screen.
+     * The crop is read once, and resized, padded and normalized in a single pass into the planar float tensor expected
+     * by ncnn, without any intermediate RGB, resized or padded image.
+     */
+    class NetworkInputBuilder {
+
+    public:
+        /**
+         * Resizes the crop with a bilinear interpolation and writes it normalized into the network input.
+         * The area of the input outside of the resized crop is filled with normalized black, like a zero padding.
+         *
+         * @param crop The RGBA (or RGB) image to read from. Can be a non continuous view.
+         * @param resizedSize The size of the crop once resized in the input.
+         * @param offsetX The horizontal position of the resized crop in the input.
+         * @param inputSize The size of the network input.
+         * @param meanVals The normalization mean values, for each of the R, G and B channels.
+         * @param normVals The normalization scale values, for each of the R, G and B channels.
+         * @param input Set to the 3 channels input. Its memory is reused if it already has the requested size.
+         * @return true if the input has been built, false if the parameters are invalid.
+         */
+        bool build(
+                const cv::Mat& crop,
+                const cv::Size& resizedSize,
+                int offsetX,
+                const cv::Size& inputSize,
+                const float* meanVals,
+                const float* normVals,
+                ncnn::Mat& input);
+
+    private:
+        /** Reusable buffer for the left source column of each resized column. */
+        std::vector<int> sourceColumns;
+        /** Reusable buffer for the weight of the right source column of each resized column. */
+        std::vector<float> columnWeights;
+
+        /**
+         * Compute the source coordinate and interpolation weight of each resized column.
+         * @param sourceWidth The width of the crop.
+         * @param resizedWidth The width of the resized crop.
+         */
+        void computeColumnsMapping(int sourceWidth, int resizedWidth);
+    };
+}
+
+#endif //KLICK_R_NETWORK_INPUT_BUILDER_HPP
@@ -14,59 +14,103 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  See <http://www.gnu.org/licenses/>.
  */
+#include <chrono>
+#include <sys/stat.h>
+
 #include "alphabet_recognizer.hpp"
 #include "../../../../logs/log.h"
 
-#include <fstream>
-
 using namespace smartautoclicker;
 
-bool AlphabetRecognizer::loadModel(const std::string& modelId, const std::string& modelPath) {
-    ncnnRecognizer->opt.num_threads = 1;
+bool AlphabetRecognizer::loadModel(
+        const std::string& modelId,
+        const std::string& modelPath,
+        bool warmUp,
+        InferencePrecision precision)
+{
     ncnnRecognizer->opt.use_packing_layout = true;
     ncnnRecognizer->opt.lightmode = true;
+    // Intermediate blobs are allocated from the TextRecognizer pools, don't let each extractor create its own pools
+    ncnnRecognizer->opt.use_local_pool_allocator = false;
     modelIdentifier = modelId;
 
-    if (!loadModelParams(modelPath) || !loadDictionary(modelPath + "/dict.txt")) {
+    auto loadingStart = std::chrono::steady_clock::now();
+    std::string filesPath = getModelFilesPath(modelPath, "rec", precision);
+    applyInferencePrecision(precision, ncnnRecognizer->opt);
+
+    std::string bundlePath = filesPath + ".ncnn.bundle";
+    bool isLoaded = ModelBundle::exists(bundlePath)
+            ? loadModelBundle(bundlePath)
+            : loadModelFiles(filesPath, modelPath + "/dict.txt");
+    if (!isLoaded) {
         LOGE("AlphabetRecognizer", "Initialization failed for %s", modelPath.c_str());
         return false;
     }
 
-    LOGI("TextRecognizer", "Alphabet recognition model loaded %s", modelPath.c_str());
+    auto loadingMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - loadingStart).count();
+    LOGI("TextRecognizer", "Alphabet recognition model %s loaded in %lldms from %s, precision %d",
+         modelId.c_str(), static_cast<long long>(loadingMs), bundle ? "bundle" : "files", static_cast<int>(precision));
+
+    if (warmUp) this->warmUp();
     return true;
 }
 
-bool AlphabetRecognizer::loadModelParams(const std::string& modelPath) {
-    std::string paramPath = modelPath + "/rec.ncnn.param";
-    std::string binPath = modelPath + "/rec.ncnn.bin";
+void AlphabetRecognizer::warmUp() {
+    auto warmUpStart = std::chrono::steady_clock::now();
 
-    int paramResult = ncnnRecognizer->load_param(paramPath.c_str());
-    int binResult = ncnnRecognizer->load_model(binPath.c_str());
+    // Normalized blank text line, at the fixed recognition input size
+    ncnn::Mat input(320, 48, 3);
+    input.fill(0.f);
+    ncnn::Mat output;
 
-    if (paramResult != 0 || binResult != 0) {
-        LOGE("AlphabetRecognizer", "Failed to load recognition model from %s", modelPath.c_str());
-        return false;
-    }
+    ncnn::Extractor extractor = ncnnRecognizer->create_extractor();
+    extractor.set_light_mode(true);
+    extractor.input("in0", input);
+    extractor.extract("out0", output);
 
-    return true;
+    warmUpDurationMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - warmUpStart).count();
+    LOGI("TextRecognizer", "Alphabet recognition model %s warmed up in %llums",
+         modelIdentifier.c_str(), static_cast<unsigned long long>(warmUpDurationMs));
 }
 
-bool AlphabetRecognizer::loadDictionary(const std::string& dictionaryPath) {
-    std::ifstream file(dictionaryPath);
-    if (!file.is_open()) {
-        LOGE("AlphabetRecognizer", "Failed to open dictionary at %s", dictionaryPath.c_str());
+bool AlphabetRecognizer::loadModelBundle(const std::string& bundlePath) {
+    bundle = std::make_unique<ModelBundle>();
+    if (!bundle->open(bundlePath)) {
+        bundle.reset();
         return false;
     }
 
-    dictionary.clear();
-    dictionary.emplace_back(""); // index 0 = blank token for CTC
+    if (ncnnRecognizer->load_param_mem(bundle->getParams()) != 0
+        || ncnnRecognizer->load_model(bundle->getWeights()) <= 0) {
+        LOGE("AlphabetRecognizer", "Failed to load recognition model from %s", bundlePath.c_str());
+        ncnnRecognizer->clear();
+        bundle.reset();
+        return false;
+    }
+
+    // The dictionary is copied, only the weights are kept in the mapping
+    memorySize = bundle->getWeightsSize() + bundle->getDictionarySize();
+    return dictionary.load(bundle->getDictionary(), bundle->getDictionarySize());
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-        dictionary.push_back(line);
+bool AlphabetRecognizer::loadModelFiles(const std::string& filesPath, const std::string& dictionaryPath) {
+    std::string paramPath = filesPath + ".ncnn.param";
+    std::string binPath = filesPath + ".ncnn.bin";
+
+    int paramResult = ncnnRecognizer->load_param(paramPath.c_str());
+    int binResult = ncnnRecognizer->load_model(binPath.c_str());
+
+    if (paramResult != 0 || binResult != 0) {
+        LOGE("AlphabetRecognizer", "Failed to load recognition model from %s", filesPath.c_str());
+        return false;
     }
 
+    if (!dictionary.load(dictionaryPath)) return false;
+
+    struct stat binStat = {};
+    memorySize = stat(binPath.c_str(), &binStat) == 0 ? static_cast<size_t>(binStat.st_size) : 0;
     return true;
 }
 
@@ -74,10 +118,22 @@ ncnn::Extractor AlphabetRecognizer::create_extractor() const {
     return ncnnRecognizer->create_extractor();
 }
 
-std::vector<std::string> AlphabetRecognizer::getDictionary() const {
+const TextDictionary& AlphabetRecognizer::getDictionary() const {
     return dictionary;
 }
 
+void AlphabetRecognizer::setThreadCount(int threadCount) {
+    ncnnRecognizer->opt.num_threads = threadCount;
+}
+
+uint64_t AlphabetRecognizer::getWarmUpDuration() const {
+    return warmUpDurationMs;
+}
+
+size_t AlphabetRecognizer::getMemorySize() const {
+    return memorySize;
+}
+
 bool AlphabetRecognizer::isRtlAlphabet() const {
     if (modelIdentifier == "ARABIC") return true;
     return false;
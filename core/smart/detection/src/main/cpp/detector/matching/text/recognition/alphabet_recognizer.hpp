@@ -18,36 +18,76 @@
 #ifndef KLICK_R_ALPHABET_RECOGNIZER_HPP
 #define KLICK_R_ALPHABET_RECOGNIZER_HPP
 
+#include <cstdint>
 #include <memory>
 #include <net.h>
 #include <string>
 
+#include "text_dictionary.hpp"
+#include "../inference_precision.hpp"
+#include "../model_bundle.hpp"
+
 namespace smartautoclicker {
 
     class AlphabetRecognizer {
     public:
-        /** */
-        bool loadModel(const std::string& modelId, const std::string &modelPath);
+        /**
+         * Loads the recognition model and its dictionary. Can be called out of the detection thread.
+         * @param modelId The identifier of the model.
+         * @param modelPath The path to the folder containing the model files.
+         * @param warmUp true to run a dummy inference once loaded, moving the first inference costs out of the detection.
+         * @param precision The precision of the inferences.
+         * @return true if the model is loaded, false if not.
+         */
+        bool loadModel(
+                const std::string& modelId,
+                const std::string &modelPath,
+                bool warmUp = false,
+                InferencePrecision precision = InferencePrecision::FP16);
 
         [[nodiscard]] ncnn::Extractor create_extractor() const;
 
-        [[nodiscard]] std::vector<std::string> getDictionary() const;
+        [[nodiscard]] const TextDictionary& getDictionary() const;
 
         [[nodiscard]] bool isRtlAlphabet() const;
 
+        /** Set the number of threads used by the inferences of this recognizer. */
+        void setThreadCount(int threadCount);
+
+        /** @return the duration of the warm-up inference, in milliseconds, or 0 if there was none. */
+        [[nodiscard]] uint64_t getWarmUpDuration() const;
+
+        /** @return the estimated memory used by the loaded model, in bytes. */
+        [[nodiscard]] size_t getMemorySize() const;
+
     private:
         /** Unique identifier for the recognition model. */
         std::string modelIdentifier;
+        /** Bundle the model is loaded from, if any. Must outlive the network using its weights. */
+        std::unique_ptr<ModelBundle> bundle;
         /** NCNN text recognizer network. */
         std::unique_ptr<ncnn::Net> ncnnRecognizer = std::make_unique<ncnn::Net>();
         /** Character dictionary used to map model indices to characters. */
-        std::vector<std::string> dictionary;
+        TextDictionary dictionary;
+        /** Estimated memory used by the loaded model, from the size of its weights and dictionary. */
+        size_t memorySize = 0;
+        /** Duration of the warm-up inference, in milliseconds. */
+        uint64_t warmUpDurationMs = 0;
 
-        /** Loads the NCNN model parameters and weights. */
-        bool loadModelParams(const std::string &modelPath);
+        /**
+         * Runs an inference on a blank input of the recognition input size.
+         * The first inference of a network sets up its layers, making it much slower than the following ones.
+         */
+        void warmUp();
 
-        /** Loads the character dictionary file. */
-        bool loadDictionary(const std::string &dictionaryPath);
+        /**
+         * Loads the NCNN model parameters and weights, and the dictionary from the separated model files.
+         * @param filesPath The path of the NCNN files, without their extension.
+         * @param dictionaryPath The path of the dictionary file.
+         */
+        bool loadModelFiles(const std::string &filesPath, const std::string& dictionaryPath);
+        /** Loads the NCNN model parameters and weights, and the dictionary from a model bundle. */
+        bool loadModelBundle(const std::string &bundlePath);
     };
 }
 
@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+#include "glyph_template_reader.hpp"
+
+using namespace smartautoclicker;
+
+bool GlyphTemplateReader::read(
+        const cv::Rect& detectionArea,
+        const cv::Mat& lineCrop,
+        std::string& text,
+        float& confidence)
+{
+    // A glyph can't be told apart from the digits not learned yet
+    auto it = areasTemplates.find(toKey(detectionArea));
+    if (it == areasTemplates.end() || it->second.learnedDigits != allDigitsMask) return false;
+    if (!segment(lineCrop)) return false;
+
+    text.clear();
+    confidence = 1.f;
+    for (const Glyph& glyph : glyphs) {
+        float bestCorrelation = -1.f;
+        float secondCorrelation = -1.f;
+        const GlyphTemplate* bestTemplate = nullptr;
+        for (const GlyphTemplate& glyphTemplate : it->second.templates) {
+            // Cheap rejection of the templates of a different width, like '1' and '0'
+            float templateAspectRatio = glyphTemplate.glyph.aspectRatio;
+            if (std::abs(glyph.aspectRatio - templateAspectRatio) > maxAspectRatioDifference * templateAspectRatio) {
+                continue;
+            }
+
+            float correlation = correlate(glyph.patch.data(), glyphTemplate.glyph.patch.data());
+            if (correlation > bestCorrelation) {
+                secondCorrelation = bestCorrelation;
+                bestCorrelation = correlation;
+                bestTemplate = &glyphTemplate;
+            } else if (correlation > secondCorrelation) {
+                secondCorrelation = correlation;
+            }
+        }
+
+        // Unknown glyph, or the font has changed
+        if (bestTemplate == nullptr || bestCorrelation < minGlyphCorrelation) return false;
+        // Ambiguous glyph, like a blurred '8' between '3' and '0'
+        if (bestCorrelation - secondCorrelation < minCorrelationMargin) return false;
+
+        // The template confidence is from the learning frame, weight it by how well this frame matches it
+        text.push_back(bestTemplate->character);
+        confidence = std::min(confidence, bestTemplate->confidence * bestCorrelation);
+    }
+
+    return true;
+}
+
+void GlyphTemplateReader::learn(
+        const cv::Rect& detectionArea,
+        const cv::Mat& lineCrop,
+        const std::string& text,
+        float confidence)
+{
+    // Spaces are gaps between the glyphs, not glyphs
+    size_t characterCount = text.size() - std::count(text.begin(), text.end(), ' ');
+    if (!segment(lineCrop) || glyphs.size() != characterCount) return;
+
+    uint64_t key = toKey(detectionArea);
+    auto it = areasTemplates.find(key);
+    if (it == areasTemplates.end()) {
+        if (areasTemplates.size() >= maxTrackedAreas) areasTemplates.erase(areasTemplates.begin());
+        it = areasTemplates.emplace(key, AreaTemplates()).first;
+    }
+    std::vector<GlyphTemplate>& templates = it->second.templates;
+
+    size_t glyphIndex = 0;
+    for (char character : text) {
+        if (character == ' ') continue;
+        const Glyph& glyph = glyphs[glyphIndex++];
+
+        auto templateIt = std::find_if(templates.begin(), templates.end(),
+                                       [character](const auto& t) { return t.character == character; });
+        if (templateIt == templates.end()) {
+            templates.push_back({ character, glyph, confidence });
+            if (character >= '0' && character <= '9') it->second.learnedDigits |= 1 << (character - '0');
+            continue;
+        }
+
+        // Blend the new sample into the template. Both have a zero mean, only the norm must be restored.
+        Glyph& learned = templateIt->glyph;
+        float squaredNorm = 0.f;
+        for (int i = 0; i < patchSize; i++) {
+            learned.patch[i] += learningRate * (glyph.patch[i] - learned.patch[i]);
+            squaredNorm += learned.patch[i] * learned.patch[i];
+        }
+        if (squaredNorm > 0.f) {
+            float norm = std::sqrt(squaredNorm);
+            for (float& value : learned.patch) value /= norm;
+        }
+        learned.aspectRatio += learningRate * (glyph.aspectRatio - learned.aspectRatio);
+        templateIt->confidence += learningRate * (confidence - templateIt->confidence);
+    }
+}
+
+void GlyphTemplateReader::clear() {
+    areasTemplates.clear();
+}
+
+bool GlyphTemplateReader::segment(const cv::Mat& lineCrop) {
+    glyphs.clear();
+    if (lineCrop.empty()) return false;
+
+    cv::cvtColor(lineCrop, grayBuffer, cv::COLOR_RGBA2GRAY);
+    cv::Scalar mean, stdDev;
+    cv::meanStdDev(grayBuffer, mean, stdDev);
+    if (stdDev[0] < minContrast) return false;
+
+    // The text is the minority of the pixels, whatever its color
+    cv::threshold(grayBuffer, binaryBuffer, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+    if (static_cast<size_t>(cv::countNonZero(binaryBuffer)) > binaryBuffer.total() / 2) {
+        cv::bitwise_not(binaryBuffer, binaryBuffer);
+    }
+
+    // Glyphs are the runs of columns containing text
+    cv::reduce(binaryBuffer, columnProfile, 0, cv::REDUCE_MAX);
+    const auto* columns = columnProfile.ptr<uint8_t>(0);
+    int glyphStart = -1;
+    for (int x = 0; x <= columnProfile.cols; x++) {
+        bool isText = x < columnProfile.cols && columns[x] != 0;
+        if (isText && glyphStart < 0) {
+            glyphStart = x;
+        } else if (!isText && glyphStart >= 0) {
+            glyphs.emplace_back();
+            if (!buildGlyph(cv::Range(glyphStart, x), glyphs.back())) return false;
+            glyphStart = -1;
+        }
+    }
+
+    return !glyphs.empty();
+}
+
+bool GlyphTemplateReader::buildGlyph(const cv::Range& glyphColumns, Glyph& glyph) {
+    // Keep the whole line height, the vertical position tells the separators apart ('.', ',' and '-')
+    cv::resize(grayBuffer.colRange(glyphColumns), patchBuffer, cv::Size(patchWidth, patchHeight), 0, 0,
+               cv::INTER_AREA);
+
+    cv::Mat patch(patchHeight, patchWidth, CV_32F, glyph.patch.data());
+    patchBuffer.convertTo(patch, CV_32F);
+    patch -= cv::mean(patch)[0];
+    double norm = cv::norm(patch);
+    if (norm < 1e-3) return false;
+
+    patch /= norm;
+    glyph.aspectRatio = static_cast<float>(glyphColumns.size()) / static_cast<float>(grayBuffer.rows);
+    return true;
+}
+
+float GlyphTemplateReader::correlate(const float* patch, const float* other) {
+    // Both patches have a zero mean and an unit norm, the correlation is their dot product
+    int i = 0;
+    float correlation = 0.f;
+
+#if CV_SIMD128
+    constexpr int lanes = cv::v_float32x4::nlanes;
+    cv::v_float32x4 sums = cv::v_setzero_f32();
+    for (; i <= patchSize - lanes; i += lanes) {
+        sums = cv::v_muladd(cv::v_load(patch + i), cv::v_load(other + i), sums);
+    }
+    correlation = cv::v_reduce_sum(sums);
+#endif
+
+    for (; i < patchSize; i++) {
+        correlation += patch[i] * other[i];
+    }
+
+    return correlation;
+}
+
+uint64_t GlyphTemplateReader::toKey(const cv::Rect& detectionArea) {
+    // Screen coordinates always fits in 16 bits
+    return (static_cast<uint64_t>(detectionArea.x & 0xFFFF) << 48)
+           | (static_cast<uint64_t>(detectionArea.y & 0xFFFF) << 32)
+           | (static_cast<uint64_t>(detectionArea.width & 0xFFFF) << 16)
+           | static_cast<uint64_t>(detectionArea.height & 0xFFFF);
+}
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_GLYPH_TEMPLATE_READER_HPP
+#define KLICK_R_GLYPH_TEMPLATE_READER_HPP
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace smartautoclicker {
+
+    /**
+     * Reads numbers drawn with a stable font (score, gold, timer counters...) without the recognition network.
+     * The glyphs of each detection area are learned from the texts recognized with a high confidence by the OCR, then
+     * the following frames are read by segmenting the text line into glyphs and matching them against the learned
+     * templates, with a normalized cross correlation on tiny patches.
+     *
+     * An unknown glyph correlates well with the closest learned one (a '9' with an '8' or a '0'), so an area is read
+     * only once all of its digits have been learned, and each glyph must clearly match a single template.
+     */
+    class GlyphTemplateReader {
+
+    public:
+        /**
+         * Reads a number from a single text line with the glyphs learned for its detection area.
+         * @param detectionArea The area of the screen the line has been found in.
+         * @param lineCrop The RGBA crop of the text line.
+         * @param text Set to the characters read.
+         * @param confidence Set to the lowest confidence of the glyphs, between 0 and 1. The confidence of a glyph is
+         * the OCR confidence its template has been learned with, weighted by its correlation with the template.
+         * @return true if all glyphs have been matched with a learned template, false if the OCR should be used.
+         */
+        bool read(const cv::Rect& detectionArea, const cv::Mat& lineCrop, std::string& text, float& confidence);
+
+        /**
+         * Learns the glyphs of a text line recognized by the OCR. Lines that can't be segmented into one glyph per
+         * character are ignored.
+         * @param detectionArea The area of the screen the line has been found in.
+         * @param lineCrop The RGBA crop of the text line.
+         * @param text The text recognized in the line, with a high confidence.
+         * @param confidence The confidence of the OCR for this text, between 0 and 1.
+         */
+        void learn(const cv::Rect& detectionArea, const cv::Mat& lineCrop, const std::string& text, float confidence);
+
+        /** Forget all learned glyphs. */
+        void clear();
+
+    private:
+        /** Width of the glyph patches, in pixels. */
+        static constexpr int patchWidth = 12;
+        /** Height of the glyph patches, in pixels. */
+        static constexpr int patchHeight = 16;
+        /** Number of values in a glyph patch. */
+        static constexpr int patchSize = patchWidth * patchHeight;
+
+        /** Minimum standard deviation of the line gray levels. Below, the glyphs can't be separated reliably. */
+        static constexpr double minContrast = 16.0;
+        /** Maximum relative difference between the aspect ratios of a glyph and its template. */
+        static constexpr float maxAspectRatioDifference = 0.3f;
+        /** Minimum correlation of each glyph with its template to accept a read. */
+        static constexpr float minGlyphCorrelation = 0.85f;
+        /** Minimum difference between the correlations of the best and the second best templates of a glyph. */
+        static constexpr float minCorrelationMargin = 0.05f;
+        /** Mask of the learned digits of an area once all of them have been learned. */
+        static constexpr uint16_t allDigitsMask = (1 << 10) - 1;
+        /** Weight of a new sample in the learned template. */
+        static constexpr float learningRate = 0.2f;
+        /** Maximum number of areas tracked. Above, an arbitrary area is forgotten for each new one. */
+        static constexpr size_t maxTrackedAreas = 64;
+
+        /** A glyph segmented from a text line. */
+        struct Glyph {
+            /** Gray levels of the glyph resized to the patch size, with a zero mean and an unit norm. */
+            std::array<float, patchSize> patch;
+            /** Width of the glyph divided by the height of the line. */
+            float aspectRatio;
+        };
+
+        /** A learned glyph of a detection area. */
+        struct GlyphTemplate {
+            /** The character of this glyph. */
+            char character;
+            /** The glyph appearance, averaged over the learned samples. */
+            Glyph glyph;
+            /** The OCR confidence of the learned samples, averaged like the glyph. */
+            float confidence;
+        };
+
+        /** The glyphs learned in a detection area. */
+        struct AreaTemplates {
+            /** The learned templates, one per character. */
+            std::vector<GlyphTemplate> templates;
+            /** Bit mask of the learned digits, bit 0 for '0'. */
+            uint16_t learnedDigits = 0;
+        };
+
+        /** The learned templates, for each detection area. */
+        std::unordered_map<uint64_t, AreaTemplates> areasTemplates;
+
+        /** Reusable buffer for the gray conversion of the line. */
+        cv::Mat grayBuffer;
+        /** Reusable buffer for the binarized line. */
+        cv::Mat binaryBuffer;
+        /** Reusable buffer for the column profile of the binarized line. */
+        cv::Mat columnProfile;
+        /** Reusable buffer for a glyph resized to the patch size. */
+        cv::Mat patchBuffer;
+        /** Reusable buffer for the glyphs of the line. */
+        std::vector<Glyph> glyphs;
+
+        /**
+         * Splits a text line into glyphs, separated by columns of background.
+         * @param lineCrop The RGBA crop of the text line.
+         * @return false if the line has not enough contrast to be segmented.
+         */
+        bool segment(const cv::Mat& lineCrop);
+
+        /**
+         * Builds the normalized patch of a glyph.
+         * @param glyphColumns The columns of the glyph in the gray line.
+         * @param glyph Set to the glyph patch and aspect ratio.
+         * @return false if the glyph is uniform.
+         */
+        bool buildGlyph(const cv::Range& glyphColumns, Glyph& glyph);
+
+        /**
+         * Computes the normalized cross correlation of two patches.
+         * @return The correlation, between -1 and 1.
+         */
+        static float correlate(const float* patch, const float* other);
+
+        /**
+         * Get the key of a detection area in the areasTemplates map.
+         * @param detectionArea The area to get the key of.
+         * @return The key, packing the area coordinates.
+         */
+        static uint64_t toKey(const cv::Rect& detectionArea);
+    };
+}
+
+#endif //KLICK_R_GLYPH_TEMPLATE_READER_HPP
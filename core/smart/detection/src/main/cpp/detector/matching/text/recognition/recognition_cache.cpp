@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+
+#include "recognition_cache.hpp"
+
+using namespace smartautoclicker;
+
+namespace {
+    constexpr uint64_t fnvOffsetBasis = 0xcbf29ce484222325ULL;
+    constexpr uint64_t fnvPrime = 0x100000001b3ULL;
+
+    inline uint64_t hashBytes(uint64_t hash, const uint8_t* data, size_t length) {
+        // Process 8 bytes at a time, this is not FNV-1a anymore but it is way faster on large crops
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(uint64_t));
+            hash = (hash ^ word) * fnvPrime;
+        }
+        for (; i < length; i++) {
+            hash = (hash ^ data[i]) * fnvPrime;
+        }
+        return hash;
+    }
+}
+
+uint64_t RecognitionCache::computeKey(const cv::Mat& crop, const std::string& modelId, bool numbersOnly) {
+    uint64_t hash = hashBytes(
+            fnvOffsetBasis,
+            reinterpret_cast<const uint8_t*>(modelId.data()),
+            modelId.size());
+
+    const int header[4] = { crop.cols, crop.rows, crop.type(), numbersOnly ? 1 : 0 };
+    hash = hashBytes(hash, reinterpret_cast<const uint8_t*>(header), sizeof(header));
+
+    // Crops are views on the screen image, so rows are not continuous
+    const size_t rowLength = crop.cols * crop.elemSize();
+    for (int row = 0; row < crop.rows; row++) {
+        hash = hashBytes(hash, crop.ptr<uint8_t>(row), rowLength);
+    }
+
+    return hash;
+}
+
+bool RecognitionCache::get(uint64_t key, TextRecognizerResult& result) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        missCount++;
+        return false;
+    }
+
+    // Move the entry at the front, it is now the most recently used
+    entries.splice(entries.begin(), entries, it->second);
+    result.text = it->second->text;
+    result.confidence = it->second->confidence;
+
+    hitCount++;
+    return true;
+}
+
+void RecognitionCache::put(uint64_t key, const TextRecognizerResult& result) {
+    auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->text = result.text;
+        it->second->confidence = result.confidence;
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+
+    if (entries.size() >= maxEntries) {
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+
+    entries.push_front({ key, result.text, result.confidence });
+    index[key] = entries.begin();
+}
+
+void RecognitionCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
+uint64_t RecognitionCache::getHitCount() const {
+    return hitCount;
+}
+
+uint64_t RecognitionCache::getMissCount() const {
+    return missCount;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_RECOGNITION_CACHE_HPP
+#define KLICK_R_RECOGNITION_CACHE_HPP
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "text_recognizer_result.hpp"
+
+namespace smartautoclicker {
+
+    /**
+     * Bounded LRU cache of recognition results.
+     * Entries are keyed by a hash of the crop pixels and the recognition model identifier, allowing to skip the
+     * inference for text lines that did not change between two frames (labels, static buttons, counters...).
+     */
+    class RecognitionCache {
+
+    public:
+        /**
+         * Computes the cache key for a crop.
+         * @param crop The RGBA image crop containing the text. Can be a non continuous view.
+         * @param modelId The identifier of the recognition model used for the crop.
+         * @param numbersOnly true if the crop is recognized as a number, false for any text.
+         * @return The key for this crop.
+         */
+        static uint64_t computeKey(const cv::Mat& crop, const std::string& modelId, bool numbersOnly = false);
+
+        /**
+         * Get the cached result for a key, if any.
+         * @param key The key of the crop, computed with computeKey.
+         * @param result Filled with the cached text and confidence if found. Bounding box is left untouched.
+         * @return true if the result was found, false if not.
+         */
+        bool get(uint64_t key, TextRecognizerResult& result);
+
+        /**
+         * Insert a result in the cache, evicting the least recently used one if the cache is full.
+         * @param key The key of the crop, computed with computeKey.
+         * @param result The recognition result to cache.
+         */
+        void put(uint64_t key, const TextRecognizerResult& result);
+
+        /** Remove all entries from the cache. Counters are kept. */
+        void clear();
+
+        [[nodiscard]] uint64_t getHitCount() const;
+        [[nodiscard]] uint64_t getMissCount() const;
+
+    private:
+        /** Maximum number of results kept in the cache. */
+        static constexpr size_t maxEntries = 128;
+
+        struct Entry {
+            uint64_t key;
+            std::string text;
+            float confidence;
+        };
+
+        /** Entries, ordered from the most recently used to the least recently used. */
+        std::list<Entry> entries;
+        /** Index of the entries by key. */
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+
+        uint64_t hitCount = 0;
+        uint64_t missCount = 0;
+    };
+}
+
+#endif //KLICK_R_RECOGNITION_CACHE_HPP
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <fstream>
+
+#include "text_dictionary.hpp"
+#include "../../../../logs/log.h"
+
+using namespace smartautoclicker;
+
+bool TextDictionary::load(const std::string& dictionaryPath) {
+    std::ifstream file(dictionaryPath);
+    if (!file.is_open()) {
+        LOGE("TextDictionary", "Failed to open dictionary at %s", dictionaryPath.c_str());
+        return false;
+    }
+
+    characters.clear();
+    offsets.clear();
+    offsets.push_back(0); // index 0 = blank token for CTC, empty
+    offsets.push_back(0);
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        characters += line;
+        offsets.push_back(static_cast<uint32_t>(characters.size()));
+    }
+
+    characters.shrink_to_fit();
+    offsets.shrink_to_fit();
+    indexNumberClasses();
+    return true;
+}
+
+bool TextDictionary::load(const unsigned char* data, size_t dataSize) {
+    if (data == nullptr || dataSize < sizeof(uint32_t)) {
+        LOGE("TextDictionary", "Invalid pre-indexed dictionary");
+        return false;
+    }
+
+    auto words = reinterpret_cast<const uint32_t*>(data);
+    size_t classCount = words[0];
+    size_t offsetsSize = (classCount + 1) * sizeof(uint32_t);
+    if (classCount == 0 || sizeof(uint32_t) + offsetsSize > dataSize) {
+        LOGE("TextDictionary", "Invalid pre-indexed dictionary offsets, %zu classes", classCount);
+        return false;
+    }
+
+    const uint32_t* classOffsets = words + 1;
+    size_t charactersSize = dataSize - sizeof(uint32_t) - offsetsSize;
+    for (size_t i = 0; i < classCount; i++) {
+        if (classOffsets[i] > classOffsets[i + 1] || classOffsets[i + 1] > charactersSize) {
+            LOGE("TextDictionary", "Invalid pre-indexed dictionary offset for class %zu", i);
+            return false;
+        }
+    }
+
+    offsets.assign(classOffsets, classOffsets + classCount + 1);
+    characters.assign(reinterpret_cast<const char*>(classOffsets + classCount + 1), offsets.back());
+    offsets.shrink_to_fit();
+    characters.shrink_to_fit();
+    indexNumberClasses();
+    return true;
+}
+
+size_t TextDictionary::size() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+std::string_view TextDictionary::getToken(size_t index) const {
+    return { characters.data() + offsets[index], offsets[index + 1] - offsets[index] };
+}
+
+const std::vector<int>& TextDictionary::getNumberClasses() const {
+    return numberClasses;
+}
+
+void TextDictionary::indexNumberClasses() {
+    numberClasses.clear();
+    for (size_t i = 1; i < size(); i++) {
+        std::string_view token = getToken(i);
+        if (token.size() != 1) continue;
+
+        char c = token.front();
+        if ((c >= '0' && c <= '9') || numberSeparators.find(c) != std::string_view::npos) {
+            numberClasses.push_back(static_cast<int>(i));
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_DICTIONARY_HPP
+#define KLICK_R_TEXT_DICTIONARY_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace smartautoclicker {
+
+    /**
+     * Character dictionary of a recognition model, mapping the model class indices to their UTF-8 characters.
+     * All characters are stored in a single buffer with an offset table, to keep the lookups allocation free.
+     */
+    class TextDictionary {
+
+    public:
+        /**
+         * Loads the dictionary file, one character per line. Index 0 is reserved for the CTC blank token.
+         * @param dictionaryPath The path of the dictionary file.
+         * @return true if the dictionary has been loaded, false if not.
+         */
+        bool load(const std::string& dictionaryPath);
+
+        /**
+         * Loads a pre-indexed dictionary, as stored in a model bundle. The data is copied.
+         * @param data The class count, the offsets table and the characters of all classes. Must be 32 bits aligned.
+         * @param dataSize The size of the data, in bytes.
+         * @return true if the dictionary has been loaded, false if the data is invalid.
+         */
+        bool load(const unsigned char* data, size_t dataSize);
+
+        /** @return the number of classes, including the blank token. */
+        [[nodiscard]] size_t size() const;
+
+        /**
+         * Get the characters for a class index.
+         * @param index The class index, must be lower than size().
+         * @return A view on the UTF-8 characters, valid as long as this dictionary is not reloaded.
+         */
+        [[nodiscard]] std::string_view getToken(size_t index) const;
+
+        /** @return the indices of the classes that can be part of a number: digits and separators. */
+        [[nodiscard]] const std::vector<int>& getNumberClasses() const;
+
+    private:
+        /** Characters, other than the digits, that can be part of a number. */
+        static constexpr std::string_view numberSeparators = ".,-+ ";
+
+
+        /** The characters of all classes, concatenated. */
+        std::string characters;
+        /** Start of each class characters within characters, followed by the end of the last one. */
+        std::vector<uint32_t> offsets;
+        /** Indices of the classes that can be part of a number, in ascending order. */
+        std::vector<int> numberClasses;
+
+        /** Fills numberClasses from the loaded characters. */
+        void indexNumberClasses();
+    };
+}
+
+#endif //KLICK_R_TEXT_DICTIONARY_HPP
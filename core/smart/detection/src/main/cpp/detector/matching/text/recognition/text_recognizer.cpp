@@ -17,30 +17,35 @@
 #include "text_recognizer.hpp"
 #include "../../../../logs/log.h"
 
-#include <opencv2/imgproc.hpp>
-#include <fstream>
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <chrono>
 
 using namespace smartautoclicker;
 
-bool TextRecognizer::init(const std::map<std::string, std::string>& models) {
-    alphabetRecognizers.clear();
+bool TextRecognizer::init(
+        const std::map<std::string, std::string>& models,
+        bool warmUp,
+        InferencePrecision precision)
+{
+    recognitionModels.clear();
+    isWarmUpEnabled = warmUp;
+    modelsPrecision = precision;
+    recognitionCache.clear();
+    loadedMemorySize = 0;
 
+    // Models are loaded in background on their first use, only check their files are there
     for (auto const& [id, path] : models) {
-        AlphabetRecognizer recognizer;
-
-        if (!recognizer.loadModel(id, path)) {
-            LOGE("TextRecognizer", "Can't load model %s", id.c_str());
-            alphabetRecognizers.clear();
+        if (!areModelFilesPresent(path, "rec", precision, "dict.txt")) {
+            LOGE("TextRecognizer", "Can't find recognition model %s in %s", id.c_str(), path.c_str());
+            recognitionModels.clear();
             isInitialized = false;
             return false;
         }
-
-        alphabetRecognizers[id] = std::move(recognizer);
+        recognitionModels[id].path = path;
     }
 
-    // Pre-allocate padded buffer to the maximum possible width to avoid runtime reallocations
-    paddedBuffer = cv::Mat::zeros(48, 320, CV_8UC3);
-    resizedBuffer = cv::Mat::zeros(48, 320, CV_8UC3);
+    tokenIndices.reserve(maxTokenCount);
 
     isInitialized = true;
     return true;
@@ -48,50 +53,194 @@ bool TextRecognizer::init(const std::map<std::string, std::string>& models) {
 
 std::vector<TextRecognizerResult> TextRecognizer::recognizeText(
         const std::string& recognitionModelId,
-        const std::vector<TextDetectorResult>& detectionResults)
+        const std::vector<TextDetectorResult>& detectionResults,
+        bool numbersOnly)
 {
     std::vector<TextRecognizerResult> results;
     results.reserve(detectionResults.size());
 
-    auto it = alphabetRecognizers.find(recognitionModelId);
-    if (it == alphabetRecognizers.end()) {
+    AlphabetRecognizer* recognizer = getRecognizer(recognitionModelId);
+    if (recognizer == nullptr) return {};
+
+    TextRecognizerResult result;
+    for (const auto& detectionResult : detectionResults) {
+        if (CancellationToken::isCancelled(cancellationToken)) break;
+        if (recognizeText(*recognizer, recognitionModelId, detectionResult, numbersOnly, result)) {
+            results.push_back(std::move(result));
+        }
+    }
+
+    LOGD("TextRecognizer", "Recognition cache: hits=%llu, misses=%llu",
+         static_cast<unsigned long long>(recognitionCache.getHitCount()),
+         static_cast<unsigned long long>(recognitionCache.getMissCount()));
+
+    return results;
+}
+
+bool TextRecognizer::recognizeText(
+        const std::string& recognitionModelId,
+        const TextDetectorResult& detectionResult,
+        TextRecognizerResult& result)
+{
+    AlphabetRecognizer* recognizer = getRecognizer(recognitionModelId);
+    if (recognizer == nullptr) return false;
+
+    return recognizeText(*recognizer, recognitionModelId, detectionResult, false, result);
+}
+
+ModelState TextRecognizer::prepareModel(const std::string& recognitionModelId) {
+    auto it = recognitionModels.find(recognitionModelId);
+    if (it == recognitionModels.end()) {
         LOGE("TextRecognizer", "Unknown model id: %s", recognitionModelId.c_str());
-        return {};
+        return ModelState::UNAVAILABLE;
     }
-    auto& recognizer = it->second;
 
-    for (const auto& detectionResult : detectionResults) {
-        cv::Mat crop = detectionResult.crop;
-        if (crop.empty()) continue;
-
-        // 1. Preprocess using member buffers
-        // This is safe because we process one crop at a time (Sequential)
-        ncnn::Mat input = preprocess(crop, recognizer.isRtlAlphabet());
-
-        // 2. Inference
-        ncnn::Extractor extractor = recognizer.create_extractor();
-        extractor.set_light_mode(true);
-
-        ncnn::Mat output;
-        extractor.input("in0", input);
-        int result = extractor.extract("out0", output);
-        if (result != 0) {
-            LOGE("TextRecognizer","Inference failed");
-            continue;
+    return prepareModel(recognitionModelId, it->second);
+}
+
+AlphabetRecognizer* TextRecognizer::getRecognizer(const std::string& recognitionModelId) {
+    auto it = recognitionModels.find(recognitionModelId);
+    if (it == recognitionModels.end()) {
+        LOGE("TextRecognizer", "Unknown model id: %s", recognitionModelId.c_str());
+        return nullptr;
+    }
+
+    RecognitionModel& model = it->second;
+    if (prepareModel(recognitionModelId, model) != ModelState::READY) return nullptr;
+
+    model.lastUse = ++useCounter;
+    return model.recognizer.get();
+}
+
+ModelState TextRecognizer::prepareModel(const std::string& recognitionModelId, RecognitionModel& model) {
+    if (model.recognizer) return ModelState::READY;
+    if (model.isLoadingFailed) return ModelState::UNAVAILABLE;
+
+    // Not loaded yet, the loading only touches the new recognizer and can be done out of the detection thread
+    if (!model.loadingRecognizer.valid()) {
+        auto loadRecognizer = [recognitionModelId, path = model.path, warmUp = isWarmUpEnabled,
+                               precision = modelsPrecision]() {
+            auto recognizer = std::make_unique<AlphabetRecognizer>();
+            if (!recognizer->loadModel(recognitionModelId, path, warmUp, precision)) recognizer.reset();
+            return recognizer;
+        };
+        model.loadingRecognizer = std::async(std::launch::async, loadRecognizer);
+        return ModelState::LOADING;
+    }
+    if (model.loadingRecognizer.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return ModelState::LOADING;
+    }
+
+    std::unique_ptr<AlphabetRecognizer> recognizer = model.loadingRecognizer.get();
+    if (!recognizer) {
+        LOGE("TextRecognizer", "Can't load model %s", recognitionModelId.c_str());
+        model.isLoadingFailed = true;
+        return ModelState::UNAVAILABLE;
+    }
+
+    recognizer->setThreadCount(executionPolicy.getThreadCount());
+    loadedMemorySize += recognizer->getMemorySize();
+    warmUpDurationMs += recognizer->getWarmUpDuration();
+    model.recognizer = std::move(recognizer);
+    model.lastUse = ++useCounter;
+    evictModels(&model);
+
+    return ModelState::READY;
+}
+
+void TextRecognizer::evictModels(const RecognitionModel* keptModel) {
+    while (memoryBudget > 0 && loadedMemorySize > memoryBudget) {
+        // Find the least recently used model that can be unloaded
+        RecognitionModel* evictedModel = nullptr;
+        const std::string* evictedModelId = nullptr;
+        for (auto& [id, model] : recognitionModels) {
+            if (!model.recognizer || &model == keptModel) continue;
+            if (evictedModel == nullptr || model.lastUse < evictedModel->lastUse) {
+                evictedModel = &model;
+                evictedModelId = &id;
+            }
         }
+        if (evictedModel == nullptr) return;
 
-        // 3. Decode
-        results.push_back(decode(
-                recognizer.getDictionary(),
-                detectionResult.boundingBox,
-                recognizer.isRtlAlphabet(),
-                output));
+        LOGI("TextRecognizer", "Unloading model %s, memory budget exceeded (%zu/%zu)",
+             evictedModelId->c_str(), loadedMemorySize, memoryBudget);
+        loadedMemorySize -= evictedModel->recognizer->getMemorySize();
+        evictedModel->recognizer.reset();
     }
+}
 
-    return results;
+bool TextRecognizer::recognizeText(
+        AlphabetRecognizer& recognizer,
+        const std::string& recognitionModelId,
+        const TextDetectorResult& detectionResult,
+        bool numbersOnly,
+        TextRecognizerResult& result)
+{
+    const cv::Mat& crop = detectionResult.crop;
+    if (crop.empty()) return false;
+
+    // Unchanged text line since a previous recognition, only the position might have changed
+    uint64_t cacheKey = RecognitionCache::computeKey(crop, recognitionModelId, numbersOnly);
+    if (recognitionCache.get(cacheKey, result)) {
+        result.boundingBox = detectionResult.boundingBox;
+        return true;
+    }
+
+    // 1. Preprocess into the member input
+    // This is safe because we process one crop at a time (Sequential)
+    if (!preprocess(crop, recognizer.isRtlAlphabet())) return false;
+
+    // 2. Inference, all intermediate blobs are taken from the pools
+    // Give back the previous output to the pool first, it will most likely be reused for this inference
+    recognitionOutput.release();
+    ncnn::Extractor extractor = recognizer.create_extractor();
+    extractor.set_light_mode(true);
+    extractor.set_blob_allocator(&blobAllocator);
+    extractor.set_workspace_allocator(&workspaceAllocator);
+
+    extractor.input("in0", recognitionInput);
+    ScopedCoreAffinity affinity(executionPolicy.getCoreAffinity());
+    if (extractor.extract("out0", recognitionOutput) != 0) {
+        LOGE("TextRecognizer","Inference failed");
+        return false;
+    }
+
+    // 3. Decode
+    decode(
+            recognizer.getDictionary(),
+            detectionResult.boundingBox,
+            recognizer.isRtlAlphabet(),
+            numbersOnly,
+            recognitionOutput,
+            result);
+    recognitionCache.put(cacheKey, result);
+
+    return true;
+}
+
+void TextRecognizer::collectMetrics(DetectionMetrics& metrics) const {
+    metrics.recognitionCacheHits = recognitionCache.getHitCount();
+    metrics.recognitionCacheMisses = recognitionCache.getMissCount();
+    metrics.recognitionWarmUpMs = warmUpDurationMs;
+}
+
+void TextRecognizer::setCancellationToken(const CancellationToken* token) {
+    cancellationToken = token;
 }
 
-ncnn::Mat TextRecognizer::preprocess(const cv::Mat& crop, bool isRtlAlphabet) {
+void TextRecognizer::setExecutionPolicy(const ExecutionPolicy& policy) {
+    executionPolicy = policy;
+    for (auto& [id, model] : recognitionModels) {
+        if (model.recognizer) model.recognizer->setThreadCount(policy.getThreadCount());
+    }
+}
+
+void TextRecognizer::setMemoryBudget(size_t budget) {
+    memoryBudget = budget;
+    evictModels(nullptr);
+}
+
+bool TextRecognizer::preprocess(const cv::Mat& crop, bool isRtlAlphabet) {
     constexpr int targetHeight = 48;
     constexpr int maxWidth = 320;
 
@@ -99,54 +248,49 @@ ncnn::Mat TextRecognizer::preprocess(const cv::Mat& crop, bool isRtlAlphabet) {
     int resizedWidth = std::max(1, static_cast<int>(static_cast<float>(crop.cols) * scale));
     resizedWidth = std::min(resizedWidth, maxWidth);
 
-    cv::resize(
+    // Always build the full 320px input — SVTR attention is frozen at 320px
+    int xOffset = isRtlAlphabet ? (maxWidth - resizedWidth) : 0;
+    return inputBuilder.build(
             crop,
-            resizedBuffer,
             cv::Size(resizedWidth, targetHeight),
-            0, 0,
-            cv::INTER_LINEAR);
-
-    // Always clear and use the full 320px buffer — SVTR requires fixed width
-    paddedBuffer.setTo(cv::Scalar(0, 0, 0));
-    int xOffset = isRtlAlphabet ? (maxWidth - resizedWidth) : 0;
-    resizedBuffer.copyTo(paddedBuffer(cv::Rect(xOffset, 0, resizedWidth, targetHeight)));
-
-    // Always pass maxWidth — SVTR attention is frozen at 320px
-    ncnn::Mat input = ncnn::Mat::from_pixels(
-            paddedBuffer.data,
-            ncnn::Mat::PIXEL_RGB,
-            maxWidth,
-            targetHeight);
-
-    input.substract_mean_normalize(meanVals, normVals);
-    return input;
+            xOffset,
+            cv::Size(maxWidth, targetHeight),
+            meanVals,
+            normVals,
+            recognitionInput);
 }
 
-TextRecognizerResult TextRecognizer::decode(
-        const std::vector<std::string>& dictionary,
+void TextRecognizer::decode(
+        const TextDictionary& dictionary,
         const cv::Rect& boundingBox,
         bool isRtlAlphabet,
-        const ncnn::Mat& output)
+        bool numbersOnly,
+        const ncnn::Mat& output,
+        TextRecognizerResult& result)
 {
-
     const int numClasses = output.w;
     const int sequenceLength = output.h;
+    const size_t dictionarySize = dictionary.size();
 
     float totalConfidence = 0.f;
     int confidenceCount = 0;
     int previousIndex = 0;
 
-    tokens.clear();
+    tokenIndices.clear();
     for (int t = 0; t < sequenceLength; t++) {
-        const float* scores = output.row(t);
-        int bestIndex = 0;
-        float bestScore = scores[0];
-
-        for (int c = 1; c < numClasses; c++) {
-            if (scores[c] > bestScore) {
-                bestScore = scores[c];
-                bestIndex = c;
+        float bestScore;
+        int bestIndex;
+        if (numbersOnly) {
+            // Only a few classes are compared, instead of the whole dictionary
+            float numberClassesScore;
+            bestIndex = argmax(output.row(t), numClasses, dictionary.getNumberClasses(), bestScore, numberClassesScore);
+            if (numberClassesScore < minNumberClassesScore) {
+                tokenIndices.clear();
+                confidenceCount = 0;
+                break;
             }
+        } else {
+            bestIndex = argmax(output.row(t), numClasses, bestScore);
         }
 
         if (bestIndex == 0) { // blank token
@@ -157,26 +301,96 @@ TextRecognizerResult TextRecognizer::decode(
         if (bestIndex == previousIndex) continue;
         previousIndex = bestIndex;
 
-        if (bestIndex >= 0 && static_cast<size_t>(bestIndex) < dictionary.size()) {
-            tokens.push_back(dictionary[bestIndex]);
+        if (static_cast<size_t>(bestIndex) < dictionarySize) {
+            tokenIndices.push_back(bestIndex);
             totalConfidence += bestScore;
             confidenceCount++;
         }
     }
 
     // Reverse token order for RTL alphabets
-    if (isRtlAlphabet) std::reverse(tokens.begin(), tokens.end());
+    if (isRtlAlphabet) std::reverse(tokenIndices.begin(), tokenIndices.end());
+
+    result.text.clear();
+    for (int tokenIndex : tokenIndices) {
+        result.text.append(dictionary.getToken(tokenIndex));
+    }
+
+    result.boundingBox = boundingBox;
+    result.confidence = confidenceCount > 0 ? totalConfidence / static_cast<float>(confidenceCount) : 0.f;
+    LOGD("TextRecognizer", "\"%s\" (conf=%.3f)", result.text.c_str(), result.confidence);
+}
 
-    std::string recognizedText;
-    size_t totalLen = 0;
-    for (const auto& t : tokens) totalLen += t.size();
-    recognizedText.reserve(totalLen);
-    for (const auto& token : tokens) {
-        recognizedText += token;
+int TextRecognizer::argmax(const float* scores, int count, float& bestScore) {
+    int i = 0;
+    int bestIndex = 0;
+    bestScore = scores[0];
+
+#if CV_SIMD128
+    constexpr int lanes = cv::v_float32x4::nlanes;
+    if (count >= lanes) {
+        // Best score and its first index for each lane, strict comparison keeps the first one on equality
+        cv::v_float32x4 laneBestScores = cv::v_load(scores);
+        cv::v_int32x4 laneBestIndices(0, 1, 2, 3);
+        cv::v_int32x4 laneIndices = laneBestIndices;
+        const cv::v_int32x4 laneStep = cv::v_setall_s32(lanes);
+
+        for (i = lanes; i <= count - lanes; i += lanes) {
+            laneIndices = cv::v_add(laneIndices, laneStep);
+            cv::v_float32x4 laneScores = cv::v_load(scores + i);
+            cv::v_float32x4 isBetter = cv::v_gt(laneScores, laneBestScores);
+            laneBestScores = cv::v_select(isBetter, laneScores, laneBestScores);
+            laneBestIndices = cv::v_select(cv::v_reinterpret_as_s32(isBetter), laneIndices, laneBestIndices);
+        }
+
+        // Merge the lanes, the lowest index wins on equality
+        float laneScoresValues[lanes];
+        int laneIndicesValues[lanes];
+        cv::v_store(laneScoresValues, laneBestScores);
+        cv::v_store(laneIndicesValues, laneBestIndices);
+        bestScore = laneScoresValues[0];
+        bestIndex = laneIndicesValues[0];
+        for (int lane = 1; lane < lanes; lane++) {
+            if (laneScoresValues[lane] > bestScore
+                    || (laneScoresValues[lane] == bestScore && laneIndicesValues[lane] < bestIndex)) {
+                bestScore = laneScoresValues[lane];
+                bestIndex = laneIndicesValues[lane];
+            }
+        }
     }
+#endif
 
-    float confidence = confidenceCount > 0 ? totalConfidence / static_cast<float>(confidenceCount) : 0.f;
-    LOGD("TextRecognizer", "\"%s\" (conf=%.3f)", recognizedText.c_str(), confidence);
+    // Remaining classes not handled by the vectorized loop
+    for (; i < count; i++) {
+        if (scores[i] > bestScore) {
+            bestScore = scores[i];
+            bestIndex = i;
+        }
+    }
+
+    return bestIndex;
+}
+
+int TextRecognizer::argmax(
+        const float* scores,
+        int count,
+        const std::vector<int>& classes,
+        float& bestScore,
+        float& totalScore)
+{
+    int bestIndex = 0;
+    bestScore = scores[0];
+    totalScore = scores[0];
+
+    for (int index : classes) {
+        if (index >= count) break;
+
+        totalScore += scores[index];
+        if (scores[index] > bestScore) {
+            bestScore = scores[index];
+            bestIndex = index;
+        }
+    }
 
-    return {boundingBox, recognizedText, confidence};
+    return bestIndex;
 }
@@ -18,15 +18,32 @@
 #define KLICK_R_TEXT_RECOGNIZER_HPP
 
 #include <opencv2/core.hpp>
+#include <future>
 #include <map>
+#include <memory>
 #include <net.h>
 
 #include "../detection/text_detector_result.hpp"
+#include "../network_input_builder.hpp"
+#include "../../../cancellation_token.hpp"
+#include "../../../detection_metrics.hpp"
+#include "../../../execution_policy.hpp"
 #include "alphabet_recognizer.hpp"
+#include "recognition_cache.hpp"
 #include "text_recognizer_result.hpp"
 
 namespace smartautoclicker {
 
+    /** Availability of a model loaded in background. */
+    enum class ModelState {
+        /** The model is being loaded, the matching can't be done yet. */
+        LOADING,
+        /** The model is loaded and can be used. */
+        READY,
+        /** The model is unknown or its loading has failed. */
+        UNAVAILABLE,
+    };
+
     /**
      * Handles the recognition of text (OCR) within detected text areas.
      * Uses an NCNN-based model (typically PaddleOCR's CRNN recognizer) to convert
@@ -39,24 +56,94 @@ namespace smartautoclicker {
         bool isInitialized = false;
 
         /**
-         * Initialize the recognizer and load models/dictionary.
-         * @param assetManager The Android Asset Manager for loading assets.
-         * @return true if initialization succeeded, false otherwise.
+         * Initialize the recognizer and register the recognition models.
+         * Models are loaded in background by prepareModel, and can be unloaded later to stay within the memory budget.
+         * @param recognitionModels Map of model identifier to the path of their folder.
+         * @param warmUp true to run a dummy inference after loading each model, in the background loading task.
+         * @param precision The precision of the inferences of all models.
+         * @return true if the files of all models are present, false otherwise. Invalid files are only detected when
+         * loading them, and the model is then reported as unavailable.
          */
-        bool init(const std::map<std::string, std::string>& recognitionModels);
+        bool init(
+                const std::map<std::string, std::string>& recognitionModels,
+                bool warmUp = false,
+                InferencePrecision precision = InferencePrecision::FP16);
+
+        /**
+         * Get the state of a model, starting its loading in background if it isn't loaded.
+         * A model loaded in background is only used once this method, or a recognition, reports it as ready.
+         * @param recognitionModelId The identifier of the recognition model provided with [init].
+         * @return The state of the model.
+         */
+        ModelState prepareModel(const std::string& recognitionModelId);
 
         /**
          * Recognizes text within the provided detection results.
          * @param recognitionModelId The identifier of the recognition model provided with [init].
          * @param detectionResults List of crops and their bounding boxes from a TextDetector.
+         * @param numbersOnly true to decode only the digits and number separators. Crops containing other characters
+         * are then recognized as an empty text.
          * @return A list of recognition results containing the text and confidence for each crop.
          */
         std::vector<TextRecognizerResult> recognizeText(
                 const std::string& recognitionModelId,
-                const std::vector<TextDetectorResult>& detectionResults);
+                const std::vector<TextDetectorResult>& detectionResults,
+                bool numbersOnly = false);
+
+        /**
+         * Recognizes the text within a single detection result.
+         * Allows the caller to stop the recognition as soon as it has found what it is looking for.
+         * @param recognitionModelId The identifier of the recognition model provided with [init].
+         * @param detectionResult The crop and its bounding box from a TextDetector.
+         * @param result Set to the recognized text and its confidence on success.
+         * @return true if the text has been recognized, false if the recognition failed.
+         */
+        bool recognizeText(
+                const std::string& recognitionModelId,
+                const TextDetectorResult& detectionResult,
+                TextRecognizerResult& result);
+
+        /**
+         * Fills the recognition related counters.
+         * @param metrics The metrics to fill.
+         */
+        void collectMetrics(DetectionMetrics& metrics) const;
+
+        /**
+         * Set how the recognition inferences use the CPU.
+         * @param policy The execution policy, applied to the current and future recognition models.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
+        /**
+         * Set the maximum memory used by the loaded recognition models.
+         * When loading a model exceeds it, the least recently used models are unloaded.
+         * @param budget The memory budget in bytes, or 0 to keep all models loaded.
+         */
+        void setMemoryBudget(size_t budget);
+
+        /**
+         * Set the token cancelling the recognitions. It is checked before each text box recognition.
+         * @param token The token, or nullptr to never cancel.
+         */
+        void setCancellationToken(const CancellationToken* token);
 
     private:
 
+        /** A recognition model registered with init. */
+        struct RecognitionModel {
+            /** The path to the folder containing the model files. */
+            std::string path;
+            /** The recognizer for this model, or nullptr if not loaded. */
+            std::unique_ptr<AlphabetRecognizer> recognizer;
+            /** The recognizer being loaded in background, valid until it is taken into recognizer. */
+            std::future<std::unique_ptr<AlphabetRecognizer>> loadingRecognizer;
+            /** Value of useCounter when this model was last used, for the eviction order. */
+            uint64_t lastUse = 0;
+            /** true if the model couldn't be loaded, it will not be retried until the next init. */
+            bool isLoadingFailed = false;
+        };
+
         /** PP-OCR normalization mean values. */
         static constexpr float meanVals[3] = {
                 127.5f,
@@ -71,37 +158,143 @@ namespace smartautoclicker {
                 1.f / 127.5f
         };
 
-        std::map<std::string, AlphabetRecognizer> alphabetRecognizers;
+        /** Expected maximum number of tokens decoded for a text line, used to size the decoding buffers. */
+        static constexpr size_t maxTokenCount = 128;
+
+        /**
+         * Minimum probability of the blank and number classes at a position of a number.
+         * Below, another character is more likely at this position and the text is not a number.
+         */
+        static constexpr float minNumberClassesScore = 0.5f;
+
+        /** The registered recognition models, by identifier. */
+        std::map<std::string, RecognitionModel> recognitionModels;
+        /** true to warm up the models after loading them. */
+        bool isWarmUpEnabled = false;
+        /** Precision of the models inferences. */
+        InferencePrecision modelsPrecision = InferencePrecision::FP16;
+        /** Total duration of the warm-up inferences of the loaded models, in milliseconds. */
+        uint64_t warmUpDurationMs = 0;
+        /** Incremented at each model use. */
+        uint64_t useCounter = 0;
+        /** Maximum memory for the loaded models, in bytes. 0 for no limit. */
+        size_t memoryBudget = 0;
+        /** Estimated memory used by the loaded models, in bytes. */
+        size_t loadedMemorySize = 0;
+
+        /** How the recognition inferences use the CPU. */
+        ExecutionPolicy executionPolicy;
+        /** Checked before each text box recognition. Can be nullptr. */
+        const CancellationToken* cancellationToken = nullptr;
+
+        /** Results of the previous recognitions, to skip the inference on unchanged text lines. */
+        RecognitionCache recognitionCache;
+
+        /** Pool for the network blobs, shared by all recognition models. Must outlive the mats allocated from it. */
+        ncnn::UnlockedPoolAllocator blobAllocator;
+        /** Pool for the network layers workspaces, shared by all recognition models. */
+        ncnn::UnlockedPoolAllocator workspaceAllocator;
+
+        /** Builds the network input from the text crops. */
+        NetworkInputBuilder inputBuilder;
+        /** Reusable network input, always of the same size, to avoid reallocations in the main loop. */
+        ncnn::Mat recognitionInput;
+        /** Network output, allocated from the blob pool. */
+        ncnn::Mat recognitionOutput;
+        /** Reusable buffer for the dictionary index of the decoded text tokens.*/
+        std::vector<int> tokenIndices;
+
+        /**
+         * Get the recognizer for a model, starting its loading in background if required.
+         * The returned recognizer stays valid until the next call to this method.
+         * @param recognitionModelId The identifier of the recognition model provided with [init].
+         * @return The recognizer, or nullptr if the model is not ready.
+         */
+        AlphabetRecognizer* getRecognizer(const std::string& recognitionModelId);
+
+        /**
+         * Get the state of a registered model, starting its loading in background if it isn't loaded.
+         * Once loaded, the recognizer is taken from the background task and the memory budget is applied.
+         * @param recognitionModelId The identifier of the recognition model.
+         * @param model The registered model.
+         * @return The state of the model.
+         */
+        ModelState prepareModel(const std::string& recognitionModelId, RecognitionModel& model);
+
+        /**
+         * Unloads the least recently used models until the loaded models fit in the memory budget.
+         * @param keptModel A model that must not be unloaded, or nullptr.
+         */
+        void evictModels(const RecognitionModel* keptModel);
 
-        /** Reusable buffers to avoid reallocations in the main loop. */
-        cv::Mat resizedBuffer;
-        /** Reusable buffer for padding, pre-allocated to max size in init. */
-        cv::Mat paddedBuffer;
-        /** Reusable buffer for text tokens.*/
-        std::vector<std::string> tokens;
+        /**
+         * Recognizes the text within a single detection result with the provided recognizer.
+         * @param recognizer The recognizer for the alphabet of the text.
+         * @param recognitionModelId The identifier of the recognition model, used for caching.
+         * @param detectionResult The crop and its bounding box from a TextDetector.
+         * @param numbersOnly true to decode only the digits and number separators.
+         * @param result Set to the recognized text and its confidence on success.
+         * @return true if the text has been recognized, false if the recognition failed.
+         */
+        bool recognizeText(
+                AlphabetRecognizer& recognizer,
+                const std::string& recognitionModelId,
+                const TextDetectorResult& detectionResult,
+                bool numbersOnly,
+                TextRecognizerResult& result);
 
         /**
-         * Preprocesses a single image crop for the recognition model.
-         * Handles resizing and normalization.
-         * @param crop The RGB image crop containing text.
+         * Preprocesses a single image crop into the recognition model input.
+         * Handles resizing, padding and normalization in a single pass.
+         * @param crop The RGBA image crop containing text.
          * @param isRtlAlphabet true if the text is right to left, false if not.
-         * @return An NCNN Mat ready for input.
+         * @return true if the recognitionInput is ready, false if not.
          */
-        ncnn::Mat preprocess(const cv::Mat& crop, bool isRtlAlphabet);
+        bool preprocess(const cv::Mat& crop, bool isRtlAlphabet);
 
         /**
-         * Decodes the raw output tensor from the recognizer into a string.
+         * Decodes the raw output tensor from the recognizer into a string (CTC greedy decoding).
+         * Reuses the result text storage, no allocation is made once the buffers are big enough.
          * @param dictionary list of detectable characters.
          * @param boundingBox The original bounding box for the result.
          * @param isRtlAlphabet true if the text is right to left, false if not.
+         * @param numbersOnly true to decode only the number classes of the dictionary. The text is left empty if
+         * another character is more likely at any position.
          * @param output The raw output from the NCNN extractor.
-         * @return A packaged TextRecognizerResult.
+         * @param result Set to the decoded text, its bounding box and confidence.
          */
-        TextRecognizerResult decode(
-                const std::vector<std::string>& dictionary,
+        void decode(
+                const TextDictionary& dictionary,
                 const cv::Rect& boundingBox,
                 bool isRtlAlphabet,
-                const ncnn::Mat& output);
+                bool numbersOnly,
+                const ncnn::Mat& output,
+                TextRecognizerResult& result);
+
+        /**
+         * Finds the class with the highest score. The first one is returned in case of equality.
+         * @param scores The scores of each class.
+         * @param count The number of classes.
+         * @param bestScore Set to the highest score.
+         * @return The index of the class with the highest score.
+         */
+        static int argmax(const float* scores, int count, float& bestScore);
+
+        /**
+         * Finds the class with the highest score among the blank token and a subset of the classes.
+         * @param scores The scores of each class.
+         * @param count The number of classes.
+         * @param classes The indices of the classes to consider, in ascending order.
+         * @param bestScore Set to the highest score.
+         * @param totalScore Set to the sum of the scores of the blank token and of the considered classes.
+         * @return The index of the class with the highest score, 0 for the blank token.
+         */
+        static int argmax(
+                const float* scores,
+                int count,
+                const std::vector<int>& classes,
+                float& bestScore,
+                float& totalScore);
     };
 
 } // smartautoclicker
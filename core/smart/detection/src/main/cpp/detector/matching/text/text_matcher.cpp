@@ -19,7 +19,9 @@
 #include <opencv2/imgproc/imgproc_c.h>
 #include <cctype>
 #include <algorithm>
+#include <chrono>
 #include <limits>
+#include <cmath>
 
 #include "text_matcher.hpp"
 #include "../../../logs/log.h"
@@ -27,15 +29,86 @@
 
 using namespace smartautoclicker;
 
-bool TextMatcher::init(const std::string& detectionModelPath, const std::map<std::string, std::string>& recognitionModels) {
-    if (!recognitionModels.empty()) {
-        defaultRecognitionModelId = recognitionModels.begin()->first;
+bool TextMatcher::init(
+        const std::string& detectionModelPath,
+        const std::map<std::string, std::string>& recognitionModels,
+        bool warmUp,
+        InferencePrecision detectionPrecision,
+        InferencePrecision recognitionPrecision)
+{
+    numberRecognitionModelId.clear();
+    for (const char* modelId : numberRecognitionModelIds) {
+        if (recognitionModels.count(modelId) == 0) continue;
+        numberRecognitionModelId = modelId;
+        break;
+    }
+    if (numberRecognitionModelId.empty() && !recognitionModels.empty()) {
+        numberRecognitionModelId = recognitionModels.begin()->first;
+    }
+    textHeights.clear();
+    glyphReader.clear();
+
+    // Missing models must fail the initialization, they would never be ready once loaded in background
+    textLocator = std::make_unique<TextDetector>();
+    loadingTextLocator = {};
+    if (!areModelFilesPresent(detectionModelPath, "det", detectionPrecision)) {
+        LOGE("TextMatcher", "Can't init, text detection model files are missing in %s", detectionModelPath.c_str());
+        return false;
+    }
+
+    // Load the models in background, the matching can start immediately and will report them as not ready
+    loadingTextLocator = std::async(std::launch::async, [detectionModelPath, warmUp, detectionPrecision]() {
+        auto detector = std::make_unique<TextDetector>();
+        detector->init(detectionModelPath, warmUp, detectionPrecision);
+        return detector;
+    });
+
+    // Recognition models are loaded on their first use only, within the memory budget
+    return textRecognizer->init(recognitionModels, warmUp, recognitionPrecision);
+}
+
+bool TextMatcher::isModelReady(const std::string& recognitionModelId) {
+    return prepareModels(recognitionModelId) == ModelState::READY;
+}
+
+ModelState TextMatcher::prepareModels(const std::string& recognitionModelId) {
+    if (loadingTextLocator.valid()
+        && loadingTextLocator.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        textLocator = loadingTextLocator.get();
+        textLocator->setExecutionPolicy(executionPolicy);
+        textLocator->setCancellationToken(cancellationToken);
     }
-    return textLocator->init(detectionModelPath) && textRecognizer->init(recognitionModels);
+
+    ModelState recognitionState = textRecognizer->prepareModel(recognitionModelId);
+    if (recognitionState == ModelState::UNAVAILABLE) return ModelState::UNAVAILABLE;
+    if (loadingTextLocator.valid()) return ModelState::LOADING;
+    if (!textLocator->isInitialized) return ModelState::UNAVAILABLE;
+
+    return recognitionState;
+}
+
+void TextMatcher::collectMetrics(DetectionMetrics& metrics) const {
+    textLocator->collectMetrics(metrics);
+    textRecognizer->collectMetrics(metrics);
+    metrics.singleLineFastPaths = singleLineFastPathCount;
+    metrics.skippedTextRecognitions = skippedRecognitionCount;
+    metrics.glyphTemplateReads = glyphReadCount;
+}
+
+void TextMatcher::setExecutionPolicy(const ExecutionPolicy& policy) {
+    executionPolicy = policy;
+    textLocator->setExecutionPolicy(policy);
+    textRecognizer->setExecutionPolicy(policy);
+}
+
+void TextMatcher::setRecognitionMemoryBudget(size_t budget) {
+    textRecognizer->setMemoryBudget(budget);
 }
 
-bool TextMatcher::isInitialized() const {
-    return textLocator->isInitialized && textRecognizer->isInitialized;
+void TextMatcher::setCancellationToken(const CancellationToken* token) {
+    cancellationToken = token;
+    textLocator->setCancellationToken(token);
+    textRecognizer->setCancellationToken(token);
 }
 
 void TextMatcher::clearResults() {
@@ -51,30 +124,91 @@ TextMatchingResult* TextMatcher::matchText(
 {
     clearResults();
 
-    if (!isInitialized() || !isRoiValidForMatching(screenImage.getRoi(), detectionArea)) {
-        LOGE("TextMatcher", "Can't match text, invalid state or RoI (x=%d, y=%d, w=%d, h=%d)",
+    singleConditionText[0] = conditionText;
+    singleThreshold[0] = threshold;
+    auto results = matchTexts(screenImage, singleConditionText, recognitionModelId, detectionArea, singleThreshold);
+
+    currentMatchingResult = results->front();
+    return &currentMatchingResult;
+}
+
+std::vector<TextMatchingResult>* TextMatcher::matchTexts(
+        const ScreenImage& screenImage,
+        const std::vector<std::string>& conditionTexts,
+        const std::string& recognitionModelId,
+        const cv::Rect& detectionArea,
+        const std::vector<int>& thresholds)
+{
+    const size_t targetCount = conditionTexts.size();
+    currentMatchingResults.resize(targetCount);
+    for (auto& result : currentMatchingResults) result.reset();
+
+    if (!isRoiValidForMatching(screenImage.getRoi(), detectionArea)) {
+        LOGE("TextMatcher", "Can't match text, invalid RoI (x=%d, y=%d, w=%d, h=%d)",
              detectionArea.x, detectionArea.y, detectionArea.width, detectionArea.height);
-        return &currentMatchingResult;
+        return &currentMatchingResults;
     }
 
-    // Recognize the text in the regions detected
-    auto recognizerResults = recognizeText(screenImage, detectionArea, recognitionModelId);
+    ModelState modelState = prepareModels(recognitionModelId);
+    if (modelState == ModelState::LOADING) {
+        for (auto& result : currentMatchingResults) result.markResultAsNotReady();
+        return &currentMatchingResults;
+    }
+    if (modelState == ModelState::UNAVAILABLE) {
+        LOGE("TextMatcher", "Can't match text, models are not available for %s", recognitionModelId.c_str());
+        return &currentMatchingResults;
+    }
 
-    // Parse results and find matching candidate, if any
-    for (const auto& recognizerResult: recognizerResults) {
-        float score = bestSubstringSimilarity(recognizerResult.text,conditionText) * 100;
-        LOGD("TextMatcher", "Score=%f; recognized=%s", score, recognizerResult.text.c_str());
+    if (thresholds.size() != targetCount) {
+        LOGE("TextMatcher", "Can't match texts, %zu texts for %zu thresholds", targetCount, thresholds.size());
+        return &currentMatchingResults;
+    }
+    if (targetCount == 0) return &currentMatchingResults;
 
-        if (score < currentMatchingResult.getResultConfidence()) continue;
+    cv::Mat screenCrop = getScreenCrop(screenImage, detectionArea);
+    if (screenCrop.empty()) return &currentMatchingResults;
 
-        currentMatchingResult.updateResults(detectionArea, recognizerResult.boundingBox, score);
-        if ((int) score >= threshold) {
-            currentMatchingResult.markResultAsDetected();
-            break;
+    // Find all regions containing text and sort them by order of likelihood to contain the targets
+    auto detectorResults = detectText(screenCrop, detectionArea);
+    if (CancellationToken::isCancelled(cancellationToken)) return &currentMatchingResults;
+    sortByTargetsLikelihood(detectorResults, conditionTexts);
+
+    if (!targetsAutomaton.isBuiltFor(conditionTexts)) targetsAutomaton.build(conditionTexts);
+    if (targetsSimilarities.size() < targetCount) targetsSimilarities.resize(targetCount);
+
+    // Recognize the text in the regions detected, until a matching candidate is found for all targets
+    size_t remainingTargets = targetCount;
+    TextRecognizerResult recognizerResult;
+    for (size_t i = 0; i < recognitionOrder.size() && remainingTargets > 0; i++) {
+        if (CancellationToken::isCancelled(cancellationToken)) break;
+
+        const auto& detectorResult = detectorResults[recognitionOrder[i].second];
+        if (!textRecognizer->recognizeText(recognitionModelId, detectorResult, recognizerResult)) continue;
+
+        // Exact occurrences of all targets in a single pass, approximate comparison for the others
+        targetsAutomaton.findAll(recognizerResult.text, exactMatches);
+        for (size_t target = 0; target < targetCount; target++) {
+            auto& result = currentMatchingResults[target];
+            if (result.isDetected()) continue;
+
+            float score = exactMatches[target] ? 100.f : targetsSimilarities[target].bestApproximateSubstringSimilarity(
+                    recognizerResult.text, conditionTexts[target]) * 100;
+            LOGD("TextMatcher", "Score=%f; recognized=%s; target=%s",
+                 score, recognizerResult.text.c_str(), conditionTexts[target].c_str());
+
+            if (score < result.getResultConfidence()) continue;
+
+            result.updateResults(detectionArea, recognizerResult.boundingBox, score);
+            if ((int) score >= thresholds[target]) {
+                result.markResultAsDetected();
+                remainingTargets--;
+            }
         }
+
+        if (remainingTargets == 0) skippedRecognitionCount += recognitionOrder.size() - i - 1;
     }
 
-    return &currentMatchingResult;
+    return &currentMatchingResults;
 }
 
 TextMatchingResult* TextMatcher::matchNumber(
@@ -85,19 +219,41 @@ TextMatchingResult* TextMatcher::matchNumber(
 ) {
     clearResults();
 
-    if (!isInitialized() || !isRoiValidForMatching(screenImage.getRoi(), detectionArea)) {
-        LOGE("TextMatcher", "Can't match text, invalid state or RoI (x=%d, y=%d, w=%d, h=%d)",
+    if (!isRoiValidForMatching(screenImage.getRoi(), detectionArea)) {
+        LOGE("TextMatcher", "Can't match number, invalid RoI (x=%d, y=%d, w=%d, h=%d)",
              detectionArea.x, detectionArea.y, detectionArea.width, detectionArea.height);
         return &currentMatchingResult;
     }
 
-    if (defaultRecognitionModelId.empty()) {
+    if (numberRecognitionModelId.empty()) {
         LOGE("TextMatcher", "Can't match number, no recognition model available");
         return &currentMatchingResult;
     }
 
+    ModelState modelState = prepareModels(numberRecognitionModelId);
+    if (modelState == ModelState::LOADING) {
+        currentMatchingResult.markResultAsNotReady();
+        return &currentMatchingResult;
+    }
+    if (modelState == ModelState::UNAVAILABLE) {
+        LOGE("TextMatcher", "Can't match number, models are not available");
+        return &currentMatchingResult;
+    }
+
+    cv::Mat screenCrop = getScreenCrop(screenImage, detectionArea);
+    if (screenCrop.empty()) return &currentMatchingResult;
+
+    // Counters areas are usually drawn around a single line, try to skip the text detection
+    if (matchSingleLineNumber(screenCrop, detectionArea, threshold, numberFormat)) {
+        singleLineFastPathCount++;
+        return &currentMatchingResult;
+    }
+
+    if (CancellationToken::isCancelled(cancellationToken)) return &currentMatchingResult;
+
     // Recognize the text in the detectionArea
-    auto recognizerResults = recognizeText(screenImage, detectionArea, defaultRecognitionModelId);
+    auto recognizerResults = recognizeText(screenCrop, detectionArea, numberRecognitionModelId, true);
+    if (CancellationToken::isCancelled(cancellationToken)) return &currentMatchingResult;
 
     // Parse results and find matching candidate, if any
     for (const auto& recognizerResult: recognizerResults) {
@@ -135,119 +291,140 @@ bool TextMatcher::isRoiValidForMatching(const cv::Rect& screenRoi, const cv::Rec
     return true;
 }
 
-std::vector<TextRecognizerResult> TextMatcher::recognizeText(
-        const ScreenImage& screenImage,
+bool TextMatcher::matchSingleLineNumber(
+        const cv::Mat& screenCrop,
         const cv::Rect& detectionArea,
-        const std::string& recognitionModelId
+        int threshold,
+        NumberFormat numberFormat
 ) {
-    // Get the region of interest within the screen image and convert to RGB
-    cv::Mat screenCrop = screenImage.cropColor(detectionArea);
-    cv::Mat rgbScreenCrop;
-    cv::cvtColor(screenCrop, rgbScreenCrop, cv::COLOR_RGBA2RGB);
-    if (rgbScreenCrop.empty()) {
-        LOGE("TextMatcher", "Can't get rgb screen crop");
-        return {};
+    cv::Rect lineBox;
+    if (!lineAnalyzer.findSingleLine(screenCrop, lineBox)) return false;
+    cv::Mat lineCrop = screenCrop(lineBox);
+
+    // Counters are drawn with the same font on each frame, try to read them with the glyphs learned previously.
+    // The reader has its own correlation threshold, the score is the OCR confidence the glyphs were learned with,
+    // lowered by the correlation of the glyphs on this frame.
+    float glyphConfidence;
+    if (glyphReader.read(detectionArea, lineCrop, glyphText, glyphConfidence) && isNumber(glyphText)
+            && (int) (glyphConfidence * 100) >= threshold) {
+        float score = glyphConfidence * 100;
+        auto recognizedNumber = stringToDouble(glyphText, numberFormat);
+        LOGD("TextMatcher", "Glyphs: Score=%f; recognized=%f", score, recognizedNumber);
+
+        currentMatchingResult.updateResults(detectionArea, lineBox, score, recognizedNumber);
+        currentMatchingResult.markResultAsDetected();
+        glyphReadCount++;
+        return true;
     }
 
-    // Find all regions containing text within the screen crop
-    auto detectorResults = textLocator->detectText(rgbScreenCrop);
-
-    // Recognize the text in the regions detected
-    return textRecognizer->recognizeText(recognitionModelId, detectorResults);
-}
-
-float TextMatcher::bestSubstringSimilarity(const std::string& recognized, const std::string& target, float minSimilarity) {
-    if (recognized.empty() || target.empty()) return 0.f;
-
-    // Fast exact substring match
-    if (recognized.find(target) != std::string::npos) return 1.f;
+    // Feed the line directly to the recognizer
+    if (CancellationToken::isCancelled(cancellationToken)) return false;
+    std::vector<TextDetectorResult> lineResults = { TextDetectorResult(lineBox, lineCrop) };
+    auto recognizerResults = textRecognizer->recognizeText(numberRecognitionModelId, lineResults, true);
+    if (recognizerResults.empty() || !isNumber(recognizerResults.front().text)) return false;
 
-    const int targetLen = static_cast<int>(target.size());
-    const int recognizedLen = static_cast<int>(recognized.size());
+    // Low confidence may be caused by a wrong line analysis, let the text detection decide
+    const auto& recognizerResult = recognizerResults.front();
+    float score = recognizerResult.confidence * 100;
+    if ((int) score < threshold) return false;
 
-    // Fast path
-    if (recognizedLen <= targetLen + 2) return similarity(recognized, target, minSimilarity);
-
-    // Allow small OCR insertions/deletions
-    float bestScore = 0.f;
-    const int minWindow = std::max(1, targetLen - 2);
-    const int maxWindow = std::min(recognizedLen, targetLen + 4);
+    if (recognizerResult.confidence >= minGlyphLearningConfidence) {
+        glyphReader.learn(detectionArea, lineCrop, recognizerResult.text, recognizerResult.confidence);
+    }
 
-    std::string window;
-    for (int windowSize = minWindow; windowSize <= maxWindow; ++windowSize) {
-        for (int start = 0; start <= recognizedLen - windowSize; ++start) {
-            window.assign(recognized.data() + start, windowSize);
+    auto recognizedNumber = stringToDouble(recognizerResult.text, numberFormat);
+    LOGD("TextMatcher", "Single line: Score=%f; recognized=%f", score, recognizedNumber);
 
-            float score = similarity(window, target, minSimilarity);
-            if (score > bestScore) {
-                bestScore = score;
+    currentMatchingResult.updateResults(detectionArea, recognizerResult.boundingBox, score, recognizedNumber);
+    currentMatchingResult.markResultAsDetected();
+    return true;
+}
 
-                // Early success exit
-                if (bestScore >= 0.95f) return bestScore;
-            }
-        }
+cv::Mat TextMatcher::getScreenCrop(const ScreenImage& screenImage, const cv::Rect& detectionArea) {
+    // Get the region of interest within the screen image, the OCR networks inputs are built directly from it
+    cv::Mat screenCrop = screenImage.cropColor(detectionArea);
+    if (screenCrop.empty()) {
+        LOGE("TextMatcher", "Can't get screen crop");
     }
 
-    return bestScore;
+    return screenCrop;
 }
 
-float TextMatcher::similarity(const std::string &recognized, const std::string &target, float minSimilarity) {
-    if (recognized.empty() || target.empty()) return 0.f;
+std::vector<TextDetectorResult> TextMatcher::detectText(const cv::Mat& screenCrop, const cv::Rect& detectionArea) {
+    auto detectorResults = textLocator->detectText(screenCrop, textHeights.getExpectedHeight(detectionArea));
 
-    const int n = static_cast<int>(recognized.size());
-    const int m = static_cast<int>(target.size());
-    const int maxLen = std::max(n, m);
+    // A cancelled detection found nothing, but it doesn't tell anything about the text height
+    if (!CancellationToken::isCancelled(cancellationToken)) {
+        textHeights.update(detectionArea, textLocator->getLastTextHeight());
+    }
 
-    // Early impossible length check
-    int maxAllowedDistance = static_cast<int>((1.f - minSimilarity) * maxLen);
-    if (std::abs(n - m) > maxAllowedDistance) return 0.f;
+    return detectorResults;
+}
 
-    comparisonPrevPrevRow.resize(m + 1);
-    comparisonPrevRow.resize(m + 1);
-    comparisonCurrRow.resize(m + 1);
+std::vector<TextRecognizerResult> TextMatcher::recognizeText(
+        const cv::Mat& screenCrop,
+        const cv::Rect& detectionArea,
+        const std::string& recognitionModelId,
+        bool numbersOnly
+) {
+    // Find all regions containing text within the screen crop
+    auto detectorResults = detectText(screenCrop, detectionArea);
 
-    for (int j = 0; j <= m; ++j) comparisonPrevRow[j] = j;
+    // Recognize the text in the regions detected
+    return textRecognizer->recognizeText(recognitionModelId, detectorResults, numbersOnly);
+}
 
-    for (int i = 1; i <= n; ++i) {
-        comparisonCurrRow[0] = i;
-        int rowMin = comparisonCurrRow[0];
+void TextMatcher::sortByTargetsLikelihood(
+        const std::vector<TextDetectorResult>& detectorResults,
+        const std::vector<std::string>& targets
+) {
+    targetsLengths.clear();
+    for (const auto& target : targets) targetsLengths.push_back(countCodePoints(target));
+
+    recognitionOrder.clear();
+    recognitionOrder.reserve(detectorResults.size());
+    for (size_t i = 0; i < detectorResults.size(); i++) {
+        float likelihood = 0.f;
+        for (size_t targetLength : targetsLengths) {
+            likelihood = std::max(likelihood, getTargetLikelihood(detectorResults[i], targetLength));
+        }
+        recognitionOrder.emplace_back(likelihood, i);
+    }
 
-        char ca = normalizeChar(recognized[i - 1]);
-        for (int j = 1; j <= m; ++j) {
-            char cb = normalizeChar(target[j - 1]);
+    // Stable, keeps the detection order for boxes of equal likelihood
+    std::stable_sort(recognitionOrder.begin(), recognitionOrder.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+}
 
-            int cost = (ca == cb) ? 0 : 1;
+float TextMatcher::getTargetLikelihood(const TextDetectorResult& detectorResult, size_t targetLength) {
+    const cv::Mat& crop = detectorResult.crop;
+    if (crop.empty() || targetLength == 0) return 0.f;
 
-            int deletion = comparisonPrevRow[j] + 1;
-            int insertion = comparisonCurrRow[j - 1] + 1;
-            int substitution = comparisonPrevRow[j - 1] + cost;
-            int value = std::min({ deletion, insertion, substitution });
+    // Vertical boxes are already rotated in their crop, use it instead of the bounding box
+    const auto cropWidth = static_cast<float>(crop.cols);
+    const auto cropHeight = static_cast<float>(crop.rows);
 
-            // Damerau transposition
-            if (i > 1 && j > 1 && ca == normalizeChar(target[j - 2]) && normalizeChar(recognized[i - 2]) == cb) {
-                value = std::min(value, comparisonPrevPrevRow[j - 2] + 1);
-            }
+    // A box narrower than the target can hardly contain it. A wider one can, as the target can be a part of it.
+    float expectedAspectRatio = static_cast<float>(targetLength) * averageCharAspectRatio;
+    float aspectRatio = cropWidth / cropHeight;
+    float aspectLikelihood = aspectRatio < expectedAspectRatio
+            ? (aspectRatio / expectedAspectRatio) * (aspectRatio / expectedAspectRatio)
+            : std::sqrt(expectedAspectRatio / aspectRatio);
 
-            comparisonCurrRow[j] = value;
-            rowMin = std::min(rowMin, value);
-        }
+    // Small texts are less likely to be recognized correctly
+    float sizeLikelihood = std::min(1.f, cropHeight / reliableTextHeight);
 
-        // Early exit
-        if (rowMin > maxAllowedDistance) return 0.f;
+    return detectorResult.score * aspectLikelihood * sizeLikelihood;
+}
 
-        std::swap(comparisonPrevPrevRow, comparisonPrevRow);
-        std::swap(comparisonPrevRow, comparisonCurrRow);
+size_t TextMatcher::countCodePoints(const std::string& text) {
+    size_t count = 0;
+    for (char c : text) {
+        // Skip UTF-8 continuation bytes
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) count++;
     }
 
-    int distance = comparisonPrevRow[m];
-
-    float score = 1.f - (float)distance / (float)maxLen;
-    return std::max(0.f, score);
-}
-
-char TextMatcher::normalizeChar(char c) {
-    if (c >= 'A' && c <= 'Z') return static_cast<char>(c + 32);
-    return c;
+    return count;
 }
 
 bool TextMatcher::isNumber(const std::string& text) {
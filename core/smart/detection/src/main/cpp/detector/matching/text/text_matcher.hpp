@@ -18,14 +18,22 @@
 #define KLICK_R_TEXT_MATCHER_HPP
 
 #include <opencv2/core/types.hpp>
+#include <future>
 #include <map>
 #include <net.h>
 #include <limits>
 
 #include "text_matching_result.hpp"
+#include "text_patterns_automaton.hpp"
+#include "text_similarity.hpp"
 #include "detection/text_detector.hpp"
+#include "detection/text_height_tracker.hpp"
+#include "detection/text_line_analyzer.hpp"
+#include "recognition/glyph_template_reader.hpp"
 #include "recognition/text_recognizer.hpp"
 #include "../../images/screen_image.hpp"
+#include "../../detection_metrics.hpp"
+#include "../../execution_policy.hpp"
 
 namespace smartautoclicker {
 
@@ -46,21 +54,77 @@ namespace smartautoclicker {
     private:
         /** Handles the localization of text bounding boxes. */
         std::unique_ptr<TextDetector> textLocator = std::make_unique<TextDetector>();
+        /** The text detector being loaded in background, valid until it is taken into textLocator. */
+        std::future<std::unique_ptr<TextDetector>> loadingTextLocator;
         /** Handles the conversion of image crops to text. */
         std::unique_ptr<TextRecognizer> textRecognizer = std::make_unique<TextRecognizer>();
+        /** Finds single text lines, allowing to skip the text detection. */
+        TextLineAnalyzer lineAnalyzer;
+        /** Learns the height of the text in each detection area, to adapt the text detection resolution. */
+        TextHeightTracker textHeights;
+        /** Reads the numbers of the detection areas with the glyphs learned from the previous recognitions. */
+        GlyphTemplateReader glyphReader;
+        /** Reusable buffer for the text read by the glyphReader. */
+        std::string glyphText;
 
-        /** Buffer for Levenshtein distance calculations (previous row). */
-        std::vector<int> comparisonPrevRow;
-        /** Buffer for Levenshtein distance calculations (current row). */
-        std::vector<int> comparisonCurrRow;
-        /** Buffer for Levenshtein distance calculations (two rows back). */
-        std::vector<int> comparisonPrevPrevRow;
+        /** Number of number matching resolved on a single line, without the text detection. */
+        uint64_t singleLineFastPathCount = 0;
+        /** Number of detected text boxes not recognized because a match was found before them. */
+        uint64_t skippedRecognitionCount = 0;
+        /** Number of number matching resolved with the learned glyphs, without the text recognition. */
+        uint64_t glyphReadCount = 0;
+
+        /** Reusable buffer for the recognition order of the detected boxes, as (likelihood, box index). */
+        std::vector<std::pair<float, size_t>> recognitionOrder;
+
+        /**
+         * Average width/height ratio of a character in a detected text box, including the box margins.
+         * Used to estimate the size of the box containing the text to match.
+         */
+        static constexpr float averageCharAspectRatio = 0.4f;
+        /** Height of a detected text box, in pixels, below which the recognition is less reliable. */
+        static constexpr float reliableTextHeight = 16.f;
+        /** Minimum confidence of a recognized number to learn its glyphs. */
+        static constexpr float minGlyphLearningConfidence = 0.9f;
+
+        /** Finds the exact occurrences of the target texts in the recognized texts. */
+        TextPatternsAutomaton targetsAutomaton;
+        /** Compares the recognized texts with each target text, in the target texts order. */
+        std::vector<TextSimilarity> targetsSimilarities;
 
         /** Stores the result of the most recent match operation. */
         TextMatchingResult currentMatchingResult;
+        /** Stores the results of the most recent multi targets match operation, in the target texts order. */
+        std::vector<TextMatchingResult> currentMatchingResults;
+
+        /** Reusable buffers for a single target match operation. */
+        std::vector<std::string> singleConditionText = std::vector<std::string>(1);
+        std::vector<int> singleThreshold = std::vector<int>(1);
+        /** Reusable buffer for the length of each target text. */
+        std::vector<size_t> targetsLengths;
+        /** Reusable buffer for the target texts exactly found in a recognized text. */
+        std::vector<bool> exactMatches;
+
+        /**
+         * Identifiers of the recognition models preferred for the numbers matching, in order of preference.
+         * A dedicated digits model has a very small output, and the latin model the smallest generic dictionary.
+         */
+        static constexpr const char* numberRecognitionModelIds[] = { "DIGITS", "LATIN" };
 
-        /** Identifier of the first loaded recognition model, used for generic matching (like numbers). */
-        std::string defaultRecognitionModelId;
+        /** Identifier of the recognition model used for the numbers matching. */
+        std::string numberRecognitionModelId;
+        /** How the inferences use the CPU, applied to the text detectors once loaded. */
+        ExecutionPolicy executionPolicy;
+        /** Checked between the matching stages and the text boxes, applied to the text detectors once loaded. */
+        const CancellationToken* cancellationToken = nullptr;
+
+        /**
+         * Get the state of the models required for a text matching, starting their loading in background if needed.
+         * Takes the text detector once its background loading is done.
+         * @param recognitionModelId The identifier of the recognition model.
+         * @return READY if the detection and recognition models can be used.
+         */
+        ModelState prepareModels(const std::string& recognitionModelId);
 
         /**
          * Checks if the provided text represents a numeric value.
@@ -79,61 +143,138 @@ namespace smartautoclicker {
         static double stringToDouble(const std::string& text, NumberFormat format);
 
         /**
-         * Runs the text detection and recognition on a specific area of the screen.
+         * Get a specific area of the screen, as a RGBA view on the screen image.
          * @param screenImage The source screen capture.
+         * @param detectionArea The region of the screen to crop.
+         *
+         * @return The RGBA crop, or an empty Mat on error.
+         */
+        static cv::Mat getScreenCrop(const ScreenImage& screenImage, const cv::Rect& detectionArea);
+
+        /**
+         * Runs the text detection on a RGBA crop of the screen, at the resolution fitting the text previously
+         * detected in the same area.
+         * @param screenCrop The RGBA crop of the region of the screen to search in.
+         * @param detectionArea The region of the screen to search in.
+         *
+         * @return A list of of detected text boxes with their relevant crops.
+         */
+        std::vector<TextDetectorResult> detectText(const cv::Mat& screenCrop, const cv::Rect& detectionArea);
+
+        /**
+         * Runs the text detection and recognition on a RGBA crop of the screen.
+         * @param screenCrop The RGBA crop of the region of the screen to search in.
          * @param detectionArea The region of the screen to search in.
          * @param recognitionModelId The identifier of the recognition model to use.
+         * @param numbersOnly true to recognize only the digits and number separators.
          *
          * @return A list of recognition results containing the text and confidence for each detected block.
          */
         std::vector<TextRecognizerResult> recognizeText(
-                const ScreenImage& screenImage,
+                const cv::Mat& screenCrop,
                 const cv::Rect& detectionArea,
-                const std::string& recognitionModelId);
+                const std::string& recognitionModelId,
+                bool numbersOnly);
 
         /**
-         * Calculates the similarity between two strings.
-         * @param recognized The text recognized by the OCR.
-         * @param target The expected text.
-         * @param minSimilarity The threshold to consider a match successful.
+         * Tries to find a number in a detection area containing a single line of text, without running the text
+         * detection. The line is read with the learned glyphs if possible, and the recognized numbers are learned.
+         * Results are stored in the current matching result.
+         * @param screenCrop The RGBA crop of the region of the screen to search in.
+         * @param detectionArea The region of the screen to search in.
+         * @param threshold Confidence threshold for the recognition.
+         * @param numberFormat How to interpret decimal and thousands separators.
          *
-         * @return A value between 0.0 (no match) and 1.0 (perfect match).
+         * @return true if a number has been found with a confidence above the threshold, false if the full text
+         * detection pipeline should be used.
          */
-        float similarity(const std::string& recognized, const std::string& target, float minSimilarity = 0.80f);
+        bool matchSingleLineNumber(
+                const cv::Mat& screenCrop,
+                const cv::Rect& detectionArea,
+                int threshold,
+                NumberFormat numberFormat);
 
         /**
-         * Finds the best substring match within the recognized text.
-         * Useful when the target text is part of a larger detected block.
-         * @param recognized The text recognized by the OCR.
-         * @param target The text to search for.
-         * @param minSimilarity The threshold for a valid match.
+         * Sorts the detected text boxes by likelihood to contain one of the target texts into recognitionOrder, using
+         * the detection confidence, the box size and the aspect ratio implied by the targets length.
+         * @param detectorResults The detected text boxes.
+         * @param targets The texts to search for.
+         */
+        void sortByTargetsLikelihood(
+                const std::vector<TextDetectorResult>& detectorResults,
+                const std::vector<std::string>& targets);
+
+        /**
+         * Estimates the likelihood for a detected text box to contain the target text.
+         * @param detectorResult The detected text box.
+         * @param targetLength The number of characters of the target text.
          *
-         * @return The highest similarity score found.
+         * @return A value between 0.0 (unlikely) and 1.0 (likely).
          */
-        float bestSubstringSimilarity(const std::string& recognized, const std::string& target, float minSimilarity = 0.80f);
+        static float getTargetLikelihood(const TextDetectorResult& detectorResult, size_t targetLength);
 
         /**
-         * Normalizes a character for comparison (e.g., case folding).
-         * @param c The character to normalize.
+         * Counts the characters of an UTF-8 encoded string.
+         * @param text The text to count the characters of.
          *
-         * @return The normalized character.
+         * @return The number of code points in the text.
          */
-        static char normalizeChar(char c);
+        static size_t countCodePoints(const std::string& text);
 
     public:
         /** Resets the matcher state for a new search. */
         void clearResults();
 
         /**
-         * Initializes the underlying detector and recognizer.
+         * Initializes the underlying detector and recognizer, and starts loading the detection model in background.
+         * Each recognition model is loaded in background on its first use by a matching. Until the models of a
+         * matching are loaded, its results are marked as not ready.
          * @param detectionModelPath Path to the detection model folder.
-         * @param recognitionModelPath Path to the recognition model directory.
+         * @param recognitionModels Map of recognition model identifier to their folder path.
+         * @param warmUp true to run a dummy inference with each model after loading it, in background.
+         * @param detectionPrecision The precision of the text detection inferences.
+         * @param recognitionPrecision The precision of the text recognition inferences.
          *
          * @return true if both components initialized successfully.
          */
-        bool init(const std::string& detectionModelPath, const std::map<std::string, std::string>& recognitionModels);
+        bool init(
+                const std::string& detectionModelPath,
+                const std::map<std::string, std::string>& recognitionModels,
+                bool warmUp,
+                InferencePrecision detectionPrecision,
+                InferencePrecision recognitionPrecision);
+
+        /**
+         * Tells if the models for a text matching are loaded, starting their loading in background if needed.
+         * @param recognitionModelId The identifier of the recognition model provided with [init].
+         * @return true if the text detection and the recognition model are loaded, false if not.
+         */
+        bool isModelReady(const std::string& recognitionModelId);
+
+        /**
+         * Fills the text matching related counters.
+         * @param metrics The metrics to fill.
+         */
+        void collectMetrics(DetectionMetrics& metrics) const;
 
-        bool isInitialized() const;
+        /**
+         * Set how the text detection and recognition inferences use the CPU.
+         * @param policy The number of threads of the inferences, and the cores they are running on.
+         */
+        void setExecutionPolicy(const ExecutionPolicy& policy);
+
+        /**
+         * Set the maximum memory used by the loaded recognition models.
+         * @param budget The memory budget in bytes, or 0 to keep all models loaded.
+         */
+        void setRecognitionMemoryBudget(size_t budget);
+
+        /**
+         * Set the token cancelling the matching. Once cancelled, the matching stops at the next stage or text box,
+         * and its results are not detected.
+         * @param token The token, or nullptr to never cancel.
+         */
+        void setCancellationToken(const CancellationToken* token);
 
         static bool isRoiValidForMatching(const cv::Rect& screenRoi, const cv::Rect& roi);
 
@@ -154,8 +295,28 @@ namespace smartautoclicker {
                 const cv::Rect& detectionArea,
                 int threshold);
 
+        /**
+         * Performs text detection and recognition once on a specific area of the screen, and compares the recognized
+         * texts with several target texts.
+         *
+         * @param screenImage The source screen capture.
+         * @param conditionTexts The texts to look for.
+         * @param recognitionModelId The identifier of the recognition model provided with [init].
+         * @param detectionArea The region of the screen to search in.
+         * @param thresholds Confidence threshold for each text, in conditionTexts order.
+         *
+         * @return The results for each text, in conditionTexts order.
+         */
+        std::vector<TextMatchingResult>* matchTexts(
+                const ScreenImage& screenImage,
+                const std::vector<std::string>& conditionTexts,
+                const std::string& recognitionModelId,
+                const cv::Rect& detectionArea,
+                const std::vector<int>& thresholds);
+
         /**
          * Performs text detection and recognition on a specific area of the screen to find a number.
+         * The recognition only decodes digits and separators, with the DIGITS model if provided with [init].
          * Results are stored internally and can be retrieved with getMatchingResults().
          *
          * @param screenImage The source screen capture.
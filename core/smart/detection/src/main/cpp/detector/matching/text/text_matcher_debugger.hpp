@@ -28,7 +28,7 @@
 
 inline void saveScoreMap(const cv::Mat& scoreMap) {}
 inline void saveBinaryMap(const cv::Mat& binary) {}
-inline void saveVisualDebug(const cv::Mat& roi, const std::vector<std::vector<cv::Point>>& contours, float scaleX, float scaleY) {}
+inline void saveVisualDebug(const cv::Mat& roi, const std::vector<cv::Rect>& boxes, float scaleX, float scaleY) {}
 inline void saveCrops(const std::vector<smartautoclicker::TextDetectorResult>& results) {}
 
 #else
@@ -49,20 +49,15 @@ inline void saveBinaryMap(const cv::Mat& binary) {
 
 inline void saveVisualDebug(
         const cv::Mat& roi,
-        const std::vector<std::vector<cv::Point>>& contours,
+        const std::vector<cv::Rect>& boxes,
         float scaleX,
         float scaleY)
 {
     cv::Mat debugImage = roi.clone();
-    for (const auto& contour : contours) {
-        cv::RotatedRect rect = cv::minAreaRect(contour);
-        cv::Point2f pts[4];
-        rect.points(pts);
-        for (int j = 0; j < 4; j++) {
-            cv::Point2f p1(pts[j].x * scaleX, pts[j].y * scaleY);
-            cv::Point2f p2(pts[(j + 1) % 4].x * scaleX, pts[(j + 1) % 4].y * scaleY);
-            cv::line(debugImage, p1, p2, cv::Scalar(0, 255, 0), 2);
-        }
+    for (const auto& box : boxes) {
+        cv::Point2f p1(static_cast<float>(box.x) * scaleX, static_cast<float>(box.y) * scaleY);
+        cv::Point2f p2(static_cast<float>(box.br().x) * scaleX, static_cast<float>(box.br().y) * scaleY);
+        cv::rectangle(debugImage, p1, p2, cv::Scalar(0, 255, 0, 255), 2);
     }
     cv::imwrite("/sdcard/Download/ocr_boxes.png", debugImage);
 }
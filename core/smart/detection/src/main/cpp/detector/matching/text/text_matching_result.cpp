@@ -42,8 +42,20 @@ void TextMatchingResult::markResultAsDetected() {
     detected = true;
 }
 
+void TextMatchingResult::markResultAsNotReady() {
+    notReady = true;
+}
+
+void TextMatchingResult::markResultAsStale(int64_t resultAgeMs) {
+    stale = true;
+    ageMs = resultAgeMs;
+}
+
 void TextMatchingResult::reset() {
     detected = false;
+    notReady = false;
+    stale = false;
+    ageMs = 0;
     centerX = 0;
     centerY = 0;
     area.x = 0;
@@ -86,3 +98,14 @@ double TextMatchingResult::getRecognizedNumber() const {
     return recognizedNumber;
 }
 
+bool TextMatchingResult::isNotReady() const {
+    return notReady;
+}
+
+bool TextMatchingResult::isStale() const {
+    return stale;
+}
+
+int64_t TextMatchingResult::getResultAgeMs() const {
+    return ageMs;
+}
@@ -19,6 +19,7 @@
 #define KLICK_R_TEXT_MATCHING_RESULT_HPP
 
 #include <opencv2/core/types.hpp>
+#include <cstdint>
 #include "../../detection_result.hpp"
 
 namespace smartautoclicker {
@@ -28,6 +29,9 @@ namespace smartautoclicker {
         static constexpr double invalidNumber = std::numeric_limits<double>::lowest();
 
         bool detected;
+        bool notReady = false;
+        bool stale = false;
+        int64_t ageMs = 0;
         int centerX;
         int centerY;
         cv::Rect area;
@@ -41,6 +45,13 @@ namespace smartautoclicker {
                 float confidence,
                 double numberRecognized = invalidNumber);
         void markResultAsDetected();
+        /** Mark this result as not computed, because the required models are still loading. */
+        void markResultAsNotReady();
+        /**
+         * Mark this result as a copy of a previous frame result, the condition not being detected on this frame.
+         * @param resultAgeMs The time elapsed since the result was computed, in milliseconds.
+         */
+        void markResultAsStale(int64_t resultAgeMs);
         void reset();
 
         [[nodiscard]] bool isDetected() const override;
@@ -51,6 +62,9 @@ namespace smartautoclicker {
         [[nodiscard]] int getResultAreaWidth() const override;
         [[nodiscard]] int getResultAreaHeight() const override;
         [[nodiscard]] double getRecognizedNumber() const;
+        [[nodiscard]] bool isNotReady() const;
+        [[nodiscard]] bool isStale() const;
+        [[nodiscard]] int64_t getResultAgeMs() const;
     };
 } // smartautoclicker
 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <queue>
+
+#include "text_patterns_automaton.hpp"
+
+using namespace smartautoclicker;
+
+bool TextPatternsAutomaton::isBuiltFor(const std::vector<std::string>& patterns) const {
+    return !nodes.empty() && patterns == currentPatterns;
+}
+
+void TextPatternsAutomaton::build(const std::vector<std::string>& patterns) {
+    currentPatterns = patterns;
+    nodes.clear();
+    nodes.emplace_back();
+
+    // Trie of all patterns
+    for (size_t patternIndex = 0; patternIndex < patterns.size(); patternIndex++) {
+        const std::string& pattern = patterns[patternIndex];
+        if (pattern.empty()) continue;
+
+        int node = rootNode;
+        for (char c : pattern) {
+            auto byte = static_cast<unsigned char>(c);
+            int child = getChild(node, byte);
+            if (child == -1) {
+                child = static_cast<int>(nodes.size());
+                nodes[node].children.emplace_back(byte, child);
+                nodes.emplace_back();
+            }
+            node = child;
+        }
+        nodes[node].outputs.push_back(patternIndex);
+    }
+
+    // Failure links, breadth first so the failure node of each node is complete before it
+    std::queue<int> pending;
+    for (const auto& [byte, child] : nodes[rootNode].children) {
+        nodes[child].failure = rootNode;
+        pending.push(child);
+    }
+
+    while (!pending.empty()) {
+        const int node = pending.front();
+        pending.pop();
+
+        for (size_t i = 0; i < nodes[node].children.size(); i++) {
+            const auto [byte, child] = nodes[node].children[i];
+
+            int failure = nodes[node].failure;
+            while (failure != rootNode && getChild(failure, byte) == -1) failure = nodes[failure].failure;
+            int failureChild = getChild(failure, byte);
+            nodes[child].failure = (failureChild != -1 && failureChild != child) ? failureChild : rootNode;
+
+            const auto& failureOutputs = nodes[nodes[child].failure].outputs;
+            nodes[child].outputs.insert(nodes[child].outputs.end(), failureOutputs.begin(), failureOutputs.end());
+            pending.push(child);
+        }
+    }
+}
+
+void TextPatternsAutomaton::findAll(const std::string& text, std::vector<bool>& found) const {
+    found.assign(currentPatterns.size(), false);
+    if (nodes.empty()) return;
+
+    int node = rootNode;
+    for (char c : text) {
+        auto byte = static_cast<unsigned char>(c);
+
+        int child = getChild(node, byte);
+        while (child == -1 && node != rootNode) {
+            node = nodes[node].failure;
+            child = getChild(node, byte);
+        }
+        node = (child == -1) ? rootNode : child;
+
+        for (size_t patternIndex : nodes[node].outputs) found[patternIndex] = true;
+    }
+}
+
+int TextPatternsAutomaton::getChild(int node, unsigned char c) const {
+    for (const auto& [byte, child] : nodes[node].children) {
+        if (byte == c) return child;
+    }
+    return -1;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_PATTERNS_AUTOMATON_HPP
+#define KLICK_R_TEXT_PATTERNS_AUTOMATON_HPP
+
+#include <string>
+#include <vector>
+
+namespace smartautoclicker {
+
+    /**
+     * Aho-Corasick automaton finding the exact occurrences of several patterns in a text, in a single pass over it.
+     * Used as the fast path of the multi targets text matching, before the approximate comparison.
+     */
+    class TextPatternsAutomaton {
+
+    public:
+        /**
+         * Tells if the automaton has been built for the provided patterns.
+         * @param patterns The patterns to check.
+         */
+        [[nodiscard]] bool isBuiltFor(const std::vector<std::string>& patterns) const;
+
+        /**
+         * Builds the automaton for the provided patterns. Empty patterns never match.
+         * @param patterns The patterns to search for.
+         */
+        void build(const std::vector<std::string>& patterns);
+
+        /**
+         * Finds which patterns are contained in the text.
+         * @param text The text to search in.
+         * @param found Resized to the number of patterns, set to true for each pattern found in the text.
+         */
+        void findAll(const std::string& text, std::vector<bool>& found) const;
+
+    private:
+        /** Index of the root node. */
+        static constexpr int rootNode = 0;
+
+        struct Node {
+            /** Transitions to the child nodes, as (byte, node index). */
+            std::vector<std::pair<unsigned char, int>> children;
+            /** Node of the longest proper suffix of this node that is also in the automaton. */
+            int failure = rootNode;
+            /** Index of the patterns ending at this node, including the ones reached by the failure links. */
+            std::vector<size_t> outputs;
+        };
+
+        /** The patterns the automaton has been built for. */
+        std::vector<std::string> currentPatterns;
+        /** Nodes of the automaton, the first one being the root. */
+        std::vector<Node> nodes;
+
+        /**
+         * Get the child of a node for a byte.
+         * @return The index of the child node, or -1 if there is none.
+         */
+        [[nodiscard]] int getChild(int node, unsigned char c) const;
+    };
+}
+
+#endif //KLICK_R_TEXT_PATTERNS_AUTOMATON_HPP
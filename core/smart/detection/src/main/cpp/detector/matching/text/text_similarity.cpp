@@ -0,0 +1,309 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+#include "text_similarity.hpp"
+
+using namespace smartautoclicker;
+
+float TextSimilarity::bestSubstringSimilarity(const std::string& recognized, const std::string& target, float minSimilarity) {
+    if (recognized.empty() || target.empty()) return 0.f;
+
+    // Fast exact substring match
+    if (recognized.find(target) != std::string::npos) return 1.f;
+
+    return bestApproximateSubstringSimilarity(recognized, target, minSimilarity);
+}
+
+float TextSimilarity::bestApproximateSubstringSimilarity(
+        const std::string& recognized,
+        const std::string& target,
+        float minSimilarity
+) {
+    if (recognized.empty() || target.empty()) return 0.f;
+
+    setTarget(target);
+    decodeUtf8(recognized, recognizedCodePoints);
+
+    const int targetLen = static_cast<int>(targetCodePoints.size());
+    const int recognizedLen = static_cast<int>(recognizedCodePoints.size());
+    const char32_t* text = recognizedCodePoints.data();
+
+    // Fast path, compare the whole texts
+    if (recognizedLen <= targetLen + 2) {
+        float score;
+        computePrefixSimilarities(text, recognizedLen, recognizedLen, minSimilarity, &score);
+        return score;
+    }
+
+    // Allow small OCR insertions/deletions
+    const int minWindow = std::max(1, targetLen - 2);
+    const int maxWindow = std::min(recognizedLen, targetLen + 4);
+    const int windowCount = maxWindow - minWindow + 1;
+
+    // One pass per start offset gives the scores of all window sizes starting there
+    windowScores.assign(static_cast<size_t>(recognizedLen) * windowCount, 0.f);
+    for (int start = 0; start <= recognizedLen - minWindow; ++start) {
+        computePrefixSimilarities(
+                text + start,
+                minWindow,
+                std::min(maxWindow, recognizedLen - start),
+                minSimilarity,
+                windowScores.data() + static_cast<size_t>(start) * windowCount);
+    }
+
+    // Keep the scanning order of the windows, the first one above the early exit score is returned
+    float bestScore = 0.f;
+    for (int windowSize = minWindow; windowSize <= maxWindow; ++windowSize) {
+        for (int start = 0; start <= recognizedLen - windowSize; ++start) {
+            float score = windowScores[static_cast<size_t>(start) * windowCount + windowSize - minWindow];
+            if (score > bestScore) {
+                bestScore = score;
+
+                // Early success exit
+                if (bestScore >= 0.95f) return bestScore;
+            }
+        }
+    }
+
+    return bestScore;
+}
+
+void TextSimilarity::setTarget(const std::string& target) {
+    if (target == currentTarget && !targetCodePoints.empty()) return;
+
+    currentTarget = target;
+    decodeUtf8(target, targetCodePoints);
+    targetMasks.build(targetCodePoints);
+
+    const size_t wordCount = targetMasks.wordCount;
+    verticalPositive.resize(wordCount);
+    verticalNegative.resize(wordCount);
+    diagonalZero.resize(wordCount);
+}
+
+void TextSimilarity::computePrefixSimilarities(
+        const char32_t* text,
+        int minLength,
+        int maxLength,
+        float minSimilarity,
+        float* scores
+) {
+    const size_t wordCount = targetMasks.wordCount;
+    const uint64_t lastRowBit = 1ULL << ((targetMasks.length - 1) % 64);
+
+    // First column: the distance to the empty text is the target prefix length
+    std::fill(verticalPositive.begin(), verticalPositive.end(), ~0ULL);
+    std::fill(verticalNegative.begin(), verticalNegative.end(), 0ULL);
+    std::fill(diagonalZero.begin(), diagonalZero.end(), 0ULL);
+
+    const uint64_t* previousMatch = targetMasks.emptyMask.data();
+    int distance = static_cast<int>(targetMasks.length);
+
+    for (int j = 0; j < maxLength; ++j) {
+        const uint64_t* match = targetMasks.get(text[j]);
+
+        // First row: the distance from the empty target is the text prefix length
+        uint64_t horizontalPositiveCarry = 1;
+        uint64_t horizontalNegativeCarry = 0;
+        uint64_t transpositionCarry = 0;
+        uint64_t additionCarry = 0;
+
+        for (size_t w = 0; w < wordCount; ++w) {
+            const uint64_t pm = match[w];
+            const uint64_t vp = verticalPositive[w];
+            const uint64_t vn = verticalNegative[w];
+
+            // Adjacent transpositions: current char matches the previous target position and the other way around
+            const uint64_t transposition = ~diagonalZero[w] & pm;
+            const uint64_t transpositionShifted = (transposition << 1) | transpositionCarry;
+            transpositionCarry = transposition >> 63;
+
+            // Multi-word addition of (pm & vp) + vp
+            const uint64_t addend = pm & vp;
+            const uint64_t partialSum = addend + vp;
+            const uint64_t sum = partialSum + additionCarry;
+            additionCarry = (partialSum < addend || sum < partialSum) ? 1 : 0;
+
+            const uint64_t d0 = (transpositionShifted & previousMatch[w]) | (sum ^ vp) | pm | vn;
+            const uint64_t hp = vn | ~(d0 | vp);
+            const uint64_t hn = d0 & vp;
+
+            if (w == wordCount - 1) {
+                if (hp & lastRowBit) distance++;
+                else if (hn & lastRowBit) distance--;
+            }
+
+            const uint64_t hpShifted = (hp << 1) | horizontalPositiveCarry;
+            horizontalPositiveCarry = hp >> 63;
+            const uint64_t hnShifted = (hn << 1) | horizontalNegativeCarry;
+            horizontalNegativeCarry = hn >> 63;
+
+            verticalPositive[w] = hnShifted | ~(d0 | hpShifted);
+            verticalNegative[w] = d0 & hpShifted;
+            diagonalZero[w] = d0;
+        }
+
+        previousMatch = match;
+
+        const int length = j + 1;
+        if (length >= minLength) {
+            scores[length - minLength] = toSimilarity(length, distance, getMinPrefixDistance(length), minSimilarity);
+        }
+    }
+}
+
+float TextSimilarity::toSimilarity(int length, int distance, int minDistance, float minSimilarity) const {
+    const int targetLength = static_cast<int>(targetMasks.length);
+    const int maxLength = std::max(length, targetLength);
+
+    // Impossible length, or comparison abandoned when no target prefix is close enough to the text
+    int maxAllowedDistance = getMaxAllowedDistance(maxLength, minSimilarity);
+    if (std::abs(length - targetLength) > maxAllowedDistance || minDistance > maxAllowedDistance) return 0.f;
+
+    float score = 1.f - (float)distance / (float)maxLength;
+    return std::max(0.f, score);
+}
+
+int TextSimilarity::getMinPrefixDistance(int length) const {
+    // Sum and minimum prefix sum of the vertical deltas, for each combination of 4 positive and 4 negative bits
+    struct NibbleDeltas { int8_t sum; int8_t minPrefix; };
+    static const std::array<NibbleDeltas, 256> nibbleDeltas = [] {
+        std::array<NibbleDeltas, 256> deltas {};
+        for (int positive = 0; positive < 16; ++positive) {
+            for (int negative = 0; negative < 16; ++negative) {
+                int sum = 0;
+                int minPrefix = 0;
+                for (int bit = 0; bit < 4; ++bit) {
+                    sum += ((positive >> bit) & 1) - ((negative >> bit) & 1);
+                    minPrefix = std::min(minPrefix, sum);
+                }
+                deltas[(positive << 4) | negative] = { static_cast<int8_t>(sum), static_cast<int8_t>(minPrefix) };
+            }
+        }
+        return deltas;
+    }();
+
+    // The first row value is the text length, each target position adds its vertical delta
+    int value = length;
+    int minValue = length;
+    size_t remaining = targetMasks.length;
+    for (size_t w = 0; w < targetMasks.wordCount; ++w) {
+        uint64_t positive = verticalPositive[w];
+        uint64_t negative = verticalNegative[w];
+        const size_t bits = std::min<size_t>(remaining, 64);
+        if (bits < 64) {
+            const uint64_t validBits = (1ULL << bits) - 1;
+            positive &= validBits;
+            negative &= validBits;
+        }
+
+        for (size_t bit = 0; bit < bits; bit += 4) {
+            const NibbleDeltas& deltas = nibbleDeltas[((positive & 0xF) << 4) | (negative & 0xF)];
+            minValue = std::min(minValue, value + deltas.minPrefix);
+            value += deltas.sum;
+            positive >>= 4;
+            negative >>= 4;
+        }
+        remaining -= bits;
+    }
+
+    return minValue;
+}
+
+int TextSimilarity::getMaxAllowedDistance(int maxLength, float minSimilarity) {
+    return static_cast<int>((1.f - minSimilarity) * maxLength);
+}
+
+void TextSimilarity::decodeUtf8(const std::string& text, std::u32string& codePoints) {
+    codePoints.clear();
+
+    const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+    const size_t size = text.size();
+    size_t i = 0;
+    while (i < size) {
+        const unsigned char lead = bytes[i];
+
+        size_t sequenceLength;
+        char32_t codePoint;
+        if (lead < 0x80) { sequenceLength = 1; codePoint = lead; }
+        else if ((lead & 0xE0) == 0xC0) { sequenceLength = 2; codePoint = lead & 0x1F; }
+        else if ((lead & 0xF0) == 0xE0) { sequenceLength = 3; codePoint = lead & 0x0F; }
+        else if ((lead & 0xF8) == 0xF0) { sequenceLength = 4; codePoint = lead & 0x07; }
+        else { sequenceLength = 0; codePoint = 0; }
+
+        bool isValid = sequenceLength != 0 && i + sequenceLength <= size;
+        for (size_t k = 1; isValid && k < sequenceLength; ++k) {
+            if ((bytes[i + k] & 0xC0) != 0x80) isValid = false;
+            else codePoint = (codePoint << 6) | (bytes[i + k] & 0x3F);
+        }
+
+        if (!isValid) {
+            // Keep invalid bytes distinct from any valid code point
+            codePoints.push_back(0x110000 + lead);
+            i++;
+            continue;
+        }
+
+        codePoints.push_back(normalizeChar(codePoint));
+        i += sequenceLength;
+    }
+}
+
+char32_t TextSimilarity::normalizeChar(char32_t c) {
+    if (c >= 'A' && c <= 'Z') return c + 32;
+    return c;
+}
+
+void TextSimilarity::PatternMasks::build(const std::u32string& pattern) {
+    length = pattern.size();
+    wordCount = (length + 63) / 64;
+
+    asciiMasks.assign(128 * wordCount, 0ULL);
+    otherChars.clear();
+    otherMasks.clear();
+    emptyMask.assign(wordCount, 0ULL);
+
+    for (size_t i = 0; i < length; ++i) {
+        const char32_t c = pattern[i];
+
+        uint64_t* mask;
+        if (c < 128) {
+            mask = asciiMasks.data() + c * wordCount;
+        } else {
+            size_t index = otherChars.find(c);
+            if (index == std::u32string::npos) {
+                index = otherChars.size();
+                otherChars.push_back(c);
+                otherMasks.resize(otherMasks.size() + wordCount, 0ULL);
+            }
+            mask = otherMasks.data() + index * wordCount;
+        }
+
+        mask[i / 64] |= 1ULL << (i % 64);
+    }
+}
+
+const uint64_t* TextSimilarity::PatternMasks::get(char32_t c) const {
+    if (c < 128) return asciiMasks.data() + c * wordCount;
+
+    size_t index = otherChars.find(c);
+    if (index == std::u32string::npos) return emptyMask.data();
+    return otherMasks.data() + index * wordCount;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_TEXT_SIMILARITY_HPP
+#define KLICK_R_TEXT_SIMILARITY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace smartautoclicker {
+
+    /**
+     * Fuzzy comparison of a recognized text with a target text, tolerant to the usual OCR errors.
+     *
+     * The similarity is based on the optimal string alignment distance (Levenshtein with adjacent transpositions),
+     * computed on Unicode code points with the bit-parallel algorithm of Myers, extended by Hyyrö for transpositions.
+     * A single pass from each start offset of the recognized text gives the distances for all window sizes at once.
+     *
+     * The target is prepared once and kept until a different one is provided, so an instance should be kept per
+     * target when several ones are compared against the same texts.
+     */
+    class TextSimilarity {
+
+    public:
+        /**
+         * Finds the best substring match of the target within the recognized text.
+         * Useful when the target text is part of a larger detected block.
+         * @param recognized The text recognized by the OCR, UTF-8 encoded.
+         * @param target The text to search for, UTF-8 encoded.
+         * @param minSimilarity The threshold for a valid match.
+         *
+         * @return The highest similarity score found, between 0.0 (no match) and 1.0 (perfect match).
+         */
+        float bestSubstringSimilarity(const std::string& recognized, const std::string& target, float minSimilarity = 0.80f);
+
+        /**
+         * Same as bestSubstringSimilarity, without the exact substring search.
+         * For the callers that already know the target is not an exact substring of the recognized text.
+         */
+        float bestApproximateSubstringSimilarity(
+                const std::string& recognized,
+                const std::string& target,
+                float minSimilarity = 0.80f);
+
+    private:
+        /** Match masks of a pattern: for each character, the bits of the pattern positions containing it. */
+        struct PatternMasks {
+            /** Number of 64 bits words per mask. */
+            size_t wordCount = 0;
+            /** Length of the pattern, in code points. */
+            size_t length = 0;
+            /** Masks for ASCII characters, wordCount words per character. */
+            std::vector<uint64_t> asciiMasks;
+            /** Non ASCII characters of the pattern. */
+            std::u32string otherChars;
+            /** Masks for the non ASCII characters, in otherChars order, wordCount words per character. */
+            std::vector<uint64_t> otherMasks;
+            /** Mask for the characters not in the pattern. */
+            std::vector<uint64_t> emptyMask;
+
+            void build(const std::u32string& pattern);
+            [[nodiscard]] const uint64_t* get(char32_t c) const;
+        };
+
+        /** The current target, as provided. */
+        std::string currentTarget;
+        /** The current target, as normalized code points. */
+        std::u32string targetCodePoints;
+        /** Match masks of the current target. */
+        PatternMasks targetMasks;
+
+        /** Reusable buffer for the recognized text, as normalized code points. */
+        std::u32string recognizedCodePoints;
+        /** Reusable bit vectors for the distance computation. */
+        std::vector<uint64_t> verticalPositive;
+        std::vector<uint64_t> verticalNegative;
+        std::vector<uint64_t> diagonalZero;
+        /** Reusable buffer for the similarity of each window, indexed by start and window size. */
+        std::vector<float> windowScores;
+
+        /**
+         * Prepares the target for the comparisons, if it differs from the current one.
+         * @param target The text to search for, UTF-8 encoded.
+         */
+        void setTarget(const std::string& target);
+
+        /**
+         * Computes the similarity between the target and each prefix of a text.
+         * @param text Pointer to the first character of the text.
+         * @param minLength The length of the shortest prefix to compute the similarity for.
+         * @param maxLength The length of the longest prefix to compute the similarity for.
+         * @param minSimilarity The threshold to consider a match successful.
+         * @param scores Filled with the similarity of each prefix, from minLength to maxLength.
+         */
+        void computePrefixSimilarities(
+                const char32_t* text,
+                int minLength,
+                int maxLength,
+                float minSimilarity,
+                float* scores);
+
+        /**
+         * Converts a distance into a similarity score.
+         * @param length The length of the compared text.
+         * @param distance The distance between the compared text and the target.
+         * @param minDistance The minimum distance between the compared text and any prefix of the target. Once above
+         * the allowed distance, the comparison is abandoned.
+         * @param minSimilarity The threshold to consider a match successful.
+         *
+         * @return A value between 0.0 (no match) and 1.0 (perfect match).
+         */
+        float toSimilarity(int length, int distance, int minDistance, float minSimilarity) const;
+
+        /**
+         * Get the minimum distance between a text and any prefix of the target, from the current distance vectors.
+         * @param length The length of the text.
+         */
+        [[nodiscard]] int getMinPrefixDistance(int length) const;
+
+        /**
+         * Get the maximum distance for a similarity to be above the threshold.
+         * @param maxLength The length of the longest string.
+         * @param minSimilarity The threshold to consider a match successful.
+         */
+        static int getMaxAllowedDistance(int maxLength, float minSimilarity);
+
+        /**
+         * Decodes an UTF-8 string into normalized code points.
+         * Invalid bytes are kept as distinct values so they can still be compared.
+         * @param text The UTF-8 text.
+         * @param codePoints Filled with the normalized code points.
+         */
+        static void decodeUtf8(const std::string& text, std::u32string& codePoints);
+
+        /**
+         * Normalizes a character for comparison (e.g., case folding).
+         * @param c The character to normalize.
+         *
+         * @return The normalized character.
+         */
+        static char32_t normalizeChar(char32_t c);
+    };
+}
+
+#endif //KLICK_R_TEXT_SIMILARITY_HPP
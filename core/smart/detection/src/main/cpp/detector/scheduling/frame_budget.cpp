@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "frame_budget.hpp"
+
+using namespace smartautoclicker;
+
+/** FNV-1a hashing of the condition parameters. */
+static constexpr uint64_t hashSeed = 14695981039346656037ULL;
+static constexpr uint64_t hashPrime = 1099511628211ULL;
+
+static uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= hashPrime;
+    }
+    return hash;
+}
+
+static uint64_t hashRoi(uint64_t hash, const cv::Rect& roi) {
+    const int values[] = { roi.x, roi.y, roi.width, roi.height };
+    return hashBytes(hash, values, sizeof(values));
+}
+
+void FrameBudget::setBudget(int64_t budget) {
+    budgetMs = budget > 0 ? budget : 0;
+}
+
+bool FrameBudget::isEnabled() const {
+    return budgetMs > 0;
+}
+
+void FrameBudget::startFrame(std::chrono::steady_clock::time_point now) {
+    frameStartTime = now;
+    isFrameOverrun = false;
+}
+
+bool FrameBudget::tryStart(uint64_t conditionKey, std::chrono::steady_clock::time_point now) {
+    if (!isEnabled()) return true;
+
+    auto cost = conditionCosts.find(conditionKey);
+    if (cost == conditionCosts.end()) return true;
+
+    // Run it anyway if it has been deferred for too long, its last result is getting outdated
+    double remainingMs = static_cast<double>(budgetMs) - getFrameElapsedMs(now);
+    if (cost->second.estimatedMs <= remainingMs || cost->second.deferredFrames >= maxDeferredFrames) {
+        cost->second.deferredFrames = 0;
+        return true;
+    }
+
+    cost->second.deferredFrames++;
+    deferredCount++;
+    return false;
+}
+
+void FrameBudget::finish(
+        uint64_t conditionKey,
+        std::chrono::steady_clock::time_point startTime,
+        std::chrono::steady_clock::time_point now)
+{
+    if (!isEnabled()) return;
+
+    if (!isFrameOverrun && getFrameElapsedMs(now) > static_cast<double>(budgetMs)) {
+        isFrameOverrun = true;
+        overrunCount++;
+    }
+
+    if (conditionKey == 0) return;
+
+    double durationMs = std::chrono::duration<double, std::milli>(now - startTime).count();
+    auto cost = conditionCosts.find(conditionKey);
+    if (cost == conditionCosts.end()) {
+        if (conditionCosts.size() >= maxConditions) conditionCosts.clear();
+        conditionCosts[conditionKey].estimatedMs = durationMs;
+        return;
+    }
+
+    cost->second.estimatedMs += costSmoothing * (durationMs - cost->second.estimatedMs);
+}
+
+double FrameBudget::getEstimatedCost(uint64_t conditionKey) const {
+    auto cost = conditionCosts.find(conditionKey);
+    return cost != conditionCosts.end() ? cost->second.estimatedMs : 0.0;
+}
+
+uint64_t FrameBudget::getDeferredCount() const {
+    return deferredCount;
+}
+
+uint64_t FrameBudget::getOverrunCount() const {
+    return overrunCount;
+}
+
+uint64_t FrameBudget::computeTextKey(const cv::Rect& roi, const std::string& text, const std::string& modelId) {
+    const char type = 'T';
+    uint64_t hash = hashBytes(hashSeed, &type, sizeof(type));
+    hash = hashRoi(hash, roi);
+    hash = hashBytes(hash, text.data(), text.size() + 1);
+    return hashBytes(hash, modelId.data(), modelId.size());
+}
+
+uint64_t FrameBudget::computeNumberKey(const cv::Rect& roi, int numberFormat) {
+    const char type = 'N';
+    uint64_t hash = hashBytes(hashSeed, &type, sizeof(type));
+    hash = hashRoi(hash, roi);
+    return hashBytes(hash, &numberFormat, sizeof(numberFormat));
+}
+
+uint64_t FrameBudget::computeGroupKey(std::vector<uint64_t> conditionKeys) {
+    // Sorted so the order doesn't matter, and hashed one after the other so duplicates don't cancel each other
+    std::sort(conditionKeys.begin(), conditionKeys.end());
+
+    const char type = 'G';
+    uint64_t hash = hashBytes(hashSeed, &type, sizeof(type));
+    for (uint64_t conditionKey : conditionKeys) hash = hashBytes(hash, &conditionKey, sizeof(conditionKey));
+    return hash;
+}
+
+double FrameBudget::getFrameElapsedMs(std::chrono::steady_clock::time_point now) const {
+    return std::chrono::duration<double, std::milli>(now - frameStartTime).count();
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_FRAME_BUDGET_HPP
+#define KLICK_R_FRAME_BUDGET_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <opencv2/core/types.hpp>
+
+namespace smartautoclicker {
+
+    /**
+     * Keeps the detection of a screen frame within a time budget.
+     *
+     * The cost of each expensive condition is learned as an exponential moving average of its detection durations.
+     * A condition is deferred when its estimated cost doesn't fit in the remaining frame budget, and its last result
+     * is served instead. A condition is never deferred more than maxDeferredFrames times in a row, so conditions more
+     * expensive than the whole budget are still refreshed.
+     */
+    class FrameBudget {
+
+    public:
+        /**
+         * Set the maximum duration of the detections of a frame.
+         * @param budget The budget in milliseconds, or 0 to never defer any condition.
+         */
+        void setBudget(int64_t budget);
+
+        /** @return true if a budget is set. */
+        [[nodiscard]] bool isEnabled() const;
+
+        /**
+         * Starts the budget of a new frame.
+         * @param now The start time of the frame.
+         */
+        void startFrame(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * Tells if a condition can be detected in the remaining budget of the current frame. If not, the condition
+         * is counted as deferred.
+         * @param conditionKey The key of the condition, from computeTextKey, computeNumberKey or computeGroupKey.
+         * @param now The start time of the detection.
+         * @return true if the condition must be detected, false if it must be deferred.
+         */
+        bool tryStart(
+                uint64_t conditionKey,
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * Records the end of a condition detection.
+         * @param conditionKey The key of the condition, or 0 for the conditions without a learned cost.
+         * @param startTime When the detection started.
+         * @param now When the detection ended.
+         */
+        void finish(
+                uint64_t conditionKey,
+                std::chrono::steady_clock::time_point startTime,
+                std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * Get the estimated detection duration of a condition.
+         * @param conditionKey The key of the condition.
+         * @return The estimated cost in milliseconds, or 0 if the condition has never been detected.
+         */
+        [[nodiscard]] double getEstimatedCost(uint64_t conditionKey) const;
+
+        /** @return The number of deferred conditions since the creation. */
+        [[nodiscard]] uint64_t getDeferredCount() const;
+        /** @return The number of frames exceeding their budget since the creation. */
+        [[nodiscard]] uint64_t getOverrunCount() const;
+
+        /** @return The key of a text condition. */
+        static uint64_t computeTextKey(const cv::Rect& roi, const std::string& text, const std::string& modelId);
+        /** @return The key of a number condition. */
+        static uint64_t computeNumberKey(const cv::Rect& roi, int numberFormat);
+        /**
+         * Get the key of a group of conditions detected together. The key doesn't depend on the conditions order,
+         * but each duplicated condition changes it.
+         * @param conditionKeys The keys of the conditions of the group.
+         * @return The key of the group.
+         */
+        static uint64_t computeGroupKey(std::vector<uint64_t> conditionKeys);
+
+    private:
+        /** Weight of the last detection duration in the cost estimation. */
+        static constexpr double costSmoothing = 0.3;
+        /** Maximum number of consecutive frames a condition can be deferred. */
+        static constexpr int maxDeferredFrames = 5;
+        /** Maximum number of conditions costs kept. All costs are learned again once exceeded. */
+        static constexpr size_t maxConditions = 256;
+
+        struct ConditionCost {
+            /** Estimated detection duration, in milliseconds. */
+            double estimatedMs = 0.0;
+            /** Number of consecutive frames the condition has been deferred. */
+            int deferredFrames = 0;
+        };
+
+        std::unordered_map<uint64_t, ConditionCost> conditionCosts;
+
+        /** The budget of a frame in milliseconds, 0 if disabled. */
+        int64_t budgetMs = 0;
+        /** The start of the current frame. */
+        std::chrono::steady_clock::time_point frameStartTime;
+        /** true if the current frame has already exceeded its budget. */
+        bool isFrameOverrun = false;
+
+        uint64_t deferredCount = 0;
+        uint64_t overrunCount = 0;
+
+        [[nodiscard]] double getFrameElapsedMs(std::chrono::steady_clock::time_point now) const;
+    };
+}
+
+#endif //KLICK_R_FRAME_BUDGET_HPP
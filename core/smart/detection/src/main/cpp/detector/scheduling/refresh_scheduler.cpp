@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "refresh_scheduler.hpp"
+
+using namespace smartautoclicker;
+
+/** Maximum number of consecutive frames the conditions refreshed on the same frame are staggered over. */
+static constexpr uint32_t staggeredFrames = 4;
+
+void RefreshScheduler::setEnabled(bool enabled) {
+    isSchedulingEnabled = enabled;
+    if (!enabled) conditionSchedules.clear();
+}
+
+bool RefreshScheduler::isEnabled() const {
+    return isSchedulingEnabled;
+}
+
+void RefreshScheduler::startFrame(std::chrono::steady_clock::time_point now) {
+    if (frameStartTime.time_since_epoch().count() != 0) {
+        double intervalMs = std::chrono::duration<double, std::milli>(now - frameStartTime).count();
+        frameIntervalMs = frameIntervalMs == 0.0
+                ? intervalMs
+                : frameIntervalMs + frameIntervalSmoothing * (intervalMs - frameIntervalMs);
+    }
+
+    frameStartTime = now;
+    nextPhase = 0;
+}
+
+bool RefreshScheduler::isRefreshDue(uint64_t conditionKey, int64_t refreshPeriodMs) const {
+    if (!isSchedulingEnabled) return true;
+
+    auto schedule = conditionSchedules.find(conditionKey);
+    if (schedule == conditionSchedules.end()) return true;
+
+    double periodMs = refreshPeriodMs > 0 ? static_cast<double>(refreshPeriodMs) : schedule->second.autoPeriodMs;
+    if (periodMs <= 0.0) return true;
+
+    // Half a frame of tolerance, or the refresh would always happen one frame late
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+            frameStartTime - schedule->second.lastRefreshTime).count();
+    return elapsedMs + frameIntervalMs / 2 >= periodMs;
+}
+
+void RefreshScheduler::onRefreshed(uint64_t conditionKey, int64_t refreshPeriodMs, bool isChanged) {
+    if (!isSchedulingEnabled) return;
+
+    auto schedule = conditionSchedules.find(conditionKey);
+    if (schedule == conditionSchedules.end()) {
+        if (conditionSchedules.size() >= maxConditions) conditionSchedules.clear();
+        schedule = conditionSchedules.emplace(conditionKey, ConditionSchedule()).first;
+    } else {
+        schedule->second.autoPeriodMs = isChanged
+                ? 0.0
+                : std::min(std::max(schedule->second.autoPeriodMs * 2, frameIntervalMs), maxAutoPeriodMs);
+    }
+
+    // Conditions refreshed on the same frame are given different phases, to be refreshed on different frames next
+    double periodMs = refreshPeriodMs > 0 ? static_cast<double>(refreshPeriodMs) : schedule->second.autoPeriodMs;
+    auto periodFrames = frameIntervalMs > 0.0 ? static_cast<uint32_t>(periodMs / frameIntervalMs) : 0;
+    uint32_t phase = periodFrames > 1 ? nextPhase++ % std::min(periodFrames, staggeredFrames) : 0;
+
+    schedule->second.lastRefreshTime = frameStartTime - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(phase * frameIntervalMs));
+}
+
+uint64_t RefreshScheduler::getAmortizedCount() const {
+    return amortizedCount;
+}
+
+void RefreshScheduler::onAmortized() {
+    amortizedCount++;
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_REFRESH_SCHEDULER_HPP
+#define KLICK_R_REFRESH_SCHEDULER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace smartautoclicker {
+
+    /**
+     * Spreads the refresh of expensive conditions across the frames.
+     *
+     * Each condition is refreshed with a period, either hinted by the caller, or adapted to its changes: the period
+     * doubles each time a refresh gives the same result, up to maxAutoPeriodMs, and goes back to every frame as soon
+     * as the result changes. Conditions refreshed on the same frame are given round-robin phases, so their next
+     * refreshes are spread over the following frames instead of all happening on the same one.
+     */
+    class RefreshScheduler {
+
+    public:
+        /**
+         * Enables the scheduling. When disabled, all conditions are refreshed on every frame.
+         * @param enabled true to enable, false to disable.
+         */
+        void setEnabled(bool enabled);
+
+        /** @return true if the scheduling is enabled. */
+        [[nodiscard]] bool isEnabled() const;
+
+        /**
+         * Starts a new frame.
+         * @param now The start time of the frame.
+         */
+        void startFrame(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+        /**
+         * Tells if a condition must be refreshed on the current frame.
+         * @param conditionKey The key of the condition.
+         * @param refreshPeriodMs The refresh period hinted for the condition, or 0 to adapt it to its changes.
+         * @return true if the condition must be detected, false if its last result can be served.
+         */
+        [[nodiscard]] bool isRefreshDue(uint64_t conditionKey, int64_t refreshPeriodMs) const;
+
+        /**
+         * Records the refresh of a condition on the current frame.
+         * @param conditionKey The key of the condition.
+         * @param refreshPeriodMs The refresh period hinted for the condition, or 0 to adapt it to its changes.
+         * @param isChanged true if the result is different from the previous refresh one.
+         */
+        void onRefreshed(uint64_t conditionKey, int64_t refreshPeriodMs, bool isChanged);
+
+        /** @return The number of conditions not refreshed because their period hasn't elapsed, since the creation. */
+        [[nodiscard]] uint64_t getAmortizedCount() const;
+
+        /** Counts a condition served from its last result because its refresh wasn't due. */
+        void onAmortized();
+
+    private:
+        /** Maximum refresh period of a condition without hint, in milliseconds. */
+        static constexpr double maxAutoPeriodMs = 1000.0;
+        /** Maximum number of conditions schedules kept. All schedules are reset once exceeded. */
+        static constexpr size_t maxConditions = 256;
+        /** Weight of the last frame interval in the average one. */
+        static constexpr double frameIntervalSmoothing = 0.1;
+
+        struct ConditionSchedule {
+            /** The refresh period when there is no hint, in milliseconds. 0 to refresh on every frame. */
+            double autoPeriodMs = 0.0;
+            /** When the condition was last refreshed, moved backward by its round-robin phase. */
+            std::chrono::steady_clock::time_point lastRefreshTime;
+        };
+
+        std::unordered_map<uint64_t, ConditionSchedule> conditionSchedules;
+
+        bool isSchedulingEnabled = false;
+        /** The start of the current frame. */
+        std::chrono::steady_clock::time_point frameStartTime;
+        /** Average duration between two frames, in milliseconds. 0 until known. */
+        double frameIntervalMs = 0.0;
+        /** The phase given to the next condition refreshed on the current frame. */
+        uint32_t nextPhase = 0;
+
+        uint64_t amortizedCount = 0;
+    };
+}
+
+#endif //KLICK_R_REFRESH_SCHEDULER_HPP
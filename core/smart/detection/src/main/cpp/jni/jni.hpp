@@ -24,6 +24,7 @@
 
 #include "../detector/detector.hpp"
 #include "../detector/detection_result.hpp"
+#include "../detector/detection_metrics.hpp"
 
 
 using namespace smartautoclicker;
@@ -39,6 +40,9 @@ std::unique_ptr<cv::Mat> loadMatFromRGBA8888Bitmap(JNIEnv *env, jobject bitmap);
 void releaseBitmapLock(JNIEnv *env, jobject bitmap);
 
 jdoubleArray toJniResult(JNIEnv *env, DetectionResult* result);
+jdoubleArray toJniResults(JNIEnv *env, std::vector<TextMatchingResult>* results);
+jdoubleArray toJniCompletion(JNIEnv *env, const BatchCompletion& completion);
+jlongArray toJniMetrics(JNIEnv *env, const DetectionMetrics& metrics);
 
 void throwRuntimeException(JNIEnv *env, const char *message);
 
@@ -16,30 +16,87 @@
  */
 
 #include "jni.hpp"
+#include "../detector/batch/detection_batch.hpp"
 #include "../detector/detection_result.hpp"
 #include "../detector/matching/text/text_matching_result.hpp"
-#include <limits>
+#include <vector>
+
+/** Number of values for a single result in the jni array. */
+static constexpr jsize jniResultSize = 10;
+
+static void fillJniResult(const ConditionResult& result, jdouble* buffer) {
+    buffer[0] = result.isDetected ? 1.0 : 0.0;
+    buffer[1] = (double) result.centerX;
+    buffer[2] = (double) result.centerY;
+    buffer[3] = (double) result.width;
+    buffer[4] = (double) result.height;
+    buffer[5] = result.confidence;
+    buffer[6] = result.recognizedNumber;
+    buffer[7] = result.isNotReady ? 1.0 : 0.0;
+    buffer[8] = result.isStale ? 1.0 : 0.0;
+    buffer[9] = static_cast<jdouble>(result.ageMs);
+}
 
 jdoubleArray toJniResult(JNIEnv *env, DetectionResult* result) {
     if (result == nullptr) return nullptr;
 
-    jdouble detectedNumber = std::numeric_limits<double>::lowest();
-    auto* textResult = dynamic_cast<TextMatchingResult*>(result);
-    if (textResult != nullptr) {
-        detectedNumber = textResult->getRecognizedNumber();
+    jdouble buffer[jniResultSize];
+    fillJniResult(ConditionResult::from(result), buffer);
+
+    jdoubleArray out = env->NewDoubleArray(jniResultSize);
+    env->SetDoubleArrayRegion(out, 0, jniResultSize, buffer);
+    return out;
+}
+
+jdoubleArray toJniResults(JNIEnv *env, std::vector<TextMatchingResult>* results) {
+    if (results == nullptr) return nullptr;
+
+    // Results are concatenated, in the requested order
+    const auto size = static_cast<jsize>(results->size() * jniResultSize);
+    std::vector<jdouble> buffer(size);
+    for (size_t i = 0; i < results->size(); i++) {
+        fillJniResult(ConditionResult::from(&(*results)[i]), buffer.data() + i * jniResultSize);
     }
 
-    jdoubleArray out = env->NewDoubleArray(7);
-    jdouble buffer[7] = {
-            result->isDetected() ? 1.0 : 0.0,
-            (double) result->getResultAreaCenterX(),
-            (double) result->getResultAreaCenterY(),
-            (double) result->getResultAreaWidth(),
-            (double) result->getResultAreaHeight(),
-            result->getResultConfidence(),
-            detectedNumber
+    jdoubleArray out = env->NewDoubleArray(size);
+    env->SetDoubleArrayRegion(out, 0, size, buffer.data());
+    return out;
+}
+
+jdoubleArray toJniCompletion(JNIEnv *env, const BatchCompletion& completion) {
+    // Ticket, dropped state and duration, followed by the results in the condition order
+    const jsize headerSize = 3;
+    const auto size = static_cast<jsize>(headerSize + completion.results.size() * jniResultSize);
+    std::vector<jdouble> buffer(size);
+    buffer[0] = static_cast<jdouble>(completion.ticket);
+    buffer[1] = completion.isDropped ? 1.0 : 0.0;
+    buffer[2] = static_cast<jdouble>(completion.durationMs);
+    for (size_t i = 0; i < completion.results.size(); i++) {
+        fillJniResult(completion.results[i], buffer.data() + headerSize + i * jniResultSize);
+    }
+
+    jdoubleArray out = env->NewDoubleArray(size);
+    env->SetDoubleArrayRegion(out, 0, size, buffer.data());
+    return out;
+}
+
+jlongArray toJniMetrics(JNIEnv *env, const DetectionMetrics& metrics) {
+    jlong buffer[] = {
+            static_cast<jlong>(metrics.recognitionCacheHits),
+            static_cast<jlong>(metrics.recognitionCacheMisses),
+            static_cast<jlong>(metrics.textPrefilterRejections),
+            static_cast<jlong>(metrics.singleLineFastPaths),
+            static_cast<jlong>(metrics.skippedTextRecognitions),
+            static_cast<jlong>(metrics.detectionWarmUpMs),
+            static_cast<jlong>(metrics.recognitionWarmUpMs),
+            static_cast<jlong>(metrics.glyphTemplateReads),
+            static_cast<jlong>(metrics.deferredTextDetections),
+            static_cast<jlong>(metrics.frameBudgetOverruns),
+            static_cast<jlong>(metrics.amortizedTextDetections),
     };
+    const jsize size = sizeof(buffer) / sizeof(buffer[0]);
 
-    env->SetDoubleArrayRegion(out, 0, 7, buffer);
+    jlongArray out = env->NewLongArray(size);
+    env->SetLongArrayRegion(out, 0, size, buffer);
     return out;
 }
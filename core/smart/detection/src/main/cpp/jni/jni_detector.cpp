@@ -28,25 +28,49 @@ extern "C" {
     // Forward declarations of JNI methods from smartautoclicker.cpp
     JNIEXPORT jlong JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_newDetector(JNIEnv *env, jobject self);
     JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_deleteDetector(JNIEnv *env, jobject self);
-    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_loadDetectionModels(JNIEnv* env, jobject self, jstring detectionModelPath, jobjectArray recognitionModelIds, jobjectArray recognitionModelPaths);
+    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_loadDetectionModels(JNIEnv* env, jobject self, jstring detectionModelPath, jobjectArray recognitionModelIds, jobjectArray recognitionModelPaths, jboolean warmUp, jint detectionPrecision, jint recognitionPrecision);
+    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isTextDetectionModelReadyNative(JNIEnv *env, jobject self, jstring recognitionModelId);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setExecutionPolicyNative(JNIEnv *env, jobject self, jint threadCount, jint coreAffinity);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRecognitionMemoryBudgetNative(JNIEnv *env, jobject self, jlong budgetBytes);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setFrameBudgetNative(JNIEnv *env, jobject self, jlong budgetMs);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRefreshSchedulingNative(JNIEnv *env, jobject self, jboolean enabled);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_cancelDetectionNative(JNIEnv *env, jobject self);
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_resetCancellationNative(JNIEnv *env, jobject self);
+    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isDetectionCancelledNative(JNIEnv *env, jobject self);
     JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setScreenImage(JNIEnv *env, jobject self, jobject screenBitmap, jstring metricsTag);
     JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectImageNative(JNIEnv *env, jobject self, jobject conditionBitmap, jint conditionWidth, jint conditionHeight, jint x, jint y, jint width, jint height, jint threshold);
     JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectColorNative(JNIEnv *env, jobject self, jint conditionColor, jint x, jint y, jint width, jint height, jint threshold);
-    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextNative(JNIEnv *env, jobject self, jstring conditionText, jstring recognitionModelId, jint x, jint y, jint width, jint height, jint threshold);
-    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectNumberNative(JNIEnv *env, jobject self, jint x, jint y, jint width, jint height, jint threshold, jint numberFormat);
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextNative(JNIEnv *env, jobject self, jstring conditionText, jstring recognitionModelId, jint x, jint y, jint width, jint height, jint threshold, jlong refreshPeriodMs);
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextsNative(JNIEnv *env, jobject self, jobjectArray conditionTexts, jstring recognitionModelId, jint x, jint y, jint width, jint height, jintArray thresholds, jlong refreshPeriodMs);
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectNumberNative(JNIEnv *env, jobject self, jint x, jint y, jint width, jint height, jint threshold, jint numberFormat, jlong refreshPeriodMs);
     JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_releaseScreenImage(JNIEnv *env, jobject self, jobject screenBitmap);
+    JNIEXPORT jlong JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_submitDetectionNative(JNIEnv *env, jobject self, jobject screenBitmap, jstring metricsTag, jintArray types, jintArray areas, jintArray thresholds, jintArray parameters, jobjectArray conditionBitmaps, jobjectArray conditionTexts, jobjectArray recognitionModelIds);
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_pollDetectionCompletionNative(JNIEnv *env, jobject self, jlong timeoutMs);
+    JNIEXPORT jlongArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_getMetricsNative(JNIEnv *env, jobject self);
 }
 
 static const JNINativeMethod methods[] = {
         {"newDetector", "()J", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_newDetector},
         {"deleteDetector", "()V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_deleteDetector},
-        {"loadDetectionModels", "(Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;)Z", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_loadDetectionModels},
+        {"loadDetectionModels", "(Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;ZII)Z", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_loadDetectionModels},
+        {"isTextDetectionModelReadyNative", "(Ljava/lang/String;)Z", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isTextDetectionModelReadyNative},
+        {"setExecutionPolicyNative", "(II)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setExecutionPolicyNative},
+        {"setRecognitionMemoryBudgetNative", "(J)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRecognitionMemoryBudgetNative},
+        {"setFrameBudgetNative", "(J)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setFrameBudgetNative},
+        {"setRefreshSchedulingNative", "(Z)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRefreshSchedulingNative},
+        {"cancelDetectionNative", "()V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_cancelDetectionNative},
+        {"resetCancellationNative", "()V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_resetCancellationNative},
+        {"isDetectionCancelledNative", "()Z", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isDetectionCancelledNative},
         {"setScreenImage", "(Landroid/graphics/Bitmap;Ljava/lang/String;)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setScreenImage},
         {"detectImageNative", "(Landroid/graphics/Bitmap;IIIIIII)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectImageNative},
         {"detectColorNative", "(IIIIII)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectColorNative},
-        {"detectTextNative", "(Ljava/lang/String;Ljava/lang/String;IIIII)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextNative},
-        {"detectNumberNative", "(IIIIII)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectNumberNative},
-        {"releaseScreenImage", "(Landroid/graphics/Bitmap;)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_releaseScreenImage}
+        {"detectTextNative", "(Ljava/lang/String;Ljava/lang/String;IIIIIJ)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextNative},
+        {"detectTextsNative", "([Ljava/lang/String;Ljava/lang/String;IIII[IJ)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextsNative},
+        {"detectNumberNative", "(IIIIIIJ)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectNumberNative},
+        {"releaseScreenImage", "(Landroid/graphics/Bitmap;)V", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_releaseScreenImage},
+        {"submitDetectionNative", "(Landroid/graphics/Bitmap;Ljava/lang/String;[I[I[I[I[Landroid/graphics/Bitmap;[Ljava/lang/String;[Ljava/lang/String;)J", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_submitDetectionNative},
+        {"pollDetectionCompletionNative", "(J)[D", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_pollDetectionCompletionNative},
+        {"getMetricsNative", "()[J", (void*)Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_getMetricsNative}
 };
 
 extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
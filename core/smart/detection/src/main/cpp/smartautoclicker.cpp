@@ -43,7 +43,10 @@ extern "C" {
             jobject self,
             jstring detectionModelPath,
             jobjectArray recognitionModelIds,
-            jobjectArray recognitionModelPaths
+            jobjectArray recognitionModelPaths,
+            jboolean warmUp,
+            jint detectionPrecision,
+            jint recognitionPrecision
     ) {
         const char* nativeDetectionPath = env->GetStringUTFChars(detectionModelPath, nullptr);
 
@@ -69,7 +72,12 @@ extern "C" {
         auto detector = getDetectorFromJavaRef(env, self);
         bool result = false;
         if (detector) {
-            result = detector->loadModels(nativeDetectionPath, recognitionModels);
+            result = detector->loadModels(
+                    nativeDetectionPath,
+                    recognitionModels,
+                    warmUp == JNI_TRUE,
+                    static_cast<InferencePrecision>(detectionPrecision),
+                    static_cast<InferencePrecision>(recognitionPrecision));
         }
 
         env->ReleaseStringUTFChars(detectionModelPath, nativeDetectionPath);
@@ -77,6 +85,98 @@ extern "C" {
         return result ? JNI_TRUE : JNI_FALSE;
     }
 
+    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isTextDetectionModelReadyNative(
+            JNIEnv *env,
+            jobject self,
+            jstring recognitionModelId
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return JNI_FALSE;
+
+        const char* nativeRecognitionModelId = env->GetStringUTFChars(recognitionModelId, nullptr);
+        if (nativeRecognitionModelId == nullptr) return JNI_FALSE;
+
+        bool result = detector->isTextModelReady(nativeRecognitionModelId);
+
+        env->ReleaseStringUTFChars(recognitionModelId, nativeRecognitionModelId);
+        return result ? JNI_TRUE : JNI_FALSE;
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setExecutionPolicyNative(
+            JNIEnv *env,
+            jobject self,
+            jint threadCount,
+            jint coreAffinity
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->setExecutionPolicy(ExecutionPolicy(threadCount, static_cast<CoreAffinity>(coreAffinity)));
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRecognitionMemoryBudgetNative(
+            JNIEnv *env,
+            jobject self,
+            jlong budgetBytes
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->setRecognitionMemoryBudget(budgetBytes > 0 ? static_cast<size_t>(budgetBytes) : 0);
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setFrameBudgetNative(
+            JNIEnv *env,
+            jobject self,
+            jlong budgetMs
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->setFrameBudget(budgetMs);
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setRefreshSchedulingNative(
+            JNIEnv *env,
+            jobject self,
+            jboolean enabled
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->setRefreshScheduling(enabled);
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_cancelDetectionNative(
+            JNIEnv *env,
+            jobject self
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->cancelDetection();
+    }
+
+    JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_resetCancellationNative(
+            JNIEnv *env,
+            jobject self
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return;
+
+        detector->resetCancellation();
+    }
+
+    JNIEXPORT jboolean JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_isDetectionCancelledNative(
+            JNIEnv *env,
+            jobject self
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return JNI_FALSE;
+
+        return detector->isDetectionCancelled() ? JNI_TRUE : JNI_FALSE;
+    }
+
     JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_setScreenImage(
             JNIEnv *env,
             jobject self,
@@ -164,7 +264,8 @@ extern "C" {
             jint y,
             jint width,
             jint height,
-            jint threshold
+            jint threshold,
+            jlong refreshPeriodMs
     ) {
         auto detector = getDetectorFromJavaRef(env, self);
         if (!detector) return nullptr;
@@ -179,7 +280,8 @@ extern "C" {
                     nativeConditionText,
                     nativeRecognitionModelId,
                     cv::Rect(x, y, width, height),
-                    threshold));
+                    threshold,
+                    refreshPeriodMs));
         } catch (...) {
             throwRuntimeException(env, "Invalid detection arguments for text detection");
         }
@@ -189,6 +291,62 @@ extern "C" {
         return result;
     }
 
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectTextsNative(
+            JNIEnv *env,
+            jobject self,
+            jobjectArray conditionTexts,
+            jstring recognitionModelId,
+            jint x,
+            jint y,
+            jint width,
+            jint height,
+            jintArray thresholds,
+            jlong refreshPeriodMs
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return nullptr;
+
+        jsize length = env->GetArrayLength(conditionTexts);
+        if (env->GetArrayLength(thresholds) != length) {
+            throwRuntimeException(env, "Text conditions and thresholds sizes are different");
+            return nullptr;
+        }
+
+        std::vector<std::string> nativeConditionTexts;
+        nativeConditionTexts.reserve(length);
+        for (jsize i = 0; i < length; i++) {
+            auto conditionText = (jstring) env->GetObjectArrayElement(conditionTexts, i);
+            const char* nativeConditionText = env->GetStringUTFChars(conditionText, nullptr);
+            if (nativeConditionText == nullptr) return nullptr;
+
+            nativeConditionTexts.emplace_back(nativeConditionText);
+
+            env->ReleaseStringUTFChars(conditionText, nativeConditionText);
+            env->DeleteLocalRef(conditionText);
+        }
+
+        std::vector<int> nativeThresholds(length);
+        env->GetIntArrayRegion(thresholds, 0, length, reinterpret_cast<jint*>(nativeThresholds.data()));
+
+        const char* nativeRecognitionModelId = env->GetStringUTFChars(recognitionModelId, nullptr);
+        if (nativeRecognitionModelId == nullptr) return nullptr;
+
+        jdoubleArray result = nullptr;
+        try {
+            result = toJniResults(env, detector->detectTexts(
+                    nativeConditionTexts,
+                    nativeRecognitionModelId,
+                    cv::Rect(x, y, width, height),
+                    nativeThresholds,
+                    refreshPeriodMs));
+        } catch (...) {
+            throwRuntimeException(env, "Invalid detection arguments for texts detection");
+        }
+
+        env->ReleaseStringUTFChars(recognitionModelId, nativeRecognitionModelId);
+        return result;
+    }
+
     JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_detectNumberNative(
             JNIEnv *env,
             jobject self,
@@ -197,7 +355,8 @@ extern "C" {
             jint width,
             jint height,
             jint threshold,
-            jint numberFormat
+            jint numberFormat,
+            jlong refreshPeriodMs
     ) {
         auto detector = getDetectorFromJavaRef(env, self);
         if (!detector) return nullptr;
@@ -206,7 +365,8 @@ extern "C" {
             return toJniResult(env, detector->detectNumber(
                     cv::Rect(x, y, width, height),
                     threshold,
-                    static_cast<NumberFormat>(numberFormat)));
+                    static_cast<NumberFormat>(numberFormat),
+                    refreshPeriodMs));
         } catch (...) {
             throwRuntimeException(env, "Invalid detection arguments for number detection");
         }
@@ -219,9 +379,144 @@ extern "C" {
             jobject self,
             jobject screenBitmap
     ) {
+        // The screen image might still be read in background
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (detector) detector->releaseScreenImage();
+
         releaseBitmapLock(env, screenBitmap);
     }
 
+    JNIEXPORT jlong JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_submitDetectionNative(
+            JNIEnv *env,
+            jobject self,
+            jobject screenBitmap,
+            jstring metricsTag,
+            jintArray types,
+            jintArray areas,
+            jintArray thresholds,
+            jintArray parameters,
+            jobjectArray conditionBitmaps,
+            jobjectArray conditionTexts,
+            jobjectArray recognitionModelIds
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return 0;
+
+        // Areas are 4 values per condition (x, y, width, height), parameters are 2 values per condition
+        jsize count = env->GetArrayLength(types);
+        if (env->GetArrayLength(areas) != count * 4 || env->GetArrayLength(thresholds) != count
+                || env->GetArrayLength(parameters) != count * 2 || env->GetArrayLength(conditionBitmaps) != count
+                || env->GetArrayLength(conditionTexts) != count || env->GetArrayLength(recognitionModelIds) != count) {
+            throwRuntimeException(env, "Detection batch arrays sizes are different");
+            return 0;
+        }
+
+        std::vector<jint> nativeTypes(count);
+        std::vector<jint> nativeAreas(count * 4);
+        std::vector<jint> nativeThresholds(count);
+        std::vector<jint> nativeParameters(count * 2);
+        env->GetIntArrayRegion(types, 0, count, nativeTypes.data());
+        env->GetIntArrayRegion(areas, 0, count * 4, nativeAreas.data());
+        env->GetIntArrayRegion(thresholds, 0, count, nativeThresholds.data());
+        env->GetIntArrayRegion(parameters, 0, count * 2, nativeParameters.data());
+
+        std::unique_ptr<DetectionBatch> batch = detector->obtainBatch();
+
+        const char* nativeMetricsTag = env->GetStringUTFChars(metricsTag, nullptr);
+        if (nativeMetricsTag == nullptr) return 0;
+        batch->metricsTag = nativeMetricsTag;
+        env->ReleaseStringUTFChars(metricsTag, nativeMetricsTag);
+
+        // Copy the screen pixels, the bitmap can then be reused for the next frame while this one is detected
+        std::unique_ptr<cv::Mat> screenMat = loadMatFromRGBA8888Bitmap(env, screenBitmap);
+        if (!screenMat) return 0;
+        screenMat->copyTo(batch->screenMat);
+        releaseBitmapLock(env, screenBitmap);
+
+        batch->conditions.resize(count);
+        for (jsize i = 0; i < count; i++) {
+            BatchCondition& condition = batch->conditions[i];
+            condition.type = static_cast<ConditionType>(nativeTypes[i]);
+            condition.detectionArea = cv::Rect(
+                    nativeAreas[i * 4], nativeAreas[i * 4 + 1], nativeAreas[i * 4 + 2], nativeAreas[i * 4 + 3]);
+            condition.threshold = nativeThresholds[i];
+
+            switch (condition.type) {
+                case ConditionType::IMAGE: {
+                    condition.conditionWidth = nativeParameters[i * 2];
+                    condition.conditionHeight = nativeParameters[i * 2 + 1];
+
+                    jobject conditionBitmap = env->GetObjectArrayElement(conditionBitmaps, i);
+                    std::unique_ptr<cv::Mat> conditionMat = loadMatFromRGBA8888Bitmap(env, conditionBitmap);
+                    if (!conditionMat) return 0;
+                    conditionMat->copyTo(condition.conditionMat);
+                    releaseBitmapLock(env, conditionBitmap);
+                    env->DeleteLocalRef(conditionBitmap);
+                    break;
+                }
+
+                case ConditionType::COLOR:
+                    condition.conditionColor = nativeParameters[i * 2];
+                    break;
+
+                case ConditionType::TEXT: {
+                    condition.refreshPeriodMs = nativeParameters[i * 2];
+
+                    auto conditionText = (jstring) env->GetObjectArrayElement(conditionTexts, i);
+                    auto recognitionModelId = (jstring) env->GetObjectArrayElement(recognitionModelIds, i);
+                    const char* nativeConditionText = env->GetStringUTFChars(conditionText, nullptr);
+                    if (nativeConditionText == nullptr) return 0;
+                    const char* nativeRecognitionModelId = env->GetStringUTFChars(recognitionModelId, nullptr);
+                    if (nativeRecognitionModelId == nullptr) return 0;
+
+                    condition.conditionText = nativeConditionText;
+                    condition.recognitionModelId = nativeRecognitionModelId;
+
+                    env->ReleaseStringUTFChars(conditionText, nativeConditionText);
+                    env->ReleaseStringUTFChars(recognitionModelId, nativeRecognitionModelId);
+                    env->DeleteLocalRef(conditionText);
+                    env->DeleteLocalRef(recognitionModelId);
+                    break;
+                }
+
+                case ConditionType::NUMBER:
+                    condition.numberFormat = static_cast<NumberFormat>(nativeParameters[i * 2]);
+                    condition.refreshPeriodMs = nativeParameters[i * 2 + 1];
+                    break;
+
+                default:
+                    throwRuntimeException(env, "Invalid detection batch condition type");
+                    return 0;
+            }
+        }
+
+        return static_cast<jlong>(detector->submitBatch(std::move(batch)));
+    }
+
+    JNIEXPORT jdoubleArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_pollDetectionCompletionNative(
+            JNIEnv *env,
+            jobject self,
+            jlong timeoutMs
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return nullptr;
+
+        BatchCompletion completion;
+        if (!detector->pollBatchCompletion(completion, timeoutMs)) return nullptr;
+
+        return toJniCompletion(env, completion);
+    }
+
+    JNIEXPORT jlongArray JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_getMetricsNative(
+            JNIEnv *env,
+            jobject self
+    ) {
+        auto detector = getDetectorFromJavaRef(env, self);
+        if (!detector) return nullptr;
+
+        return toJniMetrics(env, detector->getMetrics());
+    }
+
     JNIEXPORT void JNICALL Java_com_buzbuz_smartautoclicker_core_detection_NativeDetector_deleteDetector(
             JNIEnv *env,
             jobject self
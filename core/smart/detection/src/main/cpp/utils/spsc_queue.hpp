@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_SPSC_QUEUE_HPP
+#define KLICK_R_SPSC_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace smartautoclicker {
+
+    /**
+     * Bounded lock-free queue, for a single producer thread and a single consumer thread.
+     * @tparam T The type of the values, must be default constructible and movable.
+     * @tparam Capacity The maximum number of values in the queue, must be a power of 2.
+     */
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+    public:
+        /**
+         * Adds a value at the end of the queue. Must be called from the producer thread.
+         * @param value The value to add, moved into the queue on success.
+         * @return true if the value has been added, false if the queue is full.
+         */
+        bool push(T&& value) {
+            const size_t tail = tailIndex.load(std::memory_order_relaxed);
+            if (tail - headIndex.load(std::memory_order_acquire) == Capacity) return false;
+
+            slots[tail & indexMask] = std::move(value);
+            tailIndex.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Removes the value at the front of the queue. Must be called from the consumer thread.
+         * @param value Set to the removed value on success.
+         * @return true if a value has been removed, false if the queue is empty.
+         */
+        bool pop(T& value) {
+            const size_t head = headIndex.load(std::memory_order_relaxed);
+            if (head == tailIndex.load(std::memory_order_acquire)) return false;
+
+            value = std::move(slots[head & indexMask]);
+            headIndex.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** @return true if the queue is empty. Exact from the consumer thread, a hint for the other ones. */
+        [[nodiscard]] bool empty() const {
+            return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+        }
+
+        /** @return true if the queue is full. Exact from the producer thread, a hint for the other ones. */
+        [[nodiscard]] bool full() const {
+            return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire) == Capacity;
+        }
+
+    private:
+        static constexpr size_t indexMask = Capacity - 1;
+
+        /** The values, indexed by their position modulo the capacity. */
+        std::array<T, Capacity> slots;
+        /** Position of the next value to pop, only written by the consumer. */
+        alignas(64) std::atomic<size_t> headIndex = 0;
+        /** Position of the next value to push, only written by the producer. */
+        alignas(64) std::atomic<size_t> tailIndex = 0;
+    };
+}
+
+#endif //KLICK_R_SPSC_QUEUE_HPP
@@ -0,0 +1,27 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+/** The CPU cores the detection can run on. Ordinals must match the C++ CoreAffinity enum (ALL=0, LITTLE=1, BIG=2). */
+enum class CoreAffinity {
+    /** All cores, let the system schedule the detection threads. */
+    ALL,
+    /** Only the little, power efficient, cores. */
+    LITTLE,
+    /** Only the big, performance, cores. */
+    BIG,
+}
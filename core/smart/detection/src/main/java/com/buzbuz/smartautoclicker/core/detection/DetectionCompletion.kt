@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+/**
+ * The completion of a detection submitted with [ImageDetector.submitDetection].
+ *
+ * @param ticket the ticket returned by [ImageDetector.submitDetection] for this detection.
+ * @param isDropped true if the detection has been dropped for a more recent one before being processed.
+ * @param durationMs the duration of the detection on the native worker, in milliseconds.
+ * @param results the results of each request, in the submitted order. Empty if dropped.
+ */
+data class DetectionCompletion(
+    val ticket: Long,
+    val isDropped: Boolean,
+    val durationMs: Long,
+    val results: List<DetectionResult>,
+)
+
+/** Number of values before the results in a native completion. */
+private const val NATIVE_COMPLETION_HEADER_SIZE = 3
+
+/** Build the completion object from a native call returned value. */
+internal fun DoubleArray?.toDetectionCompletion(): DetectionCompletion? {
+    if (this == null || size < NATIVE_COMPLETION_HEADER_SIZE) return null
+
+    val isDropped = this[1] > 0.5
+    return DetectionCompletion(
+        ticket = this[0].toLong(),
+        isDropped = isDropped,
+        durationMs = this[2].toLong(),
+        results =
+            if (isDropped) emptyList()
+            else toAllDetectionResults(offset = NATIVE_COMPLETION_HEADER_SIZE),
+    )
+}
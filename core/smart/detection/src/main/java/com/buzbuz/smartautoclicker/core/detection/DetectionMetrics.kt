@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+/**
+ * Counters collected by the native detector since its creation.
+ *
+ * @param recognitionCacheHits number of text recognitions served from the recognition cache.
+ * @param recognitionCacheMisses number of text recognitions that required a model inference.
+ * @param textPrefilterRejections number of text detection areas rejected before running the detection network.
+ * @param singleLineFastPaths number of number detections resolved on a single text line, without the detection network.
+ * @param skippedTextRecognitions number of detected text boxes not recognized because a match was found in a more likely one.
+ * @param detectionWarmUpMs duration of the text detection model warm-up inference, in milliseconds.
+ * @param recognitionWarmUpMs total duration of the warm-up inferences of the loaded text recognition models, in milliseconds.
+ * @param glyphTemplateReads number of number detections read with the glyphs learned in their area, without the recognition network.
+ * @param deferredTextDetections number of text and number detections deferred to keep the frame budget.
+ * @param frameBudgetOverruns number of screen frames whose detections exceeded the frame budget.
+ * @param amortizedTextDetections number of text and number detections skipped because their refresh period wasn't elapsed.
+ */
+data class DetectionMetrics(
+    val recognitionCacheHits: Long = 0,
+    val recognitionCacheMisses: Long = 0,
+    val textPrefilterRejections: Long = 0,
+    val singleLineFastPaths: Long = 0,
+    val skippedTextRecognitions: Long = 0,
+    val detectionWarmUpMs: Long = 0,
+    val recognitionWarmUpMs: Long = 0,
+    val glyphTemplateReads: Long = 0,
+    val deferredTextDetections: Long = 0,
+    val frameBudgetOverruns: Long = 0,
+    val amortizedTextDetections: Long = 0,
+)
+
+internal fun LongArray?.toDetectionMetrics(): DetectionMetrics {
+    if (this == null) return DetectionMetrics()
+
+    return DetectionMetrics(
+        recognitionCacheHits = getOrElse(0) { 0 },
+        recognitionCacheMisses = getOrElse(1) { 0 },
+        textPrefilterRejections = getOrElse(2) { 0 },
+        singleLineFastPaths = getOrElse(3) { 0 },
+        skippedTextRecognitions = getOrElse(4) { 0 },
+        detectionWarmUpMs = getOrElse(5) { 0 },
+        recognitionWarmUpMs = getOrElse(6) { 0 },
+        glyphTemplateReads = getOrElse(7) { 0 },
+        deferredTextDetections = getOrElse(8) { 0 },
+        frameBudgetOverruns = getOrElse(9) { 0 },
+        amortizedTextDetections = getOrElse(10) { 0 },
+    )
+}
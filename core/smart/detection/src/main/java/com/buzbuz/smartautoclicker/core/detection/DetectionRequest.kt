@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+import android.graphics.Bitmap
+import android.graphics.Rect
+import androidx.annotation.ColorInt
+
+/**
+ * A condition to detect asynchronously with [ImageDetector.submitDetection].
+ * Each request has the same parameters as its synchronous detection method.
+ */
+sealed class DetectionRequest {
+
+    /** The area of the screen to detect the condition in. */
+    abstract val detectionArea: Rect
+    /** The allowed error threshold allowed for the condition. */
+    abstract val threshold: Int
+
+    /** Detection of an image, see [ImageDetector.detectImage]. */
+    data class Image(
+        val conditionBitmap: Bitmap,
+        val conditionWidth: Int,
+        val conditionHeight: Int,
+        override val detectionArea: Rect,
+        override val threshold: Int,
+    ) : DetectionRequest()
+
+    /** Detection of a color, see [ImageDetector.detectColor]. */
+    data class Color(
+        @ColorInt val conditionColor: Int,
+        override val detectionArea: Rect,
+        override val threshold: Int,
+    ) : DetectionRequest()
+
+    /** Detection of a text, see [ImageDetector.detectText]. */
+    data class Text(
+        val conditionText: String,
+        val recognitionModelId: String,
+        override val detectionArea: Rect,
+        override val threshold: Int,
+        val refreshPeriodMs: Long = 0,
+    ) : DetectionRequest()
+
+    /** Detection of a number, see [ImageDetector.detectNumber]. */
+    data class Number(
+        override val detectionArea: Rect,
+        override val threshold: Int,
+        val numberFormatType: NumberFormatType = NumberFormatType.AUTO,
+        val refreshPeriodMs: Long = 0,
+    ) : DetectionRequest()
+}
+
+/** Type of the request in native calls. Values must match the C++ ConditionType enum. */
+internal val DetectionRequest.nativeType: Int
+    get() = when (this) {
+        is DetectionRequest.Image -> 0
+        is DetectionRequest.Color -> 1
+        is DetectionRequest.Text -> 2
+        is DetectionRequest.Number -> 3
+    }
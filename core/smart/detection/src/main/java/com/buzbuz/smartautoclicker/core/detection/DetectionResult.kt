@@ -25,6 +25,10 @@ import android.graphics.Point
  * @param position contains the center of the detected condition in screen coordinates.
  * @param size size of the detected condition.
  * @param numberDetected defined only for a positive number capture request, null for others.
+ * @param isNotReady true if the detection wasn't done because the models it requires are still loading.
+ * @param isStale true if the condition hasn't been detected on this frame, to keep the frame budget or because its
+ * refresh period hasn't elapsed, and this is the last result computed for it on a previous frame.
+ * @param resultAgeMs for a stale result, the time elapsed since it was computed, in milliseconds.
  */
 data class DetectionResult(
     val isDetected: Boolean = false,
@@ -32,18 +36,42 @@ data class DetectionResult(
     val position: Point = Point(),
     val size: Point = Point(),
     val numberDetected: Double? = null,
+    val isNotReady: Boolean = false,
+    val isStale: Boolean = false,
+    val resultAgeMs: Long = 0,
 )
 
+/** Number of values for a single result in a native call returned value. */
+private const val NATIVE_RESULT_SIZE = 10
+
 /** Build the detection result object from a native call returned value. */
 internal fun DoubleArray?.toDetectionResult(): DetectionResult {
-    if (this == null || size < 7) return DetectionResult()
+    if (this == null || size < NATIVE_RESULT_SIZE) return DetectionResult()
+    return toDetectionResult(offset = 0)
+}
+
+/** Build the detection result objects from a native call returned value containing [count] results. */
+internal fun DoubleArray?.toDetectionResults(count: Int): List<DetectionResult> {
+    if (this == null || size < count * NATIVE_RESULT_SIZE) return List(count) { DetectionResult() }
+    return List(count) { index -> toDetectionResult(offset = index * NATIVE_RESULT_SIZE) }
+}
+
+/** Build all detection result objects from a native call returned value, starting at [offset]. */
+internal fun DoubleArray.toAllDetectionResults(offset: Int): List<DetectionResult> =
+    List((size - offset) / NATIVE_RESULT_SIZE) { index ->
+        toDetectionResult(offset = offset + index * NATIVE_RESULT_SIZE)
+    }
 
-    val numberDetected = this[6]
+private fun DoubleArray.toDetectionResult(offset: Int): DetectionResult {
+    val numberDetected = this[offset + 6]
     return DetectionResult(
-        isDetected = this[0] > 0.5,
-        position = Point(this[1].toInt(), this[2].toInt()),
-        size = Point(this[3].toInt(), this[4].toInt()),
-        confidenceRate = this[5],
+        isDetected = this[offset] > 0.5,
+        position = Point(this[offset + 1].toInt(), this[offset + 2].toInt()),
+        size = Point(this[offset + 3].toInt(), this[offset + 4].toInt()),
+        confidenceRate = this[offset + 5],
         numberDetected = if(numberDetected == -Double.MAX_VALUE) null else numberDetected,
+        isNotReady = this[offset + 7] > 0.5,
+        isStale = this[offset + 8] > 0.5,
+        resultAgeMs = this[offset + 9].toLong(),
     )
 }
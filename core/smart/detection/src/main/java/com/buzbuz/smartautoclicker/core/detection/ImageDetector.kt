@@ -32,14 +32,100 @@ interface ImageDetector : AutoCloseable {
 
     /**
      * Loads the text detection models for the detector.
+     * The detection model is loaded in background and this method returns immediately. Each recognition model is
+     * loaded in background on its first use by a detection. Until the models of a detection are loaded, the results of
+     * [detectText], [detectTexts] and [detectNumber] are marked as [DetectionResult.isNotReady]. Image and color
+     * detections are not affected.
      *
-     * @param detectionModelPath Path on the filesystem to the detection model folder. Must contain det.ncnn.bin &
-     * det.ncnn.param files
+     * @param detectionModelPath Path on the filesystem to the detection model folder. Must contain a det.ncnn.bundle
+     * file, or det.ncnn.bin & det.ncnn.param files
      * @param recognitionModels Map of recognition model identifier to their path on the filesystem. Identifier will be
-     * used to specify the model to use when detecting with [detectText]. Each model folder must contain rec.ncnn.bin,
-     * rec.ncnn.param and dict.txt files.
+     * used to specify the model to use when detecting with [detectText]. Each model folder must contain a
+     * rec.ncnn.bundle file, or rec.ncnn.bin, rec.ncnn.param and dict.txt files. Bundles are memory mapped and load
+     * faster. [detectNumber] uses the model with the "DIGITS" identifier if any, or the "LATIN" one.
+     * @param warmUp true to run a dummy inference with each model once loaded, in background. The first detection
+     * using a model is then as fast as the following ones. Warm-up durations are reported in [DetectionMetrics].
+     * @param detectionPrecision the precision of the text detection inferences.
+     * @param recognitionPrecision the precision of the text recognition inferences, for all recognition models.
      */
-    fun loadTextDetectionModels(detectionModelPath: String, recognitionModels: Map<String, String>): Boolean
+    fun loadTextDetectionModels(
+        detectionModelPath: String,
+        recognitionModels: Map<String, String>,
+        warmUp: Boolean = true,
+        detectionPrecision: InferencePrecision = InferencePrecision.FP16,
+        recognitionPrecision: InferencePrecision = InferencePrecision.FP16,
+    ): Boolean
+
+    /**
+     * Tells if the models required to detect text with a recognition model are loaded.
+     *
+     * @param recognitionModelId the identifier of the model, as specified during [loadTextDetectionModels] call.
+     * @return true if the text detection with this model can be done, false if its models are still loading or
+     * can't be loaded.
+     */
+    fun isTextDetectionModelReady(recognitionModelId: String): Boolean
+
+    /**
+     * Set how the detection uses the CPU. The thread count is applied to all thread pools used by the detection. The
+     * threads owned by the detector, the screen bitmap preparation and the [submitDetection] worker, are bound to the
+     * cores of [coreAffinity]. The calling thread of the synchronous detections is only bound during each inference.
+     * By default, the detection runs on all big cores.
+     *
+     * @param threadCount the number of threads used by the detection, or 0 for the number of cores of [coreAffinity].
+     * @param coreAffinity the CPU cores the detection is running on.
+     */
+    fun setExecutionPolicy(threadCount: Int = 0, coreAffinity: CoreAffinity = CoreAffinity.BIG)
+
+    /**
+     * Set the maximum memory used by the text recognition models.
+     * The least recently used recognition models are unloaded when this budget is exceeded, and loaded again in
+     * background on their next use by [detectText] or [detectNumber]. By default, there is no limit.
+     *
+     * @param budgetBytes the memory budget in bytes, or 0 for no limit.
+     */
+    fun setRecognitionMemoryBudget(budgetBytes: Long)
+
+    /**
+     * Set the maximum duration of the detections of a screen bitmap, starting with [setScreenBitmap].
+     * The duration of each text and number condition is learned from its previous detections. When a condition
+     * doesn't fit in the remaining budget of the frame, it isn't detected and its last result is returned instead,
+     * with [DetectionResult.isStale] set. A condition without any last result is always detected, and is never
+     * deferred for more than 5 frames in a row.
+     * All the time elapsed since [setScreenBitmap] is charged to the budget, including the work done by the caller
+     * between two detections, like executing actions. Only enable it when the detections of a frame are run together,
+     * and when the stale results are handled. By default, there is no budget.
+     *
+     * @param budgetMs the budget of a frame in milliseconds, or 0 for no budget.
+     */
+    fun setFrameBudget(budgetMs: Long)
+
+    /**
+     * Enables the refresh scheduling of the text and number conditions. When enabled, each condition is refreshed
+     * with a period: the one hinted with its detection, or one adapted to how often its result changes, between
+     * every frame and once a second. Conditions refreshed on the same frame are spread over the following ones, so
+     * the frame duration stays flat. On the frames a condition isn't refreshed, its last result is returned, with
+     * [DetectionResult.isStale] set and its [DetectionResult.resultAgeMs]. Disabled by default.
+     *
+     * @param enabled true to enable, false to detect all conditions on every frame.
+     */
+    fun setRefreshScheduling(enabled: Boolean)
+
+    /**
+     * Cancels the running detection, and all the following ones until [resetCancellation] is called.
+     * Can be called from any thread. The running detection stops at its next stage, text box or image part, and the
+     * cancelled detections returns not detected results that must be ignored.
+     */
+    fun cancelDetection()
+
+    /** Allows the detections again after a [cancelDetection]. Must be called from the detection thread. */
+    fun resetCancellation()
+
+    /**
+     * Tells if the detections are cancelled. Can be called from any thread.
+     *
+     * @return true if [cancelDetection] have been called since the last [resetCancellation], false if not.
+     */
+    fun isDetectionCancelled(): Boolean
 
     /**
      * Set the bitmap for the screen.
@@ -93,6 +179,8 @@ interface ImageDetector : AutoCloseable {
      * @param recognitionModelId the identifier of the model to use, as specified during [loadTextDetectionModels] call.
      * @param detectionArea the area to search for the text.
      * @param threshold the allowed error threshold allowed for the condition.
+     * @param refreshPeriodMs the refresh period of the condition when [setRefreshScheduling] is enabled, or 0 to
+     * adapt it to the condition changes.
      *
      * @return the results of the detection.
      */
@@ -101,14 +189,41 @@ interface ImageDetector : AutoCloseable {
         recognitionModelId: String,
         detectionArea: Rect,
         threshold: Int,
+        refreshPeriodMs: Long = 0,
     ): DetectionResult
 
+    /**
+     * Detect if several texts are visible in the provided area.
+     * The text recognition is made only once for all texts, prefer this method over multiple [detectText] calls when
+     * several texts are searched in the same area.
+     * [setScreenBitmap] must have been called first with the content of the screen.
+     *
+     * @param conditionTexts the texts to detect.
+     * @param recognitionModelId the identifier of the model to use, as specified during [loadTextDetectionModels] call.
+     * @param detectionArea the area to search for the texts.
+     * @param thresholds the allowed error threshold allowed for each text, in [conditionTexts] order.
+     * @param refreshPeriodMs the refresh period of the texts when [setRefreshScheduling] is enabled, or 0 to adapt
+     * it to the texts changes.
+     *
+     * @return the results of the detection for each text, in [conditionTexts] order.
+     */
+    fun detectTexts(
+        conditionTexts: List<String>,
+        recognitionModelId: String,
+        detectionArea: Rect,
+        thresholds: List<Int>,
+        refreshPeriodMs: Long = 0,
+    ): List<DetectionResult>
+
     /**
      * Detect if a number is visible in the provided area.
      * [setScreenBitmap] must have been called first with the content of the screen.
+     * Only digits and number separators are recognized, texts containing other characters are ignored.
      *
      * @param detectionArea the area to search for the number.
      * @param threshold the allowed error threshold allowed for the condition.
+     * @param refreshPeriodMs the refresh period of the condition when [setRefreshScheduling] is enabled, or 0 to
+     * adapt it to the condition changes.
      *
      * @return the numeric value detected, or Double.MIN_VALUE if none.
      */
@@ -116,10 +231,44 @@ interface ImageDetector : AutoCloseable {
         detectionArea: Rect,
         threshold: Int,
         numberFormatType: NumberFormatType = NumberFormatType.AUTO,
+        refreshPeriodMs: Long = 0,
     ): DetectionResult
 
     /** Release the resources of the screen image set with [setScreenBitmap]. */
     fun releaseScreenBitmap(screenBitmap: Bitmap)
+
+    /**
+     * Submit a screen bitmap and the conditions to detect in it to the native detection worker, and returns
+     * immediately. The screen and condition bitmaps are copied, and can be reused once this method returns.
+     *
+     * At most two detections are waiting for the worker: when a new one is submitted, the oldest waiting detection
+     * is dropped, as its screen content is outdated. Completions, including the dropped ones, must be retrieved with
+     * [pollDetectionCompletion] or [awaitDetectionCompletion]: the worker stops once 8 of them are waiting.
+     * Other detection methods throw an [IllegalStateException] until the completions of all submitted detections
+     * have been retrieved. [setExecutionPolicy] and the cancellation methods can still be called, the execution
+     * policy is then applied to the worker thread.
+     *
+     * @param screenBitmap the content of the screen as a bitmap.
+     * @param metadata the tag for the metrics of this screen content.
+     * @param requests the conditions to detect.
+     *
+     * @return the ticket identifying this detection in its [DetectionCompletion], or 0 on error.
+     */
+    fun submitDetection(screenBitmap: Bitmap, metadata: String, requests: List<DetectionRequest>): Long
+
+    /** @return the next completion of the submitted detections, in the submission order, or null if there is none. */
+    fun pollDetectionCompletion(): DetectionCompletion?
+
+    /**
+     * Waits for the next completion of the submitted detections, in the submission order.
+     *
+     * @param timeoutMs the maximum duration to wait for, in milliseconds.
+     * @return the completion, or null if there is none before the timeout.
+     */
+    fun awaitDetectionCompletion(timeoutMs: Long): DetectionCompletion?
+
+    /** @return the counters collected by the detector since its creation. */
+    fun getMetrics(): DetectionMetrics
 }
 
 /** The minimum detection quality for the algorithm. */
@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.detection
+
+/**
+ * The numerical precision of the text detection models inferences.
+ * Ordinals must match the C++ InferencePrecision enum (FP32=0, FP16=1, INT8=2).
+ */
+enum class InferencePrecision {
+    /** Full precision, slowest. Reference for the accuracy of the other modes. */
+    FP32,
+    /** Half precision, where supported by the CPU. */
+    FP16,
+    /**
+     * Quantized inferences, lowest latency and memory. Requires the int8 model files, models without them use [FP16].
+     * Accuracy loss depends on the alphabet, see scripts/ocr-models/evaluation.
+     */
+    INT8,
+}
@@ -21,6 +21,7 @@ import android.graphics.Point
 import android.graphics.Rect
 import androidx.annotation.Keep
 import com.buzbuz.smartautoclicker.core.base.extensions.throwWithKeys
+import java.util.concurrent.atomic.AtomicInteger
 
 /**
  * Native implementation of the image detector.
@@ -47,6 +48,9 @@ class NativeDetector private constructor() : ImageDetector {
     private var isClosed: Boolean = false
     private var screenDimensions: Point = Point(0, 0)
 
+    /** Number of detections submitted to the native worker whose completion hasn't been retrieved yet. */
+    private val submittedDetections: AtomicInteger = AtomicInteger(0)
+
     override fun init() {
         nativePtr = newDetector()
     }
@@ -58,19 +62,74 @@ class NativeDetector private constructor() : ImageDetector {
         deleteDetector()
     }
 
-    override fun loadTextDetectionModels(detectionModelPath: String, recognitionModels: Map<String, String>): Boolean {
+    override fun loadTextDetectionModels(
+        detectionModelPath: String,
+        recognitionModels: Map<String, String>,
+        warmUp: Boolean,
+        detectionPrecision: InferencePrecision,
+        recognitionPrecision: InferencePrecision,
+    ): Boolean {
         if (isClosed) return false
+        checkNoSubmittedDetection()
 
         return loadDetectionModels(
             detectionModelPath = detectionModelPath,
             recognitionModelIds = recognitionModels.keys.toTypedArray(),
             recognitionModelsPaths = recognitionModels.values.toTypedArray(),
+            warmUp = warmUp,
+            detectionPrecision = detectionPrecision.ordinal,
+            recognitionPrecision = recognitionPrecision.ordinal,
         )
     }
 
 
+    override fun isTextDetectionModelReady(recognitionModelId: String): Boolean {
+        if (isClosed) return false
+        checkNoSubmittedDetection()
+        return isTextDetectionModelReadyNative(recognitionModelId)
+    }
+
+    override fun setExecutionPolicy(threadCount: Int, coreAffinity: CoreAffinity) {
+        if (isClosed) return
+        setExecutionPolicyNative(threadCount, coreAffinity.ordinal)
+    }
+
+    override fun setRecognitionMemoryBudget(budgetBytes: Long) {
+        if (isClosed) return
+        checkNoSubmittedDetection()
+        setRecognitionMemoryBudgetNative(budgetBytes)
+    }
+
+    override fun setFrameBudget(budgetMs: Long) {
+        if (isClosed) return
+        checkNoSubmittedDetection()
+        setFrameBudgetNative(budgetMs)
+    }
+
+    override fun setRefreshScheduling(enabled: Boolean) {
+        if (isClosed) return
+        checkNoSubmittedDetection()
+        setRefreshSchedulingNative(enabled)
+    }
+
+    override fun cancelDetection() {
+        if (isClosed) return
+        cancelDetectionNative()
+    }
+
+    override fun resetCancellation() {
+        if (isClosed) return
+        resetCancellationNative()
+    }
+
+    override fun isDetectionCancelled(): Boolean {
+        if (isClosed) return false
+        return isDetectionCancelledNative()
+    }
+
     override fun setScreenBitmap(screenBitmap: Bitmap, metadata: String) {
         if (isClosed) return
+        checkNoSubmittedDetection()
 
         screenDimensions.x = screenBitmap.width
         screenDimensions.y = screenBitmap.height
@@ -85,6 +144,7 @@ class NativeDetector private constructor() : ImageDetector {
         threshold: Int,
     ): DetectionResult {
         if (isClosed) return DetectionResult()
+        checkNoSubmittedDetection()
 
         return try {
             detectImageNative(
@@ -113,6 +173,7 @@ class NativeDetector private constructor() : ImageDetector {
 
     override fun detectColor(conditionColor: Int, detectionArea: Rect, threshold: Int): DetectionResult {
         if (isClosed) return DetectionResult()
+        checkNoSubmittedDetection()
 
         return try {
             detectColorNative(
@@ -141,9 +202,11 @@ class NativeDetector private constructor() : ImageDetector {
         recognitionModelId: String,
         detectionArea: Rect,
         threshold: Int,
+        refreshPeriodMs: Long,
     ): DetectionResult {
 
         if (isClosed) return DetectionResult()
+        checkNoSubmittedDetection()
 
         return try {
             detectTextNative(
@@ -153,7 +216,8 @@ class NativeDetector private constructor() : ImageDetector {
                 y = detectionArea.top,
                 width = detectionArea.width(),
                 height = detectionArea.height(),
-                threshold
+                threshold,
+                refreshPeriodMs,
             ).toDetectionResult()
         } catch (ex: Exception) {
             ex.throwWithKeys(
@@ -169,8 +233,50 @@ class NativeDetector private constructor() : ImageDetector {
         }
     }
 
-    override fun detectNumber(detectionArea: Rect, threshold: Int, numberFormatType: NumberFormatType): DetectionResult {
+    override fun detectTexts(
+        conditionTexts: List<String>,
+        recognitionModelId: String,
+        detectionArea: Rect,
+        thresholds: List<Int>,
+        refreshPeriodMs: Long,
+    ): List<DetectionResult> {
+
+        if (isClosed) return List(conditionTexts.size) { DetectionResult() }
+        checkNoSubmittedDetection()
+
+        return try {
+            detectTextsNative(
+                conditionTexts = conditionTexts.toTypedArray(),
+                recognitionModelId = recognitionModelId,
+                x = detectionArea.left,
+                y = detectionArea.top,
+                width = detectionArea.width(),
+                height = detectionArea.height(),
+                thresholds = thresholds.toIntArray(),
+                refreshPeriodMs = refreshPeriodMs,
+            ).toDetectionResults(conditionTexts.size)
+        } catch (ex: Exception) {
+            ex.throwWithKeys(
+                keys = mapOf(
+                    "screenSize" to "${screenDimensions.x}x${screenDimensions.y}",
+                    "recognitionModelId" to recognitionModelId,
+                    "conditionTexts" to conditionTexts.toString(),
+                    "detectionArea" to detectionArea.toString(),
+                    "thresholds" to thresholds.toString(),
+                ),
+            )
+            List(conditionTexts.size) { DetectionResult() }
+        }
+    }
+
+    override fun detectNumber(
+        detectionArea: Rect,
+        threshold: Int,
+        numberFormatType: NumberFormatType,
+        refreshPeriodMs: Long,
+    ): DetectionResult {
         if (isClosed) return DetectionResult()
+        checkNoSubmittedDetection()
 
         return try {
             detectNumberNative(
@@ -180,6 +286,7 @@ class NativeDetector private constructor() : ImageDetector {
                 height = detectionArea.height(),
                 threshold = threshold,
                 numberFormat = numberFormatType.ordinal,
+                refreshPeriodMs = refreshPeriodMs,
             ).toDetectionResult()
         } catch (ex: Exception) {
             ex.throwWithKeys(
@@ -195,9 +302,102 @@ class NativeDetector private constructor() : ImageDetector {
 
     override fun releaseScreenBitmap(screenBitmap: Bitmap) {
         if (isClosed) return
+        checkNoSubmittedDetection()
         releaseScreenImage(screenBitmap)
     }
 
+    override fun submitDetection(screenBitmap: Bitmap, metadata: String, requests: List<DetectionRequest>): Long {
+        if (isClosed) return 0
+
+        val types = IntArray(requests.size)
+        val areas = IntArray(requests.size * 4)
+        val thresholds = IntArray(requests.size)
+        val parameters = IntArray(requests.size * 2)
+        val conditionBitmaps = arrayOfNulls<Bitmap>(requests.size)
+        val conditionTexts = arrayOfNulls<String>(requests.size)
+        val recognitionModelIds = arrayOfNulls<String>(requests.size)
+
+        requests.forEachIndexed { index, request ->
+            types[index] = request.nativeType
+            areas[index * 4] = request.detectionArea.left
+            areas[index * 4 + 1] = request.detectionArea.top
+            areas[index * 4 + 2] = request.detectionArea.width()
+            areas[index * 4 + 3] = request.detectionArea.height()
+            thresholds[index] = request.threshold
+
+            when (request) {
+                is DetectionRequest.Image -> {
+                    conditionBitmaps[index] = request.conditionBitmap
+                    parameters[index * 2] = request.conditionWidth
+                    parameters[index * 2 + 1] = request.conditionHeight
+                }
+                is DetectionRequest.Color -> parameters[index * 2] = request.conditionColor
+                is DetectionRequest.Text -> {
+                    parameters[index * 2] = request.refreshPeriodMs.toInt()
+                    conditionTexts[index] = request.conditionText
+                    recognitionModelIds[index] = request.recognitionModelId
+                }
+                is DetectionRequest.Number -> {
+                    parameters[index * 2] = request.numberFormatType.ordinal
+                    parameters[index * 2 + 1] = request.refreshPeriodMs.toInt()
+                }
+            }
+        }
+
+        screenDimensions.x = screenBitmap.width
+        screenDimensions.y = screenBitmap.height
+        return try {
+            val ticket = submitDetectionNative(
+                screenBitmap = screenBitmap,
+                metricsTag = metadata,
+                types = types,
+                areas = areas,
+                thresholds = thresholds,
+                parameters = parameters,
+                conditionBitmaps = conditionBitmaps,
+                conditionTexts = conditionTexts,
+                recognitionModelIds = recognitionModelIds,
+            )
+            if (ticket != 0L) submittedDetections.incrementAndGet()
+            ticket
+        } catch (ex: Exception) {
+            ex.throwWithKeys(
+                keys = mapOf(
+                    "screenSize" to "${screenDimensions.x}x${screenDimensions.y}",
+                    "requestCount" to requests.size.toString(),
+                ),
+            )
+            0
+        }
+    }
+
+    override fun pollDetectionCompletion(): DetectionCompletion? {
+        if (isClosed) return null
+        return pollDetectionCompletionNative(0).toDetectionCompletion()?.also { submittedDetections.decrementAndGet() }
+    }
+
+    override fun awaitDetectionCompletion(timeoutMs: Long): DetectionCompletion? {
+        if (isClosed) return null
+        return pollDetectionCompletionNative(timeoutMs).toDetectionCompletion()
+            ?.also { submittedDetections.decrementAndGet() }
+    }
+
+    override fun getMetrics(): DetectionMetrics {
+        if (isClosed) return DetectionMetrics()
+        checkNoSubmittedDetection()
+        return getMetricsNative().toDetectionMetrics()
+    }
+
+    /**
+     * The native detector is shared with the worker thread while submitted detections are pending, so the methods
+     * using it from the caller thread are rejected until all completions have been retrieved.
+     */
+    private fun checkNoSubmittedDetection() {
+        check(submittedDetections.get() == 0) {
+            "${submittedDetections.get()} submitted detections are not completed, retrieve their completion first"
+        }
+    }
+
     /**
      * Creates the detector. Must be called before any other methods.
      * Call [close] to release resources once the detection process is finished.
@@ -219,8 +419,61 @@ class NativeDetector private constructor() : ImageDetector {
         detectionModelPath: String,
         recognitionModelIds: Array<String>,
         recognitionModelsPaths: Array<String>,
+        warmUp: Boolean,
+        detectionPrecision: Int,
+        recognitionPrecision: Int,
     ): Boolean
 
+    /**
+     * Native method for the text detection models loading state.
+     *
+     * @param recognitionModelId the identifier of the recognition model.
+     * @return true if the text detection and recognition models are loaded.
+     */
+    private external fun isTextDetectionModelReadyNative(recognitionModelId: String): Boolean
+
+    /**
+     * Native method for the CPU usage setup.
+     *
+     * @param threadCount the number of threads used by the detection, 0 for the number of cores of the affinity.
+     * @param coreAffinity the ordinal of the [CoreAffinity] of the detection threads.
+     */
+    private external fun setExecutionPolicyNative(threadCount: Int, coreAffinity: Int)
+
+    /**
+     * Native method for the recognition models memory budget.
+     *
+     * @param budgetBytes the memory budget in bytes, or 0 for no limit.
+     */
+    private external fun setRecognitionMemoryBudgetNative(budgetBytes: Long)
+
+    /**
+     * Native method for the frame detection budget.
+     *
+     * @param budgetMs the budget of a frame in milliseconds, or 0 for no budget.
+     */
+    private external fun setFrameBudgetNative(budgetMs: Long)
+
+    /**
+     * Native method for the refresh scheduling of the text conditions.
+     *
+     * @param enabled true to enable, false to detect all conditions on every frame.
+     */
+    private external fun setRefreshSchedulingNative(enabled: Boolean)
+
+    /** Native method cancelling the running and following detections. */
+    private external fun cancelDetectionNative()
+
+    /** Native method allowing the detections again after a cancellation. */
+    private external fun resetCancellationNative()
+
+    /**
+     * Native method for the cancellation state.
+     *
+     * @return true if the detections are cancelled.
+     */
+    private external fun isDetectionCancelledNative(): Boolean
+
     /**
      * Native method for detection setup.
      *
@@ -280,6 +533,7 @@ class NativeDetector private constructor() : ImageDetector {
      * @param width the width of the condition.
      * @param height the height of the condition.
      * @param threshold the allowed error threshold allowed for the condition.
+     * @param refreshPeriodMs the refresh period hint of the condition, or 0 to adapt it to its changes.
      */
     private external fun detectTextNative(
         conditionText: String,
@@ -289,6 +543,30 @@ class NativeDetector private constructor() : ImageDetector {
         width: Int,
         height: Int,
         threshold: Int,
+        refreshPeriodMs: Long,
+    ): DoubleArray?
+
+    /**
+     * Native method for detecting if several texts are at a specific position in the current screen bitmap.
+     *
+     * @param conditionTexts the conditions to detect in the screen.
+     * @param recognitionModelId the identifier of the recognition model specified with [init].
+     * @param x the horizontal position of the conditions.
+     * @param y the vertical position of the conditions.
+     * @param width the width of the conditions.
+     * @param height the height of the conditions.
+     * @param thresholds the allowed error threshold allowed for each condition.
+     * @param refreshPeriodMs the refresh period hint of the conditions, or 0 to adapt it to their changes.
+     */
+    private external fun detectTextsNative(
+        conditionTexts: Array<String>,
+        recognitionModelId: String,
+        x: Int,
+        y: Int,
+        width: Int,
+        height: Int,
+        thresholds: IntArray,
+        refreshPeriodMs: Long,
     ): DoubleArray?
 
     /**
@@ -299,6 +577,8 @@ class NativeDetector private constructor() : ImageDetector {
      * @param width the width of the condition.
      * @param height the height of the condition.
      * @param threshold the allowed error threshold allowed for the condition.
+     * @param numberFormat the ordinal of the [NumberFormatType] of the number.
+     * @param refreshPeriodMs the refresh period hint of the condition, or 0 to adapt it to its changes.
      */
     private external fun detectNumberNative(
         x: Int,
@@ -307,8 +587,45 @@ class NativeDetector private constructor() : ImageDetector {
         height: Int,
         threshold: Int,
         numberFormat: Int,
+        refreshPeriodMs: Long,
     ): DoubleArray?
 
     /** Native method for releasing the screen image resources set with [setScreenImage]. */
     private external fun releaseScreenImage(screenBitmap: Bitmap)
+
+    /**
+     * Native method for submitting an asynchronous detection.
+     *
+     * @param screenBitmap the content of the screen as a bitmap, copied before returning.
+     * @param metricsTag the tag for the metrics of this screen content.
+     * @param types the native type of each request.
+     * @param areas the detection area of each request, as 4 values: x, y, width and height.
+     * @param thresholds the threshold of each request.
+     * @param parameters 2 values per request: the condition size for images, the color for colors, the refresh
+     * period for texts, the number format ordinal and the refresh period for numbers.
+     * @param conditionBitmaps the condition bitmap of each image request, null for the others.
+     * @param conditionTexts the condition text of each text request, null for the others.
+     * @param recognitionModelIds the recognition model of each text request, null for the others.
+     */
+    private external fun submitDetectionNative(
+        screenBitmap: Bitmap,
+        metricsTag: String,
+        types: IntArray,
+        areas: IntArray,
+        thresholds: IntArray,
+        parameters: IntArray,
+        conditionBitmaps: Array<Bitmap?>,
+        conditionTexts: Array<String?>,
+        recognitionModelIds: Array<String?>,
+    ): Long
+
+    /**
+     * Native method for getting the next completion of the submitted detections.
+     *
+     * @param timeoutMs the maximum duration to wait for a completion, in milliseconds. 0 to return immediately.
+     */
+    private external fun pollDetectionCompletionNative(timeoutMs: Long): DoubleArray?
+
+    /** Native method for getting the counters collected by the detector. */
+    private external fun getMetricsNative(): LongArray?
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "scheduling/frame_budget.hpp"
+
+using namespace smartautoclicker;
+
+namespace {
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    constexpr int64_t testBudgetMs = 16;
+    constexpr int maxDeferredFrames = 5;
+    const cv::Rect testRoi(10, 20, 300, 60);
+
+    TimePoint atMs(double ms) {
+        return TimePoint() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::milli>(ms));
+    }
+
+    class FrameBudgetTests : public ::testing::Test {
+
+    protected:
+        FrameBudget frameBudget;
+        const uint64_t conditionKey = FrameBudget::computeTextKey(testRoi, "Score", "LATIN");
+
+        void SetUp() override {
+            frameBudget.setBudget(testBudgetMs);
+        }
+
+        /** Starts a frame and detects the condition during durationMs if the budget allows it. */
+        bool detectFrame(double frameStartMs, double durationMs) {
+            frameBudget.startFrame(atMs(frameStartMs));
+            if (!frameBudget.tryStart(conditionKey, atMs(frameStartMs))) return false;
+
+            frameBudget.finish(conditionKey, atMs(frameStartMs), atMs(frameStartMs + durationMs));
+            return true;
+        }
+    };
+
+    TEST_F(FrameBudgetTests, disabledBudget_neverDeferred) {
+        frameBudget.setBudget(0);
+
+        EXPECT_FALSE(frameBudget.isEnabled());
+        for (int frame = 0; frame < 10; ++frame) EXPECT_TRUE(detectFrame(frame * 100.0, 50.0));
+        EXPECT_EQ(0.0, frameBudget.getEstimatedCost(conditionKey));
+        EXPECT_EQ(0u, frameBudget.getDeferredCount());
+        EXPECT_EQ(0u, frameBudget.getOverrunCount());
+    }
+
+    TEST_F(FrameBudgetTests, unknownCost_alwaysDetected) {
+        frameBudget.startFrame(atMs(0));
+
+        EXPECT_TRUE(frameBudget.tryStart(conditionKey, atMs(testBudgetMs * 10)));
+        EXPECT_EQ(0u, frameBudget.getDeferredCount());
+    }
+
+    TEST_F(FrameBudgetTests, costLearned_movingAverage) {
+        detectFrame(0, 10.0);
+        EXPECT_DOUBLE_EQ(10.0, frameBudget.getEstimatedCost(conditionKey));
+
+        detectFrame(100, 20.0);
+        EXPECT_DOUBLE_EQ(13.0, frameBudget.getEstimatedCost(conditionKey));
+    }
+
+    TEST_F(FrameBudgetTests, costAboveRemainingBudget_deferred) {
+        detectFrame(0, 10.0);
+
+        frameBudget.startFrame(atMs(100));
+        EXPECT_TRUE(frameBudget.tryStart(conditionKey, atMs(105)));
+        EXPECT_FALSE(frameBudget.tryStart(conditionKey, atMs(108)));
+        EXPECT_EQ(1u, frameBudget.getDeferredCount());
+    }
+
+    TEST_F(FrameBudgetTests, costAboveWholeBudget_detectedAfterMaxDeferredFrames) {
+        detectFrame(0, testBudgetMs * 2.0);
+
+        for (int cycle = 0; cycle < 3; ++cycle) {
+            for (int deferred = 0; deferred < maxDeferredFrames; ++deferred) {
+                EXPECT_FALSE(frameBudget.tryStart(conditionKey, atMs(0))) << "cycle " << cycle;
+            }
+            EXPECT_TRUE(frameBudget.tryStart(conditionKey, atMs(0))) << "cycle " << cycle;
+        }
+        EXPECT_EQ(3u * maxDeferredFrames, frameBudget.getDeferredCount());
+    }
+
+    TEST_F(FrameBudgetTests, frameOverrun_countedOncePerFrame) {
+        const uint64_t otherKey = FrameBudget::computeNumberKey(testRoi, 0);
+
+        frameBudget.startFrame(atMs(0));
+        frameBudget.finish(conditionKey, atMs(0), atMs(testBudgetMs + 1));
+        frameBudget.finish(otherKey, atMs(testBudgetMs + 1), atMs(testBudgetMs + 5));
+        EXPECT_EQ(1u, frameBudget.getOverrunCount());
+
+        frameBudget.startFrame(atMs(100));
+        frameBudget.finish(0, atMs(100), atMs(100 + testBudgetMs - 1));
+        EXPECT_EQ(1u, frameBudget.getOverrunCount());
+        EXPECT_EQ(0.0, frameBudget.getEstimatedCost(0));
+    }
+
+    TEST(FrameBudgetKeysTests, conditionKeys_differByParameters) {
+        const uint64_t textKey = FrameBudget::computeTextKey(testRoi, "Score", "LATIN");
+
+        EXPECT_EQ(textKey, FrameBudget::computeTextKey(testRoi, "Score", "LATIN"));
+        EXPECT_NE(textKey, FrameBudget::computeTextKey(testRoi, "Scor", "eLATIN"));
+        EXPECT_NE(textKey, FrameBudget::computeTextKey(testRoi, "Score", "KOREAN"));
+        EXPECT_NE(textKey, FrameBudget::computeTextKey(cv::Rect(10, 20, 300, 61), "Score", "LATIN"));
+        EXPECT_NE(FrameBudget::computeNumberKey(testRoi, 0), FrameBudget::computeNumberKey(testRoi, 1));
+    }
+
+    TEST(FrameBudgetKeysTests, groupKey_orderIndependent) {
+        const uint64_t a = FrameBudget::computeTextKey(testRoi, "A", "LATIN");
+        const uint64_t b = FrameBudget::computeTextKey(testRoi, "B", "LATIN");
+        const uint64_t c = FrameBudget::computeTextKey(testRoi, "C", "LATIN");
+
+        EXPECT_EQ(FrameBudget::computeGroupKey({ a, b, c }), FrameBudget::computeGroupKey({ c, a, b }));
+        EXPECT_EQ(FrameBudget::computeGroupKey({ a, b, c }), FrameBudget::computeGroupKey({ b, c, a }));
+    }
+
+    TEST(FrameBudgetKeysTests, groupKey_duplicatesDontCancel) {
+        const uint64_t a = FrameBudget::computeTextKey(testRoi, "A", "LATIN");
+        const uint64_t b = FrameBudget::computeTextKey(testRoi, "B", "LATIN");
+
+        EXPECT_NE(FrameBudget::computeGroupKey({ a, a }), FrameBudget::computeGroupKey({}));
+        EXPECT_NE(FrameBudget::computeGroupKey({ a, a }), FrameBudget::computeGroupKey({ a }));
+        EXPECT_NE(FrameBudget::computeGroupKey({ a, b, b }), FrameBudget::computeGroupKey({ a }));
+        EXPECT_NE(FrameBudget::computeGroupKey({ a, a, b, b }), FrameBudget::computeGroupKey({ a, b }));
+        EXPECT_NE(FrameBudget::computeGroupKey({ a, b }), a ^ b);
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef KLICK_R_REFERENCE_TEXT_SIMILARITY_HPP
+#define KLICK_R_REFERENCE_TEXT_SIMILARITY_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace smartautoclicker::reference {
+
+    /**
+     * The text similarity as computed by the TextMatcher before the bit-parallel TextSimilarity: a dynamic
+     * programming optimal string alignment distance per window, with the row minimum early exit.
+     *
+     * Kept as is, only templated on the string type so it can run on bytes, like the original did, and on code
+     * points, which is what TextSimilarity must be equivalent to for non ASCII texts.
+     */
+    template <typename String>
+    class ReferenceTextSimilarity {
+
+    public:
+        using Char = typename String::value_type;
+
+        float bestSubstringSimilarity(const String& recognized, const String& target, float minSimilarity = 0.80f) {
+            if (recognized.empty() || target.empty()) return 0.f;
+
+            // Fast exact substring match
+            if (recognized.find(target) != String::npos) return 1.f;
+
+            const int targetLen = static_cast<int>(target.size());
+            const int recognizedLen = static_cast<int>(recognized.size());
+
+            // Fast path
+            if (recognizedLen <= targetLen + 2) return similarity(recognized, target, minSimilarity);
+
+            // Allow small OCR insertions/deletions
+            float bestScore = 0.f;
+            const int minWindow = std::max(1, targetLen - 2);
+            const int maxWindow = std::min(recognizedLen, targetLen + 4);
+
+            String window;
+            for (int windowSize = minWindow; windowSize <= maxWindow; ++windowSize) {
+                for (int start = 0; start <= recognizedLen - windowSize; ++start) {
+                    window.assign(recognized.data() + start, windowSize);
+
+                    float score = similarity(window, target, minSimilarity);
+                    if (score > bestScore) {
+                        bestScore = score;
+
+                        // Early success exit
+                        if (bestScore >= 0.95f) return bestScore;
+                    }
+                }
+            }
+
+            return bestScore;
+        }
+
+    private:
+        std::vector<int> comparisonPrevRow;
+        std::vector<int> comparisonCurrRow;
+        std::vector<int> comparisonPrevPrevRow;
+
+        float similarity(const String& recognized, const String& target, float minSimilarity) {
+            if (recognized.empty() || target.empty()) return 0.f;
+
+            const int n = static_cast<int>(recognized.size());
+            const int m = static_cast<int>(target.size());
+            const int maxLen = std::max(n, m);
+
+            // Early impossible length check
+            int maxAllowedDistance = static_cast<int>((1.f - minSimilarity) * maxLen);
+            if (std::abs(n - m) > maxAllowedDistance) return 0.f;
+
+            comparisonPrevPrevRow.resize(m + 1);
+            comparisonPrevRow.resize(m + 1);
+            comparisonCurrRow.resize(m + 1);
+
+            for (int j = 0; j <= m; ++j) comparisonPrevRow[j] = j;
+
+            for (int i = 1; i <= n; ++i) {
+                comparisonCurrRow[0] = i;
+                int rowMin = comparisonCurrRow[0];
+
+                Char ca = normalizeChar(recognized[i - 1]);
+                for (int j = 1; j <= m; ++j) {
+                    Char cb = normalizeChar(target[j - 1]);
+
+                    int cost = (ca == cb) ? 0 : 1;
+
+                    int deletion = comparisonPrevRow[j] + 1;
+                    int insertion = comparisonCurrRow[j - 1] + 1;
+                    int substitution = comparisonPrevRow[j - 1] + cost;
+                    int value = std::min({ deletion, insertion, substitution });
+
+                    // Damerau transposition
+                    if (i > 1 && j > 1 && ca == normalizeChar(target[j - 2]) && normalizeChar(recognized[i - 2]) == cb) {
+                        value = std::min(value, comparisonPrevPrevRow[j - 2] + 1);
+                    }
+
+                    comparisonCurrRow[j] = value;
+                    rowMin = std::min(rowMin, value);
+                }
+
+                // Early exit
+                if (rowMin > maxAllowedDistance) return 0.f;
+
+                std::swap(comparisonPrevPrevRow, comparisonPrevRow);
+                std::swap(comparisonPrevRow, comparisonCurrRow);
+            }
+
+            int distance = comparisonPrevRow[m];
+
+            float score = 1.f - (float)distance / (float)maxLen;
+            return std::max(0.f, score);
+        }
+
+        static Char normalizeChar(Char c) {
+            if (c >= 'A' && c <= 'Z') return static_cast<Char>(c + 32);
+            return c;
+        }
+    };
+}
+
+#endif //KLICK_R_REFERENCE_TEXT_SIMILARITY_HPP
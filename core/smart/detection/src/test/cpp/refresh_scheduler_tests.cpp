@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "scheduling/refresh_scheduler.hpp"
+
+using namespace smartautoclicker;
+
+namespace {
+
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    constexpr double frameIntervalMs = 10.0;
+    /** The first frame time, a zero time is considered as no previous frame. */
+    constexpr double firstFrameMs = 1000.0;
+    constexpr uint64_t conditionKey = 42;
+
+    class RefreshSchedulerTests : public ::testing::Test {
+
+    protected:
+        RefreshScheduler scheduler;
+        int frameIndex = 0;
+
+        void SetUp() override {
+            scheduler.setEnabled(true);
+        }
+
+        void startNextFrame() {
+            scheduler.startFrame(TimePoint() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double, std::milli>(firstFrameMs + frameIndex * frameIntervalMs)));
+            frameIndex++;
+        }
+
+        /** Starts a frame and refreshes the condition if due. @return true if the condition has been refreshed. */
+        bool refreshFrame(uint64_t key, int64_t refreshPeriodMs, bool isChanged) {
+            startNextFrame();
+            if (!scheduler.isRefreshDue(key, refreshPeriodMs)) return false;
+
+            scheduler.onRefreshed(key, refreshPeriodMs, isChanged);
+            return true;
+        }
+
+        /** Runs the frames and get the number of frames between each refresh of an unchanged condition. */
+        std::vector<int> getRefreshIntervals(int frameCount, int64_t refreshPeriodMs) {
+            std::vector<int> intervals;
+            int lastRefreshFrame = -1;
+            for (int frame = 0; frame < frameCount; ++frame) {
+                if (!refreshFrame(conditionKey, refreshPeriodMs, false)) continue;
+
+                if (lastRefreshFrame >= 0) intervals.push_back(frame - lastRefreshFrame);
+                lastRefreshFrame = frame;
+            }
+            return intervals;
+        }
+    };
+
+    TEST_F(RefreshSchedulerTests, disabled_alwaysDue) {
+        scheduler.setEnabled(false);
+
+        for (int frame = 0; frame < 20; ++frame) EXPECT_TRUE(refreshFrame(conditionKey, 1000, false));
+    }
+
+    TEST_F(RefreshSchedulerTests, unknownCondition_due) {
+        startNextFrame();
+
+        EXPECT_TRUE(scheduler.isRefreshDue(conditionKey, 1000));
+        EXPECT_TRUE(scheduler.isRefreshDue(conditionKey, 0));
+    }
+
+    TEST_F(RefreshSchedulerTests, unchangedResult_periodDoubledUpToOneSecond) {
+        // Every frame, then the period doubles from a frame interval, until 1 second (100 frames)
+        const std::vector<int> expected = { 1, 1, 2, 4, 8, 16, 32, 64, 100, 100 };
+
+        EXPECT_EQ(expected, getRefreshIntervals(329, 0));
+    }
+
+    TEST_F(RefreshSchedulerTests, changedResult_periodReset) {
+        getRefreshIntervals(65, 0);
+        ASSERT_FALSE(scheduler.isRefreshDue(conditionKey, 0));
+
+        // Period is 640ms, wait for the next refresh and change the result
+        int waitedFrames = 0;
+        while (!refreshFrame(conditionKey, 0, true)) ASSERT_LT(++waitedFrames, 100);
+
+        EXPECT_TRUE(refreshFrame(conditionKey, 0, false));
+        EXPECT_TRUE(refreshFrame(conditionKey, 0, false));
+        EXPECT_FALSE(refreshFrame(conditionKey, 0, false));
+    }
+
+    TEST_F(RefreshSchedulerTests, hintedPeriod_refreshedAtThisPeriod) {
+        EXPECT_EQ(std::vector<int>({ 5, 5, 5, 5 }), getRefreshIntervals(21, 50));
+    }
+
+    TEST_F(RefreshSchedulerTests, hintedPeriod_changesIgnored) {
+        startNextFrame();
+        for (int frame = 0; frame < 20; ++frame) {
+            bool isRefreshed = refreshFrame(conditionKey, 30, true);
+            EXPECT_EQ(frame % 3 == 0, isRefreshed) << "frame " << frame;
+        }
+    }
+
+    TEST_F(RefreshSchedulerTests, sameFrameRefreshes_spreadOverNextFrames) {
+        constexpr uint64_t conditionKeys[] = { 1, 2, 3, 4 };
+        constexpr int64_t periodMs = 40;
+
+        // The frame interval is known from the second frame
+        startNextFrame();
+        startNextFrame();
+        for (uint64_t key : conditionKeys) {
+            ASSERT_TRUE(scheduler.isRefreshDue(key, periodMs));
+            scheduler.onRefreshed(key, periodMs, false);
+        }
+
+        // Round-robin phases, a single condition is refreshed on each following frame
+        for (int frame = 0; frame < 12; ++frame) {
+            startNextFrame();
+            int dueCount = 0;
+            for (uint64_t key : conditionKeys) {
+                if (!scheduler.isRefreshDue(key, periodMs)) continue;
+                scheduler.onRefreshed(key, periodMs, false);
+                dueCount++;
+            }
+            EXPECT_EQ(1, dueCount) << "frame " << frame;
+        }
+    }
+
+    TEST_F(RefreshSchedulerTests, amortizedCount) {
+        scheduler.onAmortized();
+        scheduler.onAmortized();
+
+        EXPECT_EQ(2u, scheduler.getAmortizedCount());
+    }
+}
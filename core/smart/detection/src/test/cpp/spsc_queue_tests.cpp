@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <memory>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "utils/spsc_queue.hpp"
+
+using namespace smartautoclicker;
+
+namespace {
+
+    /** Same capacity as the completions queue of the detection worker. */
+    constexpr size_t testCapacity = 8;
+
+    TEST(SpscQueueTests, emptyQueue_popFails) {
+        SpscQueue<int, testCapacity> queue;
+        int value = -1;
+
+        EXPECT_TRUE(queue.empty());
+        EXPECT_FALSE(queue.pop(value));
+        EXPECT_EQ(-1, value);
+    }
+
+    TEST(SpscQueueTests, fullQueue_pushRejected) {
+        SpscQueue<int, testCapacity> queue;
+        for (int i = 0; i < static_cast<int>(testCapacity); ++i) {
+            EXPECT_FALSE(queue.full());
+            EXPECT_TRUE(queue.push(int(i)));
+        }
+
+        EXPECT_TRUE(queue.full());
+        EXPECT_FALSE(queue.push(42));
+
+        // Rejected value isn't stored, the oldest value is still the first pushed
+        int value = -1;
+        EXPECT_TRUE(queue.pop(value));
+        EXPECT_EQ(0, value);
+        EXPECT_FALSE(queue.full());
+        EXPECT_TRUE(queue.push(42));
+    }
+
+    TEST(SpscQueueTests, wrapAround_fifoOrder) {
+        SpscQueue<int, testCapacity> queue;
+        int nextPushed = 0;
+        int nextPopped = 0;
+        int value = -1;
+
+        // Keep the queue partially filled so the indexes wrap many times around the slots
+        for (int i = 0; i < 3; ++i) ASSERT_TRUE(queue.push(int(nextPushed++)));
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 5; ++i) ASSERT_TRUE(queue.push(int(nextPushed++)));
+            ASSERT_TRUE(queue.full());
+            for (int i = 0; i < 5; ++i) {
+                ASSERT_TRUE(queue.pop(value));
+                ASSERT_EQ(nextPopped++, value);
+            }
+        }
+        while (queue.pop(value)) ASSERT_EQ(nextPopped++, value);
+
+        EXPECT_EQ(nextPushed, nextPopped);
+        EXPECT_TRUE(queue.empty());
+    }
+
+    TEST(SpscQueueTests, moveOnlyValues) {
+        SpscQueue<std::unique_ptr<int>, testCapacity> queue;
+        std::unique_ptr<int> value;
+
+        EXPECT_TRUE(queue.push(std::make_unique<int>(42)));
+        EXPECT_TRUE(queue.pop(value));
+        ASSERT_NE(nullptr, value);
+        EXPECT_EQ(42, *value);
+    }
+
+    TEST(SpscQueueTests, concurrentProducer_allValuesInOrder) {
+        constexpr int valueCount = 200000;
+        SpscQueue<int, testCapacity> queue;
+
+        // The producer spins on the full queue, like the detection worker waiting for the completions to be polled
+        std::thread producer([&queue]() {
+            for (int i = 0; i < valueCount; ++i) {
+                while (!queue.push(int(i))) std::this_thread::yield();
+            }
+        });
+
+        int expected = 0;
+        int value = -1;
+        while (expected < valueCount) {
+            if (!queue.pop(value)) {
+                std::this_thread::yield();
+                continue;
+            }
+            ASSERT_EQ(expected++, value);
+        }
+        producer.join();
+
+        EXPECT_TRUE(queue.empty());
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "matching/text/text_similarity.hpp"
+#include "reference/reference_text_similarity.hpp"
+
+using namespace smartautoclicker;
+
+namespace {
+
+    constexpr float minSimilarities[] = { 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 0.95f };
+
+    /** Generates random comparison cases, with a recognized text close to the target most of the time. */
+    class CaseGenerator {
+
+    public:
+        CaseGenerator(std::u32string alphabet, uint32_t seed) : alphabet(std::move(alphabet)), random(seed) {}
+
+        std::u32string newTarget(int minLength, int maxLength) {
+            return newText(pick(minLength, maxLength));
+        }
+
+        std::u32string newRecognized(const std::u32string& target) {
+            // Unrelated text, mostly rejected by the length and distance checks
+            if (pick(0, 4) == 0) return newText(pick(1, static_cast<int>(target.size()) + 12));
+
+            std::u32string recognized = target;
+            const int editCount = pick(0, std::max(1, static_cast<int>(target.size()) / 4));
+            for (int i = 0; i < editCount && !recognized.empty(); ++i) {
+                const size_t position = pick(0, static_cast<int>(recognized.size()) - 1);
+                switch (pick(0, 3)) {
+                    case 0: recognized[position] = newChar(); break;
+                    case 1: recognized.insert(position, 1, newChar()); break;
+                    case 2: recognized.erase(position, 1); break;
+                    case 3:
+                        if (position + 1 < recognized.size()) std::swap(recognized[position], recognized[position + 1]);
+                        break;
+                }
+            }
+
+            // Target part of a larger detected block
+            if (pick(0, 1) == 0) recognized = newText(pick(0, 8)) + recognized + newText(pick(0, 8));
+            return recognized;
+        }
+
+        float newMinSimilarity() {
+            return minSimilarities[pick(0, std::size(minSimilarities) - 1)];
+        }
+
+    private:
+        const std::u32string alphabet;
+        std::mt19937 random;
+
+        int pick(int min, int max) {
+            return std::uniform_int_distribution<int>(min, max)(random);
+        }
+
+        char32_t newChar() {
+            return alphabet[pick(0, static_cast<int>(alphabet.size()) - 1)];
+        }
+
+        std::u32string newText(int length) {
+            std::u32string text;
+            for (int i = 0; i < length; ++i) text.push_back(newChar());
+            return text;
+        }
+    };
+
+    std::string toAscii(const std::u32string& text) {
+        return { text.begin(), text.end() };
+    }
+
+    std::string toUtf8(const std::u32string& text) {
+        std::string utf8;
+        for (char32_t c : text) {
+            if (c < 0x80) {
+                utf8.push_back(static_cast<char>(c));
+            } else if (c < 0x800) {
+                utf8.push_back(static_cast<char>(0xC0 | (c >> 6)));
+                utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            } else if (c < 0x10000) {
+                utf8.push_back(static_cast<char>(0xE0 | (c >> 12)));
+                utf8.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            } else {
+                utf8.push_back(static_cast<char>(0xF0 | (c >> 18)));
+                utf8.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+                utf8.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+            }
+        }
+        return utf8;
+    }
+
+    /**
+     * Compares TextSimilarity with the reference on random cases.
+     * For ASCII texts, the reference runs on bytes, exactly as the previous implementation. For the other ones, it
+     * runs on code points, as TextSimilarity compares characters instead of bytes.
+     */
+    void compareWithReference(const std::u32string& alphabet, bool isAscii, int caseCount, int minTargetLength,
+                              int maxTargetLength, uint32_t seed) {
+        CaseGenerator generator(alphabet, seed);
+        TextSimilarity similarity;
+        reference::ReferenceTextSimilarity<std::string> asciiReference;
+        reference::ReferenceTextSimilarity<std::u32string> codePointsReference;
+
+        int mismatchCount = 0;
+        std::u32string target;
+        for (int i = 0; i < caseCount; ++i) {
+            // Keep the same target for a few cases, as the detection does for a condition
+            if (i % 4 == 0) target = generator.newTarget(minTargetLength, maxTargetLength);
+            const std::u32string recognized = generator.newRecognized(target);
+            const float minSimilarity = generator.newMinSimilarity();
+
+            float expected;
+            float actual;
+            std::string recognizedText;
+            std::string targetText;
+            if (isAscii) {
+                recognizedText = toAscii(recognized);
+                targetText = toAscii(target);
+                expected = asciiReference.bestSubstringSimilarity(recognizedText, targetText, minSimilarity);
+            } else {
+                recognizedText = toUtf8(recognized);
+                targetText = toUtf8(target);
+                expected = codePointsReference.bestSubstringSimilarity(recognized, target, minSimilarity);
+            }
+            actual = similarity.bestSubstringSimilarity(recognizedText, targetText, minSimilarity);
+
+            if (actual != expected) {
+                ADD_FAILURE() << "Case " << i << ": recognized=\"" << recognizedText << "\" target=\"" << targetText
+                    << "\" minSimilarity=" << minSimilarity << " expected=" << expected << " actual=" << actual;
+                if (++mismatchCount >= 10) return;
+            }
+        }
+    }
+}
+
+TEST(TextSimilarityTests, emptyTexts) {
+    TextSimilarity similarity;
+    EXPECT_EQ(0.f, similarity.bestSubstringSimilarity("", "target"));
+    EXPECT_EQ(0.f, similarity.bestSubstringSimilarity("recognized", ""));
+}
+
+TEST(TextSimilarityTests, exactSubstring) {
+    TextSimilarity similarity;
+    EXPECT_EQ(1.f, similarity.bestSubstringSimilarity("Score: 1200 pts", "1200"));
+}
+
+TEST(TextSimilarityTests, caseInsensitive) {
+    TextSimilarity similarity;
+    EXPECT_EQ(1.f, similarity.bestSubstringSimilarity("CONTINUE", "continue"));
+}
+
+TEST(TextSimilarityTests, transpositionIsOneEdit) {
+    TextSimilarity similarity;
+    EXPECT_FLOAT_EQ(1.f - 1.f / 8.f, similarity.bestSubstringSimilarity("cnotinue", "continue", 0.5f));
+}
+
+TEST(TextSimilarityTests, nonAsciiComparedPerCharacter) {
+    TextSimilarity similarity;
+    // One substituted character out of 4: a per byte comparison would count the 3 bytes of the Hangul syllable.
+    EXPECT_FLOAT_EQ(0.75f, similarity.bestSubstringSimilarity("확인하가", "확인하기", 0.5f));
+}
+
+TEST(TextSimilarityTests, sameAsReference_ascii_singleWordTargets) {
+    compareWithReference(U"abcdeABCDE 0123", true, 100000, 1, 64, 1);
+}
+
+TEST(TextSimilarityTests, sameAsReference_ascii_multiWordTargets) {
+    compareWithReference(U"abcdeABCDE 0123", true, 2000, 65, 150, 2);
+}
+
+TEST(TextSimilarityTests, sameAsReference_utf8_singleWordTargets) {
+    compareWithReference(U"abCDéÉßжא한글中文\U0001F600", false, 100000, 1, 64, 3);
+}
+
+TEST(TextSimilarityTests, sameAsReference_utf8_multiWordTargets) {
+    compareWithReference(U"abCDéÉßжא한글中文\U0001F600", false, 2000, 65, 150, 4);
+}
@@ -16,6 +16,7 @@
  */
 package com.buzbuz.smartautoclicker.core.processing.data
 
+import android.app.ActivityManager
 import android.content.Context
 import android.content.Intent
 import android.media.Image
@@ -215,6 +216,9 @@ class DetectorEngine @Inject constructor(
             // Setup text detection models if needed
             val requiredAlphabets = screenEvents.getAllOCRAlphabets()
             if (requiredAlphabets.isNotEmpty()) {
+                if (context.getSystemService(ActivityManager::class.java)?.isLowRamDevice == true) {
+                    detector.setRecognitionMemoryBudget(LOW_RAM_RECOGNITION_MODELS_BUDGET_BYTES)
+                }
                 if (!detector.loadOcrModels(requiredAlphabets)) {
                     _state.value = DetectorState.ERROR_OCR_MODEL_NOT_FOUND
                     return@launchProcessingJob
@@ -281,6 +285,9 @@ class DetectorEngine @Inject constructor(
 
         Log.d(TAG, "onOrientationChanged")
 
+        // The current frame have the previous orientation, stop its detection without waiting for it.
+        if (_state.value == DetectorState.DETECTING) imageDetector?.cancelDetection()
+
         orientationChangeJob?.cancel()
         orientationChangeJob = processingScope?.launch {
             delay(ORIENTATION_CHANGE_DEBOUNCE_MS.milliseconds)
@@ -319,11 +326,15 @@ class DetectorEngine @Inject constructor(
         }
         _state.value = DetectorState.TRANSITIONING
 
+        // The processing scope is busy with the current detection, cancel it from here to stop it quickly.
+        imageDetector?.cancelDetection()
+
         processingShutdownJob = processingScope?.launch {
             Log.i(TAG, "stopDetection")
 
             processingJob?.cancelAndJoin()
             processingJob = null
+            imageDetector?.let { detector -> Log.i(TAG, "Detection metrics: ${detector.getMetrics()}") }
             imageDetector?.close()
             imageDetector = null
             scenarioProcessor?.onScenarioEnd()
@@ -373,6 +384,7 @@ class DetectorEngine @Inject constructor(
     /** Process the latest images provided by the [DisplayRecorder]. */
     private suspend fun processScreenImages() {
         _state.emit(DetectorState.DETECTING)
+        imageDetector?.resetCancellation()
 
         var processingDurationNs: Long
         while (processingJob?.isActive == true && !orientationChangeRequested) {
@@ -470,6 +482,11 @@ private const val ONE_SECOND_IN_NANO = 1000000000L
 private const val ONE_MILLISECOND_IN_NANO = 1000000L
 /** The default minimal processing duration in nanoseconds. */
 private const val DEFAULT_MIN_PROCESSING_DURATION_NS = ONE_MILLISECOND_IN_NANO
+/**
+ * Memory budget of the text recognition models on low RAM devices, in bytes. Keeps a few latin-like models loaded,
+ * the least recently used ones are unloaded when a scenario uses more alphabets.
+ */
+private const val LOW_RAM_RECOGNITION_MODELS_BUDGET_BYTES = 16L * 1024 * 1024
 
 /** Tag for logs. */
 private const val TAG = "DetectorEngine"
\ No newline at end of file
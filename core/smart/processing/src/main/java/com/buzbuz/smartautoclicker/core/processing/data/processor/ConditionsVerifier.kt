@@ -17,7 +17,9 @@
 package com.buzbuz.smartautoclicker.core.processing.data.processor
 
 import android.graphics.Bitmap
+import android.graphics.Rect
 
+import com.buzbuz.smartautoclicker.core.detection.DetectionResult
 import com.buzbuz.smartautoclicker.core.detection.ImageDetector
 import com.buzbuz.smartautoclicker.core.detection.NumberFormatType as DetectionNumberFormatType
 import com.buzbuz.smartautoclicker.core.domain.model.condition.NumberFormatType as DomainNumberFormatType
@@ -58,13 +60,20 @@ internal class ConditionsVerifier(
      */
     private var currentVerificationTsMs: Long? = null
 
+    /**
+     * Set only during a [verifyConditions], it contains the detection results of the text conditions detected along
+     * with a previous text condition sharing the same area and alphabet, mapped by condition id.
+     */
+    private val pendingTextResults: MutableMap<Long, DetectionResult> = mutableMapOf()
+
     suspend fun verifyConditions(@ConditionOperator operator: Int, conditions: List<Condition>): ConditionsResults {
         verificationResults.reset()
+        pendingTextResults.clear()
         currentVerificationTsMs = System.currentTimeMillis()
 
         var verificationResult: ProcessedConditionResult
-        for (condition in conditions) {
-            verificationResult = verifyCondition(condition)
+        for ((index, condition) in conditions.withIndex()) {
+            verificationResult = verifyCondition(condition, conditions.subList(index + 1, conditions.size))
             verificationResults.addResult(condition.getValidId(), verificationResult)
 
             if (operator == OR && verificationResult.isFulfilled) {
@@ -83,11 +92,11 @@ internal class ConditionsVerifier(
         return verificationResults
     }
 
-    private suspend fun verifyCondition(condition: Condition): ProcessedConditionResult =
+    private suspend fun verifyCondition(condition: Condition, nextConditions: List<Condition>): ProcessedConditionResult =
         when (condition) {
             is ScreenCondition.Color -> verifyColorCondition(condition)
             is ScreenCondition.Image -> verifyImageCondition(condition)
-            is ScreenCondition.Text -> verifyTextCondition(condition)
+            is ScreenCondition.Text -> verifyTextCondition(condition, nextConditions)
             is ScreenCondition.Number -> verifyNumberCondition(condition)
             is TriggerCondition -> condition.toConditionResult(verifyTriggerCondition(condition))
         }
@@ -236,19 +245,26 @@ internal class ConditionsVerifier(
         return result
     }
 
-    private fun verifyTextCondition(condition: ScreenCondition.Text): ProcessedConditionResult.Screen {
+    private fun verifyTextCondition(
+        condition: ScreenCondition.Text,
+        nextConditions: List<Condition>,
+    ): ProcessedConditionResult.Screen {
         progressListener?.onScreenConditionProcessingStarted()
 
         val conditionScalingInfo = scalingManager
             .getScreenConditionScalingInfo(condition) as? ScreenConditionScalingInfo.Text
             ?: return condition.toInvalidConditionResult()
 
-        val detectionResult = imageDetector.detectText(
-            conditionText = condition.text,
-            recognitionModelId = condition.alphabet.name,
-            detectionArea = conditionScalingInfo.detectionArea,
-            threshold = condition.threshold,
-        )
+        val detectionResult = pendingTextResults.remove(condition.getValidId())
+            ?: detectTextConditions(condition, conditionScalingInfo.detectionArea, nextConditions)
+
+        // The text models are still loading, nothing has been detected: the condition can't be fulfilled, even if the
+        // text should be absent, or its event actions would be executed without any detection.
+        if (detectionResult.isNotReady) {
+            val result = condition.toInvalidConditionResult()
+            progressListener?.onScreenConditionProcessingCompleted(result)
+            return result
+        }
 
         val result = ProcessedConditionResult.Screen(
             isFulfilled = detectionResult.isDetected == condition.shouldBeDetected,
@@ -263,6 +279,48 @@ internal class ConditionsVerifier(
         return result
     }
 
+    /**
+     * Detects the text condition, along with the next text conditions sharing its detection area and alphabet, using
+     * a single text recognition. The results of the next conditions are kept in [pendingTextResults] until their
+     * verification.
+     */
+    private fun detectTextConditions(
+        condition: ScreenCondition.Text,
+        detectionArea: Rect,
+        nextConditions: List<Condition>,
+    ): DetectionResult {
+        val sameAreaConditions = nextConditions
+            .filterIsInstance<ScreenCondition.Text>()
+            .filter { nextCondition ->
+                nextCondition.alphabet == condition.alphabet
+                        && !pendingTextResults.containsKey(nextCondition.getValidId())
+                        && (scalingManager.getScreenConditionScalingInfo(nextCondition) as? ScreenConditionScalingInfo.Text)
+                            ?.detectionArea == detectionArea
+            }
+
+        if (sameAreaConditions.isEmpty()) {
+            return imageDetector.detectText(
+                conditionText = condition.text,
+                recognitionModelId = condition.alphabet.name,
+                detectionArea = detectionArea,
+                threshold = condition.threshold,
+            )
+        }
+
+        val textConditions = listOf(condition) + sameAreaConditions
+        val detectionResults = imageDetector.detectTexts(
+            conditionTexts = textConditions.map { it.text },
+            recognitionModelId = condition.alphabet.name,
+            detectionArea = detectionArea,
+            thresholds = textConditions.map { it.threshold },
+        )
+
+        for (index in 1 until textConditions.size) {
+            pendingTextResults[textConditions[index].getValidId()] = detectionResults[index]
+        }
+        return detectionResults[0]
+    }
+
     private fun ScreenCondition.toInvalidConditionResult(): ProcessedConditionResult.Screen =
         ProcessedConditionResult.Screen(
             isFulfilled = false,
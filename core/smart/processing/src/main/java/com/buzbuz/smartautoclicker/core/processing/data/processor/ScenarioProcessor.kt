@@ -117,8 +117,8 @@ internal class ScenarioProcessor(
         // Handle the image detection
         if (!processingState.areAllScreenEventsDisabled()) {
             progressListener?.onEventsListProcessingStarted(EventType.Screen)
-            processScreenEvents(screenFrame)
-            progressListener?.onEventsProcessingCompleted(EventType.Screen)
+            if (processScreenEvents(screenFrame)) progressListener?.onEventsProcessingCompleted(EventType.Screen)
+            else progressListener?.onEventsProcessingCancelled()
         }
 
         // Loop is completed
@@ -149,7 +149,13 @@ internal class ScenarioProcessor(
         }
     }
 
-    private suspend fun processScreenEvents(screenFrame: Bitmap) {
+    /**
+     * Process the screen events on the provided frame.
+     *
+     * @param screenFrame the bitmap containing the current screen display.
+     * @return true if the frame has been processed, false if its detection has been cancelled.
+     */
+    private suspend fun processScreenEvents(screenFrame: Bitmap): Boolean {
         // Set the current screen image
         imageDetector.setScreenBitmap(screenFrame, processingTag)
 
@@ -171,6 +177,9 @@ internal class ScenarioProcessor(
                     conditions = screenEvent.conditions,
                 )
 
+                // Detection was cancelled during this frame, its results are not relevant
+                if (imageDetector.isDetectionCancelled()) return false
+
                 progressListener?.onEventProcessingCompleted(screenEvent, results.fulfilled == true, results.getAllScreenConditionsResults())
                 if (results.fulfilled == true) {
                     actionExecutor.executeActions(screenEvent, results)
@@ -187,5 +196,7 @@ internal class ScenarioProcessor(
             // We are done processing this frame, release it
             imageDetector.releaseScreenBitmap(screenFrame)
         }
+
+        return true
     }
 }
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.processing.tests
+
+import android.content.Context
+import android.content.Intent
+import android.content.res.Configuration
+import android.graphics.Point
+import android.os.Build
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import com.buzbuz.smartautoclicker.code.smart.detectionmodels.text.OCRModelsRepository
+import com.buzbuz.smartautoclicker.core.base.data.AppComponentsProvider
+import com.buzbuz.smartautoclicker.core.base.identifier.Identifier
+import com.buzbuz.smartautoclicker.core.bitmaps.BitmapRepository
+import com.buzbuz.smartautoclicker.core.common.actions.AndroidActionExecutor
+import com.buzbuz.smartautoclicker.core.detection.ImageDetector
+import com.buzbuz.smartautoclicker.core.display.config.DisplayConfig
+import com.buzbuz.smartautoclicker.core.display.config.DisplayConfigManager
+import com.buzbuz.smartautoclicker.core.display.recorder.DisplayRecorder
+import com.buzbuz.smartautoclicker.core.domain.model.scenario.Scenario
+import com.buzbuz.smartautoclicker.core.processing.data.DetectorEngine
+import com.buzbuz.smartautoclicker.core.processing.data.DetectorState
+import com.buzbuz.smartautoclicker.core.processing.data.scaling.ScalingManager
+import com.buzbuz.smartautoclicker.core.processing.domain.SmartProcessingListener
+import com.buzbuz.smartautoclicker.core.settings.domain.SettingsRepository
+
+import io.mockk.MockKAnnotations
+import io.mockk.clearAllMocks
+import io.mockk.coEvery
+import io.mockk.every
+import io.mockk.impl.annotations.RelaxedMockK
+import io.mockk.verify
+import io.mockk.verifyOrder
+
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.test.StandardTestDispatcher
+import kotlinx.coroutines.test.TestScope
+import kotlinx.coroutines.test.advanceTimeBy
+import kotlinx.coroutines.test.runTest
+
+import org.junit.After
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.robolectric.annotation.Config
+
+/**
+ * Tests verifying that the [DetectorEngine] cancels the native detection of the current frame when it is no longer
+ * relevant, and allows the detections again once the processing loop restarts.
+ *
+ * The cancellation must be requested synchronously from the caller thread: the processing scope is busy with the
+ * current frame and would only handle a launched request once the frame detection is over.
+ */
+@OptIn(ExperimentalCoroutinesApi::class)
+@RunWith(AndroidJUnit4::class)
+@Config(sdk = [Build.VERSION_CODES.Q])
+class DetectorEngineCancellationTests {
+
+    private companion object {
+        private val TEST_DISPLAY_SIZE = Point(1080, 1920)
+        // Must match the private constants in DetectorEngine.
+        private const val ORIENTATION_DEBOUNCE_MS = 100L
+        private const val NO_IMAGE_DELAY_MS = 20L
+        private const val ADVANCE_MS = ORIENTATION_DEBOUNCE_MS + NO_IMAGE_DELAY_MS + 20L
+
+        private val TEST_SCENARIO = Scenario(
+            id = Identifier(databaseId = 1L),
+            name = "Test Scenario",
+            detectionQuality = 600,
+        )
+    }
+
+    @RelaxedMockK private lateinit var mockDisplayConfigManager: DisplayConfigManager
+    @RelaxedMockK private lateinit var mockBitmapRepository: BitmapRepository
+    @RelaxedMockK private lateinit var mockScalingManager: ScalingManager
+    @RelaxedMockK private lateinit var mockDisplayRecorder: DisplayRecorder
+    @RelaxedMockK private lateinit var mockActionExecutor: AndroidActionExecutor
+    @RelaxedMockK private lateinit var mockSettingsRepository: SettingsRepository
+    @RelaxedMockK private lateinit var mockAppComponentsProvider: AppComponentsProvider
+    @RelaxedMockK private lateinit var mockDebuggingListener: SmartProcessingListener
+    @RelaxedMockK private lateinit var mockOcrModelsRepository: OCRModelsRepository
+    @RelaxedMockK private lateinit var mockImageDetector: ImageDetector
+    @RelaxedMockK private lateinit var mockContext: Context
+    @RelaxedMockK private lateinit var mockIntent: Intent
+
+    @Before
+    fun setUp() {
+        MockKAnnotations.init(this)
+
+        every { mockDisplayConfigManager.displayConfig } returns DisplayConfig(
+            sizePx = TEST_DISPLAY_SIZE,
+            orientation = Configuration.ORIENTATION_PORTRAIT,
+            safeInsetTopPx = 0,
+            roundedCorners = emptyMap(),
+        )
+        every { mockScalingManager.startScaling(any(), any()) } returns TEST_DISPLAY_SIZE
+        every { mockScalingManager.refreshScaling() } returns TEST_DISPLAY_SIZE
+        coEvery { mockDisplayRecorder.validateScreenCapture() } returns true
+        every { mockSettingsRepository.isInputBlockWorkaroundEnabled() } returns false
+        every { mockAppComponentsProvider.originalAppId } returns "test.app"
+        // Keep the processing loop in the lightweight null-delay branch.
+        coEvery { mockDisplayRecorder.acquireLatestBitmap() } returns null
+    }
+
+    @After
+    fun tearDown() {
+        clearAllMocks()
+    }
+
+    @Test
+    fun `detection start allows the detections`() = runTest {
+        val (engine, _) = startDetectionAndCaptureOrientationListener()
+
+        verify(exactly = 1) { mockImageDetector.resetCancellation() }
+        verify(exactly = 0) { mockImageDetector.cancelDetection() }
+
+        stopDetection(engine)
+    }
+
+    @Test
+    fun `stop detection cancels the current detection without waiting for the processing scope`() = runTest {
+        val (engine, _) = startDetectionAndCaptureOrientationListener()
+
+        engine.stopDetection()
+        // Nothing has been run on the processing scope yet.
+        verify(exactly = 1) { mockImageDetector.cancelDetection() }
+        verify(exactly = 0) { mockImageDetector.close() }
+
+        advanceTimeBy(1)
+        verifyOrder {
+            mockImageDetector.cancelDetection()
+            mockImageDetector.close()
+        }
+    }
+
+    @Test
+    fun `orientation change during detecting cancels the current detection before the debounce`() = runTest {
+        val (engine, orientationListener) = startDetectionAndCaptureOrientationListener()
+
+        orientationListener(mockContext)
+        verify(exactly = 1) { mockImageDetector.cancelDetection() }
+        verify(exactly = 0) { mockScalingManager.refreshScaling() }
+
+        stopDetection(engine)
+    }
+
+    @Test
+    fun `detection restarted after an orientation change allows the detections again`() = runTest {
+        val (engine, orientationListener) = startDetectionAndCaptureOrientationListener()
+
+        orientationListener(mockContext)
+        advanceTimeBy(ADVANCE_MS)
+
+        verifyOrder {
+            mockImageDetector.resetCancellation()
+            mockImageDetector.cancelDetection()
+            mockScalingManager.refreshScaling()
+            mockImageDetector.resetCancellation()
+        }
+
+        stopDetection(engine)
+    }
+
+    private fun TestScope.startDetectionAndCaptureOrientationListener(): Pair<DetectorEngine, (Context) -> Unit> {
+        val engine = DetectorEngine(
+            ioDispatcher = StandardTestDispatcher(testScheduler),
+            displayConfigManager = mockDisplayConfigManager,
+            bitmapRepository = mockBitmapRepository,
+            scalingManager = mockScalingManager,
+            displayRecorder = mockDisplayRecorder,
+            actionExecutor = mockActionExecutor,
+            settingsRepository = mockSettingsRepository,
+            appComponentsProvider = mockAppComponentsProvider,
+            debuggingListener = mockDebuggingListener,
+            ocrModelsRepository = mockOcrModelsRepository,
+        )
+
+        var capturedListener: ((Context) -> Unit)? = null
+        every { mockDisplayConfigManager.addOrientationListener(any()) } answers {
+            capturedListener = firstArg()
+        }
+
+        engine.startScreenRecord(0, mockIntent, null)
+        advanceTimeBy(1)
+
+        engine.startDetection(
+            context = mockContext,
+            scenario = TEST_SCENARIO,
+            screenEvents = emptyList(),
+            triggerEvents = emptyList(),
+            counters = emptyList(),
+            liveDebugging = false,
+            generateReport = false,
+            imageDetectorFactory = { mockImageDetector },
+        )
+        advanceTimeBy(1)
+
+        check(engine.state.value == DetectorState.DETECTING) {
+            "Expected DETECTING after startDetection, got ${engine.state.value}"
+        }
+
+        return engine to checkNotNull(capturedListener) { "Orientation listener was not registered" }
+    }
+
+    /** Stops the infinite processing loop before the runTest cleanup. */
+    private fun TestScope.stopDetection(engine: DetectorEngine) {
+        engine.stopDetection()
+        advanceTimeBy(1)
+    }
+}
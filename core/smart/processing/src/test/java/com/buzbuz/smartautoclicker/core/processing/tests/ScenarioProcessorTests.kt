@@ -40,6 +40,7 @@ import com.buzbuz.smartautoclicker.core.domain.model.event.TriggerEvent
 import com.buzbuz.smartautoclicker.core.processing.data.processor.ScenarioProcessor
 import com.buzbuz.smartautoclicker.core.processing.data.scaling.ScreenConditionScalingInfo
 import com.buzbuz.smartautoclicker.core.processing.data.scaling.ScalingManager
+import com.buzbuz.smartautoclicker.core.processing.domain.EventType
 import com.buzbuz.smartautoclicker.core.processing.domain.SmartProcessingListener
 import com.buzbuz.smartautoclicker.core.processing.shadows.ShadowBitmapCreator
 import com.buzbuz.smartautoclicker.core.processing.utils.ProcessingData.newCondition
@@ -61,8 +62,10 @@ import org.junit.Test
 import org.junit.runner.RunWith
 import org.mockito.Mock
 import org.mockito.Mockito
+import org.mockito.Mockito.anyBoolean
 import org.mockito.Mockito.anyInt
 import org.mockito.Mockito.mock
+import org.mockito.Mockito.never
 import org.mockito.Mockito.verify
 import org.mockito.Mockito.verifyNoInteractions
 import org.mockito.MockitoAnnotations
@@ -1176,4 +1179,32 @@ class ScenarioProcessorTests {
         verify(mockImageDetector).setScreenBitmap(mockScreenBitmap, "")
         verifyNoInteractions(mockAndroidExecutor, mockEndListener)
     }
+
+    @Test
+    fun oneCondition_match_detectionCancelled() = runTest {
+        val condition = createTestCondition(
+            TEST_CONDITION_PATH_1,
+            TEST_CONDITION_AREA_1,
+            TEST_CONDITION_THRESHOLD_1,
+            EXACT,
+            isDetected = true,
+            shouldBeOnScreen = true,
+        )
+        val event = newEvent(
+            operator = AND,
+            conditions = listOf(condition),
+            actions = listOf(newDefaultClickAction()),
+        )
+        mockWhen(mockImageDetector.isDetectionCancelled()).thenReturn(true)
+
+        scenarioProcessor = createNewScenarioProcessor(listOf(event), emptyList())
+        scenarioProcessor.process(mockScreenBitmap)
+
+        verify(mockImageDetector).setScreenBitmap(mockScreenBitmap, "")
+        verify(mockImageDetector).releaseScreenBitmap(mockScreenBitmap)
+        verify(mockProgressListener).onEventsProcessingCancelled()
+        verify(mockProgressListener, never()).onEventProcessingCompleted(anyNotNull(), anyBoolean(), anyNotNull())
+        verify(mockProgressListener, never()).onEventsProcessingCompleted(EventType.Screen)
+        verifyNoInteractions(mockAndroidExecutor, mockEndListener)
+    }
 }
\ No newline at end of file
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026 Kevin Buzeau
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+package com.buzbuz.smartautoclicker.core.processing.tests.processor
+
+import android.graphics.Rect
+import android.os.Build
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+
+import com.buzbuz.smartautoclicker.code.smart.detectionmodels.text.domain.OCRAlphabet
+import com.buzbuz.smartautoclicker.core.base.identifier.Identifier
+import com.buzbuz.smartautoclicker.core.detection.DetectionResult
+import com.buzbuz.smartautoclicker.core.detection.ImageDetector
+import com.buzbuz.smartautoclicker.core.domain.model.AND
+import com.buzbuz.smartautoclicker.core.domain.model.OR
+import com.buzbuz.smartautoclicker.core.domain.model.condition.ScreenCondition
+import com.buzbuz.smartautoclicker.core.processing.data.processor.ConditionsResults
+import com.buzbuz.smartautoclicker.core.processing.data.processor.ConditionsVerifier
+import com.buzbuz.smartautoclicker.core.processing.data.processor.state.ProcessingState
+import com.buzbuz.smartautoclicker.core.processing.data.scaling.ScalingManager
+import com.buzbuz.smartautoclicker.core.processing.data.scaling.ScreenConditionScalingInfo
+import com.buzbuz.smartautoclicker.core.processing.utils.anyNotNull
+
+import kotlinx.coroutines.test.runTest
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.mockito.Mock
+import org.mockito.Mockito.anyInt
+import org.mockito.Mockito.anyLong
+import org.mockito.Mockito.anyString
+import org.mockito.Mockito.never
+import org.mockito.Mockito.times
+import org.mockito.Mockito.verify
+import org.mockito.MockitoAnnotations
+import org.mockito.kotlin.doAnswer
+import org.mockito.kotlin.eq
+import org.robolectric.annotation.Config
+import org.mockito.Mockito.`when` as mockWhen
+
+/** Test the grouping of the text conditions detection in the [ConditionsVerifier]. */
+@RunWith(AndroidJUnit4::class)
+@Config(sdk = [Build.VERSION_CODES.Q])
+class ConditionsVerifierTests {
+
+    private companion object {
+        private val TEST_AREA_1 = Rect(0, 0, 100, 50)
+        private val TEST_AREA_2 = Rect(0, 100, 100, 150)
+
+        private val TEST_DETECTION_OK = DetectionResult(isDetected = true)
+        private val TEST_DETECTION_KO = DetectionResult(isDetected = false)
+        private val TEST_DETECTION_NOT_READY = DetectionResult(isDetected = false, isNotReady = true)
+    }
+
+    @Mock private lateinit var mockImageDetector: ImageDetector
+    @Mock private lateinit var mockScalingManager: ScalingManager
+
+    /** The object under test. */
+    private lateinit var conditionsVerifier: ConditionsVerifier
+
+    /** Creates a new text condition and mocks its scaling. */
+    private fun createTextCondition(
+        id: Long,
+        text: String,
+        area: Rect = TEST_AREA_1,
+        alphabet: OCRAlphabet = OCRAlphabet.LATIN,
+        shouldBeDetected: Boolean = true,
+    ): ScreenCondition.Text {
+        val condition = ScreenCondition.Text(
+            id = Identifier(databaseId = id),
+            eventId = Identifier(databaseId = 1L),
+            name = "TOTO",
+            threshold = 0,
+            shouldBeDetected = shouldBeDetected,
+            priority = 0,
+            text = text,
+            detectionArea = area,
+            alphabet = alphabet,
+        )
+
+        mockWhen(mockScalingManager.getScreenConditionScalingInfo(condition))
+            .thenReturn(ScreenConditionScalingInfo.Text(condition, area))
+
+        return condition
+    }
+
+    private fun mockDetectTexts(texts: List<String>, vararg results: List<DetectionResult>) {
+        var stubbing = mockWhen(mockImageDetector.detectTexts(eq(texts), anyString(), anyNotNull(), anyNotNull(), anyLong()))
+        results.forEach { result -> stubbing = stubbing.thenReturn(result) }
+    }
+
+    private fun ConditionsResults.isDetected(conditionId: Long): Boolean {
+        val result = getScreenConditionResult(conditionId)
+        assertNotNull("No result for condition $conditionId", result)
+        return result!!.haveBeenDetected
+    }
+
+    @Before
+    fun setUp() {
+        MockitoAnnotations.openMocks(this)
+
+        mockWhen(mockScalingManager.scaleUpDetectionResult(anyNotNull()))
+            .doAnswer { invocation -> invocation.getArgument(0) }
+        mockWhen(mockImageDetector.detectText(anyString(), anyString(), anyNotNull(), anyInt(), anyLong()))
+            .thenReturn(TEST_DETECTION_OK)
+
+        conditionsVerifier = ConditionsVerifier(
+            state = ProcessingState(emptyList(), emptyList(), emptyList(), null),
+            imageDetector = mockImageDetector,
+            scalingManager = mockScalingManager,
+            bitmapSupplier = { _, _, _ -> null },
+        )
+    }
+
+    @Test
+    fun sameAreaAndAlphabet_singleDetection() = runTest {
+        val condition1 = createTextCondition(1L, "A")
+        val condition2 = createTextCondition(2L, "B")
+        mockDetectTexts(listOf("A", "B"), listOf(TEST_DETECTION_OK, TEST_DETECTION_OK))
+
+        val results = conditionsVerifier.verifyConditions(AND, listOf(condition1, condition2))
+
+        assertEquals(true, results.fulfilled)
+        verify(mockImageDetector, times(1)).detectTexts(
+            eq(listOf("A", "B")), eq(OCRAlphabet.LATIN.name), eq(TEST_AREA_1), eq(listOf(0, 0)), anyLong())
+        verify(mockImageDetector, never()).detectText(anyString(), anyString(), anyNotNull(), anyInt(), anyLong())
+    }
+
+    @Test
+    fun sameAreaAndAlphabet_resultsMappedToConditions() = runTest {
+        val condition1 = createTextCondition(1L, "A")
+        val condition2 = createTextCondition(2L, "B")
+        val condition3 = createTextCondition(3L, "C")
+        mockDetectTexts(listOf("A", "B", "C"), listOf(TEST_DETECTION_KO, TEST_DETECTION_OK, TEST_DETECTION_KO))
+
+        val results = conditionsVerifier.verifyConditions(OR, listOf(condition1, condition2, condition3))
+
+        assertEquals(true, results.fulfilled)
+        assertFalse(results.isDetected(1L))
+        assertTrue(results.isDetected(2L))
+        assertEquals(null, results.getScreenConditionResult(3L))
+    }
+
+    @Test
+    fun differentAreasAndAlphabets_separateGroups() = runTest {
+        val condition1 = createTextCondition(1L, "A")
+        val condition2 = createTextCondition(2L, "B", alphabet = OCRAlphabet.KOREAN)
+        val condition3 = createTextCondition(3L, "C", area = TEST_AREA_2)
+        val condition4 = createTextCondition(4L, "D")
+        mockDetectTexts(listOf("A", "D"), listOf(TEST_DETECTION_OK, TEST_DETECTION_KO))
+
+        val results = conditionsVerifier.verifyConditions(AND, listOf(condition1, condition2, condition3, condition4))
+
+        assertEquals(false, results.fulfilled)
+        assertTrue(results.isDetected(1L))
+        assertTrue(results.isDetected(2L))
+        assertTrue(results.isDetected(3L))
+        assertFalse(results.isDetected(4L))
+        verify(mockImageDetector).detectTexts(
+            eq(listOf("A", "D")), eq(OCRAlphabet.LATIN.name), eq(TEST_AREA_1), anyNotNull(), anyLong())
+        verify(mockImageDetector).detectText(eq("B"), eq(OCRAlphabet.KOREAN.name), eq(TEST_AREA_1), anyInt(), anyLong())
+        verify(mockImageDetector).detectText(eq("C"), eq(OCRAlphabet.LATIN.name), eq(TEST_AREA_2), anyInt(), anyLong())
+    }
+
+    @Test
+    fun orShortCircuit_pendingResultsNotReused() = runTest {
+        val condition1 = createTextCondition(1L, "A")
+        val condition2 = createTextCondition(2L, "B")
+        mockDetectTexts(
+            listOf("A", "B"),
+            listOf(TEST_DETECTION_OK, TEST_DETECTION_KO),
+            listOf(TEST_DETECTION_KO, TEST_DETECTION_OK),
+        )
+
+        // Condition 2 result is pending when condition 1 fulfills the OR
+        conditionsVerifier.verifyConditions(OR, listOf(condition1, condition2))
+        val results = conditionsVerifier.verifyConditions(OR, listOf(condition1, condition2))
+
+        assertEquals(true, results.fulfilled)
+        assertFalse(results.isDetected(1L))
+        assertTrue(results.isDetected(2L))
+        verify(mockImageDetector, times(2)).detectTexts(anyNotNull(), anyString(), anyNotNull(), anyNotNull(), anyLong())
+    }
+
+    @Test
+    fun andShortCircuit_pendingResultsNotReused() = runTest {
+        val condition1 = createTextCondition(1L, "A")
+        val condition2 = createTextCondition(2L, "B")
+        mockDetectTexts(
+            listOf("A", "B"),
+            listOf(TEST_DETECTION_KO, TEST_DETECTION_OK),
+            listOf(TEST_DETECTION_OK, TEST_DETECTION_KO),
+        )
+
+        // Condition 2 result is pending when condition 1 fails the AND
+        conditionsVerifier.verifyConditions(AND, listOf(condition1, condition2))
+        val results = conditionsVerifier.verifyConditions(AND, listOf(condition1, condition2))
+
+        assertEquals(false, results.fulfilled)
+        assertTrue(results.isDetected(1L))
+        assertFalse(results.isDetected(2L))
+        verify(mockImageDetector, times(2)).detectTexts(anyNotNull(), anyString(), anyNotNull(), anyNotNull(), anyLong())
+    }
+
+    @Test
+    fun absentText_modelsNotReady_notFulfilled() = runTest {
+        val condition = createTextCondition(1L, "A", shouldBeDetected = false)
+        mockWhen(mockImageDetector.detectText(anyString(), anyString(), anyNotNull(), anyInt(), anyLong()))
+            .thenReturn(TEST_DETECTION_NOT_READY)
+
+        val results = conditionsVerifier.verifyConditions(AND, listOf(condition))
+
+        assertEquals(false, results.fulfilled)
+        assertFalse(results.getScreenConditionResult(1L)!!.isFulfilled)
+    }
+
+    @Test
+    fun absentText_modelsNotReadyInGroup_notFulfilled() = runTest {
+        val condition1 = createTextCondition(1L, "A", shouldBeDetected = false)
+        val condition2 = createTextCondition(2L, "B", shouldBeDetected = false)
+        mockDetectTexts(listOf("A", "B"), listOf(TEST_DETECTION_NOT_READY, TEST_DETECTION_NOT_READY))
+
+        val results = conditionsVerifier.verifyConditions(OR, listOf(condition1, condition2))
+
+        assertEquals(false, results.fulfilled)
+        assertFalse(results.getScreenConditionResult(1L)!!.isFulfilled)
+        assertFalse(results.getScreenConditionResult(2L)!!.isFulfilled)
+    }
+}
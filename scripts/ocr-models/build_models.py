@@ -25,13 +25,15 @@ sys.path.append(os.path.join(os.path.dirname(__file__), "converters"))
 
 import download_models
 import paddle_to_ncnn
+import ncnn_to_bundle
+import ncnn_to_int8
 import dependency_checker
 
 # ----------------------------
 # Model Processor
 # ----------------------------
 
-def process_model(model, output_root, mode):
+def process_model(model, output_root, mode, bundle, int8_calibration):
     name = model["name"]
     mtype = model["type"]
     alphabet = model.get("alphabet", "all")
@@ -50,11 +52,27 @@ def process_model(model, output_root, mode):
     # This handles Paddle -> ONNX -> Simplify -> NCNN and moves files to model_dir
     paddle_to_ncnn.run_conversion(model_dir, mtype)
 
-    # 2. Cleanup: Remove original downloaded files, keep only NCNN and dictionary
+    # 2. Quantize: Create the int8 model, used when the int8 precision is requested at runtime
+    if int8_calibration:
+        print(f"\n>>> [STEP] Creating int8 model for {name}")
+        ncnn_to_int8.quantize_model(model_dir, mtype, os.path.join(int8_calibration, mtype))
+
+    # 3. Bundle: Pack the NCNN files and the dictionary into a single memory mappable file
+    if bundle:
+        print(f"\n>>> [STEP] Creating bundle for {name}")
+        ncnn_to_bundle.bundle_model(model_dir, mtype)
+        if int8_calibration:
+            ncnn_to_bundle.bundle_model(model_dir, mtype, ".int8")
+
+    # 4. Cleanup: Remove original downloaded files, keep only NCNN and dictionary, or the bundles
     print(f"\n>>> [STEP] Cleaning up original files in {model_dir}")
-    
-    ncnn_extensions = [".ncnn.param", ".ncnn.bin"]
-    allowed_files = ["dict.txt"]
+
+    if bundle:
+        ncnn_extensions = [".ncnn.bundle"]
+        allowed_files = []
+    else:
+        ncnn_extensions = [".ncnn.param", ".ncnn.bin"]
+        allowed_files = ["dict.txt"]
     final_files = []
 
     for f in os.listdir(model_dir):
@@ -70,7 +88,7 @@ def process_model(model, output_root, mode):
         elif os.path.isdir(file_path):
             shutil.rmtree(file_path)
 
-    # 3. Zip if in language_pack mode
+    # 5. Zip if in language_pack mode
     if mode == "language_pack" and mtype == "rec":
         print(f"\n>>> [STEP] Creating archive for {alphabet}")
         zip_path = os.path.join(output_root, "rec", f"{alphabet}.zip")
@@ -97,6 +115,17 @@ def main():
         default="all",
         help="Build mode: 'default' (detection + latin), 'language_pack' (all others), or 'all' (default)"
     )
+    parser.add_argument(
+        "--bundle",
+        action="store_true",
+        help="Pack each model into a single memory mappable .ncnn.bundle file instead of the separated files"
+    )
+    parser.add_argument(
+        "--int8-calibration",
+        default=None,
+        help="Also create int8 models, calibrated with the images of the 'det' and 'rec' subdirectories of this "
+             "directory (screenshots and text line crops). Requires the ncnn tools in PATH"
+    )
 
     args = parser.parse_args()
 
@@ -120,7 +149,7 @@ def main():
 
     # 3. Process each model
     for model in models:
-        process_model(model, output_root, args.mode)
+        process_model(model, output_root, args.mode, args.bundle, args.int8_calibration)
 
     print("\n\n[SUCCESS] All models downloaded and converted to NCNN.")
 
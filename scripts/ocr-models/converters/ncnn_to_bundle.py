@@ -0,0 +1,156 @@
+# Copyright (C) 2026 Kevin Buzeau
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import os
+import argparse
+import struct
+import sys
+
+# ----------------------------
+# Bundle format
+# ----------------------------
+
+# Must be kept in sync with core/smart/detection/src/main/cpp/detector/matching/text/model_bundle.hpp
+BUNDLE_MAGIC = b"KRMB"
+BUNDLE_VERSION = 1
+# magic, version, then offset and size of params, weights and dictionary
+BUNDLE_HEADER = struct.Struct("<4s7I")
+# ncnn references the weights in place and uses SIMD loads on them, the loader rejects unaligned sections
+SECTION_ALIGNMENT = 16
+
+
+def align(size):
+    """
+    Rounds a size up to the next section alignment.
+
+    :param size: The size to align, in bytes.
+    :return: The aligned size.
+    """
+    return (size + SECTION_ALIGNMENT - 1) // SECTION_ALIGNMENT * SECTION_ALIGNMENT
+
+
+# ----------------------------
+# Dictionary indexing
+# ----------------------------
+
+def index_dictionary(dict_path):
+    """
+    Builds the pre-indexed dictionary section, parsed like the native dictionary file loader:
+    one token per line, trailing '\\r' removed, and the CTC blank token at index 0.
+
+    :param dict_path: Path to the dict.txt file.
+    :return: The class count, the offsets table and the concatenated UTF-8 characters, as bytes.
+    """
+    with open(dict_path, "rb") as f:
+        lines = f.read().split(b"\n")
+
+    # A final line break doesn't start a new token
+    if lines and lines[-1] == b"":
+        lines.pop()
+
+    characters = bytearray()
+    offsets = [0, 0]  # index 0 = blank token for CTC, empty
+    for line in lines:
+        if line.endswith(b"\r"):
+            line = line[:-1]
+        characters += line
+        offsets.append(len(characters))
+
+    class_count = len(offsets) - 1
+    return struct.pack(f"<{len(offsets) + 1}I", class_count, *offsets) + bytes(characters)
+
+
+# ----------------------------
+# Bundle creation
+# ----------------------------
+
+def create_bundle(param_path, bin_path, dict_path, bundle_path):
+    """
+    Packs a NCNN model and its optional dictionary into a single bundle file.
+
+    :param param_path: Path to the .ncnn.param file.
+    :param bin_path: Path to the .ncnn.bin file.
+    :param dict_path: Path to the dictionary file, or None for the detection model.
+    :param bundle_path: Path of the bundle file to create.
+    """
+    with open(param_path, "rb") as f:
+        params = f.read() + b"\0"
+    with open(bin_path, "rb") as f:
+        weights = f.read()
+    dictionary = index_dictionary(dict_path) if dict_path else b""
+
+    params_offset = align(BUNDLE_HEADER.size)
+    weights_offset = align(params_offset + len(params))
+    dictionary_offset = align(weights_offset + len(weights))
+
+    header = BUNDLE_HEADER.pack(
+        BUNDLE_MAGIC, BUNDLE_VERSION,
+        params_offset, len(params),
+        weights_offset, len(weights),
+        dictionary_offset, len(dictionary),
+    )
+
+    with open(bundle_path, "wb") as f:
+        for offset, section in ((0, header), (params_offset, params), (weights_offset, weights),
+                                (dictionary_offset, dictionary)):
+            f.write(b"\0" * (offset - f.tell()))
+            f.write(section)
+
+    print(f"[SUCCESS] Bundle created: {bundle_path} ({os.path.getsize(bundle_path)} bytes)")
+
+
+def bundle_model(model_dir, model_type, variant=""):
+    """
+    Packs the NCNN model of a model folder into <model_type><variant>.ncnn.bundle, next to the separated files.
+
+    :param model_dir: The model folder, containing the NCNN files and the dictionary for recognition.
+    :param model_type: 'det' or 'rec'.
+    :param variant: Suffix of the model files name, like '.int8' for the quantized model.
+    :return: The path of the created bundle.
+    """
+    model_name = f"{model_type}{variant}"
+    param_path = os.path.join(model_dir, f"{model_name}.ncnn.param")
+    bin_path = os.path.join(model_dir, f"{model_name}.ncnn.bin")
+    dict_path = os.path.join(model_dir, "dict.txt") if model_type == "rec" else None
+
+    for path in (param_path, bin_path, dict_path):
+        if path and not os.path.isfile(path):
+            print(f"[ERROR] Missing model file {path}")
+            sys.exit(1)
+
+    bundle_path = os.path.join(model_dir, f"{model_name}.ncnn.bundle")
+    create_bundle(param_path, bin_path, dict_path, bundle_path)
+    return bundle_path
+
+
+# ----------------------------
+# MAIN
+# ----------------------------
+
+def main():
+    """
+    Main entry point for the NCNN bundle packer script.
+    """
+    parser = argparse.ArgumentParser(description="Pack a NCNN OCR model folder into a single memory mappable bundle.")
+    parser.add_argument("--input", required=True, help="Path to the NCNN model folder")
+    parser.add_argument("--type", required=True, choices=["det", "rec"], help="Model type: 'det' or 'rec'")
+    parser.add_argument("--variant", default="", help="Suffix of the model files name, like '.int8'")
+
+    args = parser.parse_args()
+
+    bundle_model(args.input, args.type, args.variant)
+
+if __name__ == "__main__":
+    main()
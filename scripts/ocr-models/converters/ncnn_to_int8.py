@@ -0,0 +1,176 @@
+# Copyright (C) 2026 Kevin Buzeau
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Quantizes a NCNN OCR model to int8 with a calibration table.
+The fp16 model is first converted back to fp32, as required by the ncnn quantization tools:
+ncnnoptimize (fp32) -> ncnn2table (calibration) -> ncnn2int8.
+
+The quantized model is written next to the original one, as <type>.int8.ncnn.param/bin, where the
+detector looks for it when the int8 precision is requested.
+"""
+
+import os
+import argparse
+import shutil
+import subprocess
+import sys
+
+# ----------------------------
+# Calibration settings
+# ----------------------------
+
+# Must match the normalization of the native network input builder (PP-OCR, RGB)
+MEAN_VALUES = "[127.5,127.5,127.5]"
+NORM_VALUES = "[0.007843,0.007843,0.007843]"
+
+# Calibration input size (w,h,c): a detection tile, or the fixed recognition input
+CALIBRATION_SHAPES = {
+    "det": "[640,640,3]",
+    "rec": "[320,48,3]",
+}
+
+CALIBRATION_IMAGE_EXTENSIONS = (".png", ".jpg", ".jpeg", ".bmp")
+NCNN_TOOLS = ("ncnnoptimize", "ncnn2table", "ncnn2int8")
+
+
+# ----------------------------
+# Run command helper
+# ----------------------------
+
+def run(cmd):
+    """
+    Executes a shell command and captures its output.
+
+    :param cmd: List of command arguments.
+    """
+    print("\n[CMD]", " ".join(cmd))
+
+    result = subprocess.run(
+        cmd,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        text=True,
+        encoding="utf-8",
+        errors="replace"
+    )
+
+    print(result.stdout)
+
+    if result.returncode != 0:
+        print("[ERROR]", result.stderr)
+        sys.exit(1)
+
+
+# ----------------------------
+# Quantization
+# ----------------------------
+
+def write_image_list(calibration_dir, list_path):
+    """
+    Lists the calibration images for ncnn2table.
+
+    :param calibration_dir: Directory containing the calibration images. Recognition calibration should use text
+    line crops, detection calibration full screenshots.
+    :param list_path: Path of the image list file to write.
+    """
+    images = sorted(
+        os.path.join(calibration_dir, f) for f in os.listdir(calibration_dir)
+        if f.lower().endswith(CALIBRATION_IMAGE_EXTENSIONS)
+    )
+    if not images:
+        print(f"[ERROR] No calibration image found in {calibration_dir}")
+        sys.exit(1)
+
+    with open(list_path, "w", encoding="utf-8") as f:
+        f.write("\n".join(images) + "\n")
+
+    print(f"Calibration images: {len(images)}")
+
+
+def quantize_model(model_dir, model_type, calibration_dir):
+    """
+    Creates the int8 version of the NCNN model of a model folder.
+
+    :param model_dir: The model folder, containing <model_type>.ncnn.param/bin.
+    :param model_type: 'det' or 'rec'.
+    :param calibration_dir: Directory containing the calibration images.
+    """
+    for tool in NCNN_TOOLS:
+        if shutil.which(tool) is None:
+            print(f"[ERROR] {tool} not found in PATH, it is built with the ncnn tools")
+            sys.exit(1)
+
+    param_path = os.path.join(model_dir, f"{model_type}.ncnn.param")
+    bin_path = os.path.join(model_dir, f"{model_type}.ncnn.bin")
+    if not os.path.isfile(param_path) or not os.path.isfile(bin_path):
+        print(f"[ERROR] Missing NCNN model in {model_dir}")
+        sys.exit(1)
+
+    temp_dir = os.path.join(model_dir, "temp_int8")
+    if os.path.exists(temp_dir):
+        shutil.rmtree(temp_dir)
+    os.makedirs(temp_dir)
+
+    try:
+        fp32_param = os.path.join(temp_dir, "fp32.ncnn.param")
+        fp32_bin = os.path.join(temp_dir, "fp32.ncnn.bin")
+        image_list = os.path.join(temp_dir, "images.txt")
+        table_path = os.path.join(temp_dir, f"{model_type}.table")
+
+        print("\n--- [1/3] Converting to fp32 ---")
+        run(["ncnnoptimize", param_path, bin_path, fp32_param, fp32_bin, "0"])
+
+        print("\n--- [2/3] Computing the calibration table ---")
+        write_image_list(calibration_dir, image_list)
+        run([
+            "ncnn2table", fp32_param, fp32_bin, image_list, table_path,
+            f"mean={MEAN_VALUES}", f"norm={NORM_VALUES}", f"shape={CALIBRATION_SHAPES[model_type]}",
+            "pixel=RGB", "method=kl",
+        ])
+
+        print("\n--- [3/3] Quantizing ---")
+        int8_param = os.path.join(model_dir, f"{model_type}.int8.ncnn.param")
+        int8_bin = os.path.join(model_dir, f"{model_type}.int8.ncnn.bin")
+        run(["ncnn2int8", fp32_param, fp32_bin, int8_param, int8_bin, table_path])
+
+        print(f"[SUCCESS] Int8 model created in {model_dir}:")
+        print(f"  - {os.path.basename(int8_param)}")
+        print(f"  - {os.path.basename(int8_bin)}")
+
+    finally:
+        if os.path.exists(temp_dir):
+            shutil.rmtree(temp_dir)
+
+
+# ----------------------------
+# MAIN
+# ----------------------------
+
+def main():
+    """
+    Main entry point for the NCNN int8 quantization script.
+    """
+    parser = argparse.ArgumentParser(description="Quantize a NCNN OCR model to int8.")
+    parser.add_argument("--input", required=True, help="Path to the NCNN model folder")
+    parser.add_argument("--type", required=True, choices=["det", "rec"], help="Model type: 'det' or 'rec'")
+    parser.add_argument("--calibration", required=True, help="Directory containing the calibration images")
+
+    args = parser.parse_args()
+
+    quantize_model(args.input, args.type, args.calibration)
+
+if __name__ == "__main__":
+    main()
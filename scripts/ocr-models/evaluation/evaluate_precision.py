@@ -0,0 +1,335 @@
+# Copyright (C) 2026 Kevin Buzeau
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+"""
+Offline accuracy check of the reduced precision inference modes of the recognition models.
+
+Each recognition model is evaluated against a labelled corpus of text line crops, with the same preprocessing
+and CTC decoding than the native detector, in fp32, fp16 and int8 (if the quantized model exists). The recall
+(exact line matches) and the character error rate are reported for each precision, with their delta against fp32.
+
+The corpus uses the PaddleOCR recognition label format, one directory per alphabet, named like the model:
+    <corpus>/<MODEL_ID>/labels.txt   ->   "<image path relative to labels.txt>\t<expected text>" per line
+
+Usage:
+    python evaluate_precision.py --models <models dir> --corpus <corpus dir> [--report report.md]
+"""
+
+import os
+import argparse
+import sys
+import time
+
+import cv2
+import ncnn
+import numpy as np
+
+# ----------------------------
+# Model settings, must match the native recognizer
+# ----------------------------
+
+INPUT_HEIGHT = 48
+INPUT_WIDTH = 320
+MEAN_VALUES = (127.5, 127.5, 127.5)
+NORM_VALUES = (1.0 / 127.5, 1.0 / 127.5, 1.0 / 127.5)
+RTL_MODELS = ("ARABIC",)
+
+PRECISIONS = ("FP32", "FP16", "INT8")
+
+
+# ----------------------------
+# Model loading
+# ----------------------------
+
+def get_model_files(model_dir, precision):
+    """
+    Get the NCNN files of a recognition model for a precision.
+
+    :param model_dir: The recognition model folder.
+    :param precision: One of PRECISIONS.
+    :return: The param and bin paths, or None if the model doesn't exist for this precision.
+    """
+    name = "rec.int8" if precision == "INT8" else "rec"
+    param_path = os.path.join(model_dir, f"{name}.ncnn.param")
+    bin_path = os.path.join(model_dir, f"{name}.ncnn.bin")
+    if not os.path.isfile(param_path) or not os.path.isfile(bin_path):
+        return None
+
+    return param_path, bin_path
+
+
+def load_net(param_path, bin_path, precision):
+    """
+    Load a NCNN network with the same options than the native detector for a precision.
+
+    :param param_path: Path of the .ncnn.param file.
+    :param bin_path: Path of the .ncnn.bin file.
+    :param precision: One of PRECISIONS.
+    :return: The loaded network.
+    """
+    reduced = precision != "FP32"
+
+    net = ncnn.Net()
+    net.opt.use_vulkan_compute = False
+    net.opt.num_threads = 1
+    net.opt.use_fp16_packed = reduced
+    net.opt.use_fp16_storage = reduced
+    net.opt.use_fp16_arithmetic = reduced
+    net.opt.use_bf16_storage = False
+    net.opt.use_int8_inference = precision == "INT8"
+
+    if net.load_param(param_path) != 0 or net.load_model(bin_path) != 0:
+        print(f"[ERROR] Can't load model {param_path}")
+        sys.exit(1)
+
+    return net
+
+
+def load_dictionary(model_dir):
+    """
+    Load the dictionary of a recognition model.
+
+    :param model_dir: The recognition model folder.
+    :return: The list of tokens, index 0 being the CTC blank token.
+    """
+    with open(os.path.join(model_dir, "dict.txt"), "r", encoding="utf-8") as f:
+        return [""] + [line.rstrip("\r\n") for line in f]
+
+
+def load_corpus(corpus_dir):
+    """
+    Load a labelled corpus of text line crops.
+
+    :param corpus_dir: The folder containing labels.txt.
+    :return: The list of (image path, expected text).
+    """
+    labels_path = os.path.join(corpus_dir, "labels.txt")
+    samples = []
+    with open(labels_path, "r", encoding="utf-8") as f:
+        for line in f:
+            line = line.rstrip("\r\n")
+            if not line:
+                continue
+
+            image, _, label = line.partition("\t")
+            samples.append((os.path.join(corpus_dir, image), label))
+
+    return samples
+
+
+# ----------------------------
+# Inference
+# ----------------------------
+
+def preprocess(image, is_rtl):
+    """
+    Build the recognition input from a BGR text line crop, like TextRecognizer::preprocess.
+
+    :param image: The BGR text line crop.
+    :param is_rtl: True if the text is right to left, the line is then aligned on the right of the input.
+    :return: The network input, as a 3x48x320 float array.
+    """
+    scale = INPUT_HEIGHT / image.shape[0]
+    width = min(max(1, int(image.shape[1] * scale)), INPUT_WIDTH)
+    resized = cv2.cvtColor(cv2.resize(image, (width, INPUT_HEIGHT)), cv2.COLOR_BGR2RGB).astype(np.float32)
+
+    normalized = (resized - np.array(MEAN_VALUES, dtype=np.float32)) * np.array(NORM_VALUES, dtype=np.float32)
+    data = np.zeros((INPUT_HEIGHT, INPUT_WIDTH, 3), dtype=np.float32)
+    x_offset = INPUT_WIDTH - width if is_rtl else 0
+    data[:, x_offset:x_offset + width] = normalized
+
+    return np.ascontiguousarray(data.transpose(2, 0, 1))
+
+
+def decode(output, dictionary, is_rtl):
+    """
+    CTC greedy decoding of the network output, like TextRecognizer::decode.
+
+    :param output: The network output, one row of class scores per time step.
+    :param dictionary: The tokens of the model, index 0 being the blank token.
+    :param is_rtl: True if the text is right to left.
+    :return: The decoded text.
+    """
+    tokens = []
+    previous = 0
+    for index in np.argmax(output, axis=1):
+        if index == 0:
+            previous = 0
+            continue
+        if index == previous:
+            continue
+
+        previous = index
+        if index < len(dictionary):
+            tokens.append(dictionary[index])
+
+    if is_rtl:
+        tokens.reverse()
+
+    return "".join(tokens)
+
+
+def recognize(net, input_data, dictionary, is_rtl):
+    """
+    Run the recognition of a preprocessed text line.
+
+    :return: The decoded text and the inference duration, in milliseconds.
+    """
+    start = time.perf_counter()
+    with net.create_extractor() as extractor:
+        extractor.input("in0", ncnn.Mat(input_data))
+        _, output = extractor.extract("out0")
+    duration = (time.perf_counter() - start) * 1000
+
+    return decode(np.array(output), dictionary, is_rtl), duration
+
+
+# ----------------------------
+# Metrics
+# ----------------------------
+
+def edit_distance(a, b):
+    """
+    Levenshtein distance between two strings.
+    """
+    previous = list(range(len(b) + 1))
+    for i, ca in enumerate(a, 1):
+        current = [i]
+        for j, cb in enumerate(b, 1):
+            current.append(min(previous[j] + 1, current[j - 1] + 1, previous[j - 1] + (ca != cb)))
+        previous = current
+
+    return previous[-1]
+
+
+def evaluate(model_dir, model_id, samples, precision):
+    """
+    Evaluate a recognition model in a precision against a labelled corpus.
+
+    :return: A dict with the recall, the character error rate and the mean latency, or None if the model doesn't
+    exist for this precision.
+    """
+    files = get_model_files(model_dir, precision)
+    if files is None:
+        return None
+
+    net = load_net(files[0], files[1], precision)
+    dictionary = load_dictionary(model_dir)
+    is_rtl = model_id in RTL_MODELS
+
+    matches = 0
+    errors = 0
+    characters = 0
+    total_duration = 0.0
+    for image_path, label in samples:
+        image = cv2.imread(image_path, cv2.IMREAD_COLOR)
+        if image is None:
+            print(f"[ERROR] Can't read image {image_path}")
+            sys.exit(1)
+
+        text, duration = recognize(net, preprocess(image, is_rtl), dictionary, is_rtl)
+        matches += text == label
+        errors += edit_distance(text, label)
+        characters += len(label)
+        total_duration += duration
+
+    net.clear()
+    return {
+        "recall": matches / len(samples),
+        "cer": errors / max(1, characters),
+        "latency": total_duration / len(samples),
+    }
+
+
+# ----------------------------
+# Report
+# ----------------------------
+
+def format_report(results):
+    """
+    Format the evaluation results as a markdown table, with the deltas against fp32.
+
+    :param results: The results per model id, then per precision.
+    :return: The markdown report.
+    """
+    lines = [
+        "| Alphabet | Samples | Precision | Recall | Recall delta | CER | CER delta | Latency (ms) |",
+        "|---|---|---|---|---|---|---|---|",
+    ]
+    for model_id, (sample_count, model_results) in sorted(results.items()):
+        reference = model_results["FP32"]
+        for precision in PRECISIONS:
+            result = model_results.get(precision)
+            if result is None:
+                continue
+
+            lines.append(
+                f"| {model_id} | {sample_count} | {precision} "
+                f"| {result['recall']:.2%} | {result['recall'] - reference['recall']:+.2%} "
+                f"| {result['cer']:.2%} | {result['cer'] - reference['cer']:+.2%} "
+                f"| {result['latency']:.1f} |"
+            )
+
+    return "\n".join(lines) + "\n"
+
+
+# ----------------------------
+# MAIN
+# ----------------------------
+
+def main():
+    """
+    Main entry point for the precision evaluation script.
+    """
+    parser = argparse.ArgumentParser(description="Evaluate the accuracy of the OCR models in reduced precision.")
+    parser.add_argument("--models", required=True, help="Directory containing one folder per recognition model")
+    parser.add_argument("--corpus", required=True, help="Directory containing one labelled folder per model")
+    parser.add_argument("--report", default=None, help="Path of the markdown report to write")
+
+    args = parser.parse_args()
+
+    results = {}
+    for model_id in sorted(os.listdir(args.corpus)):
+        model_dir = os.path.join(args.models, model_id)
+        if get_model_files(model_dir, "FP32") is None:
+            print(f"[WARNING] No recognition model for corpus {model_id}, skipping")
+            continue
+
+        samples = load_corpus(os.path.join(args.corpus, model_id))
+        if not samples:
+            continue
+
+        print(f"\n>>> [STEP] Evaluating {model_id} on {len(samples)} samples")
+        model_results = {}
+        for precision in PRECISIONS:
+            result = evaluate(model_dir, model_id, samples, precision)
+            if result is not None:
+                model_results[precision] = result
+
+        results[model_id] = (len(samples), model_results)
+
+    if not results:
+        print("[ERROR] Nothing to evaluate")
+        sys.exit(1)
+
+    report = format_report(results)
+    print("\n" + report)
+    if args.report:
+        with open(args.report, "w", encoding="utf-8") as f:
+            f.write(report)
+        print(f"[SUCCESS] Report written to {args.report}")
+
+if __name__ == "__main__":
+    main()